@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "worldgen/TaskPool.hpp"
+
+/**
+ * @class AssetLoader
+ * @brief Carregamento assíncrono em duas etapas: o trabalho de CPU (ler arquivos, decodificar,
+ * gerar terreno e instâncias) roda num pool de threads, e cada tarefa devolve um "envio"
+ * que é executado depois, na thread principal, onde o contexto OpenGL está ativo.
+ *
+ * A thread principal chama processUploads() uma vez por frame, com um orçamento de tempo,
+ * de modo que a janela continua respondendo enquanto a cena é montada aos poucos.
+ */
+class AssetLoader
+{
+public:
+    // Etapa executada na thread principal (pode usar OpenGL).
+    using Upload = std::function<void()>;
+
+    // threadCount = 0 usa o número de núcleos disponíveis.
+    explicit AssetLoader(unsigned int threadCount = 0);
+
+    /**
+     * @brief Executa 'work' numa thread do pool; o Upload que ela devolve entra na fila da thread principal.
+     * Pode ser chamada de dentro de outra tarefa. Se 'work' lançar uma exceção, ela é relançada
+     * na thread principal, por processUploads().
+     */
+    void submit(std::function<Upload()> work);
+
+    /**
+     * @brief Executa os envios prontos até a fila esvaziar ou o orçamento de tempo acabar
+     * (ao menos um envio é sempre executado, se houver). Deve ser chamada na thread principal.
+     * @return O número de envios executados.
+     */
+    size_t processUploads(double budgetMs);
+
+    // Verdadeiro quando não há tarefas em execução nem envios pendentes.
+    bool isIdle() const { return m_pending == 0; }
+
+private:
+    std::mutex m_mutex;
+    std::deque<Upload> m_uploads;
+    std::atomic<int> m_pending{0}; // Tarefas submetidas cujo envio ainda não foi executado.
+
+    // Declarado por último para ser destruído primeiro: as threads terminam antes da fila ser liberada.
+    worldgen::TaskPool m_pool;
+};
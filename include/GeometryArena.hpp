@@ -0,0 +1,127 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include "worldgen/Placement.hpp"
+#include "worldgen/RangeAllocator.hpp"
+
+// Formato dos vértices enviados à GPU. Cada formato tem o seu par de buffers na GeometryArena.
+enum class VertexFormat
+{
+    Float,   // struct Vertex: posição, normal e UV em float, 32 bytes por vértice.
+    Packed,  // worldgen::PackedVertex: 16 bytes; o vertex shader reconstrói a posição.
+    Position // Apenas a posição (vec3), 12 bytes: água e sol.
+};
+
+// Comando de glMultiDrawElementsIndirect, no layout que a GPU lê do GL_DRAW_INDIRECT_BUFFER.
+struct DrawElementsIndirectCommand
+{
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+/**
+ * @struct MeshRange
+ * @brief Localização de uma malha dentro da GeometryArena.
+ * Os índices da malha continuam locais (começando em 0); 'baseVertex' é somado pela GPU no desenho.
+ */
+struct MeshRange
+{
+    VertexFormat format = VertexFormat::Float;
+    uint32_t baseVertex = 0;  // Primeiro vértice da malha no VBO do formato.
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;  // Primeiro índice da malha no EBO do formato.
+    uint32_t indexCount = 0;
+};
+
+/**
+ * @class GeometryArena
+ * @brief Buffers de vértices e índices compartilhados por todas as malhas da cena.
+ *
+ * Para cada formato de vértice há um único VBO, um único EBO e dois VAOs (um para desenho simples
+ * e um com os dados de instância: a matriz nos atributos 3-6 e a camada da textura array no 7). Cada malha recebe um MeshRange, subalocado
+ * com worldgen::RangeAllocator; os buffers crescem (com cópia na GPU) quando o espaço acaba.
+ * Desenhar malhas do mesmo formato em sequência não troca de VAO nem de buffers, o que também é
+ * o pré-requisito para agrupar várias malhas numa única chamada multi-draw.
+ *
+ * Todos os VAOs da cena são vinculados por aqui (bind, bindInstanced ou bindVertexArray): a arena
+ * lembra o último VAO vinculado e evita vínculos repetidos.
+ * Deve ser criada depois do contexto OpenGL e destruída depois de todas as malhas que alocou.
+ */
+class GeometryArena
+{
+public:
+    GeometryArena();
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena &) = delete;
+    GeometryArena &operator=(const GeometryArena &) = delete;
+
+    /**
+     * @brief Copia uma malha para os buffers do formato, aumentando-os se preciso.
+     * @param vertices Os vértices, já no layout de 'format'.
+     * @param indices Índices locais da malha (0 a vertexCount - 1).
+     */
+    MeshRange allocate(VertexFormat format, const void *vertices, uint32_t vertexCount, const unsigned int *indices, uint32_t indexCount);
+
+    // Devolve o espaço de uma malha; o intervalo fica vazio.
+    void free(MeshRange &range);
+
+    // Vincula o VAO do formato (apenas se ainda não estiver vinculado).
+    void bind(VertexFormat format);
+    // Vincula um VAO que não pertence à arena (ex: o de um modelo .glb), mantendo o registro do VAO atual.
+    void bindVertexArray(unsigned int vao);
+    // Vincula o VAO instanciado do formato e usa 'instanceVBO' (worldgen::InstanceData) como fonte dos atributos 3-6.
+    void bindInstanced(VertexFormat format, unsigned int instanceVBO);
+
+    /**
+     * @brief Desenha 'indexCount' índices da malha a partir de 'firstIndex' (relativo ao início da malha).
+     * O VAO do formato da malha deve estar vinculado.
+     */
+    void draw(const MeshRange &range, uint32_t firstIndex, uint32_t indexCount, GLenum mode = GL_TRIANGLES) const;
+    // Desenha a malha inteira.
+    void draw(const MeshRange &range, GLenum mode = GL_TRIANGLES) const { draw(range, 0, range.indexCount, mode); }
+
+    // Versão instanciada de draw(); o VAO instanciado do formato deve estar vinculado.
+    void drawInstanced(const MeshRange &range, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0) const;
+
+    // Configura, no VAO vinculado, os dados de instância (atributos 3-6, um por instância) lidos do ponto de vínculo 'binding'.
+    static void setupInstanceAttributes(GLuint binding);
+
+    // Bytes por instância nos buffers de instância.
+    static const GLsizei INSTANCE_STRIDE = sizeof(worldgen::InstanceData);
+
+    // Bytes por vértice de cada formato.
+    static GLsizei vertexStride(VertexFormat format);
+
+    // Imprime a ocupação e a fragmentação dos buffers de cada formato.
+    void printStats() const;
+
+private:
+    static const int FORMAT_COUNT = 3;
+
+    struct Pool
+    {
+        GLsizei stride = 0;
+        unsigned int VAO = 0;
+        unsigned int instancedVAO = 0;
+        unsigned int VBO = 0;
+        unsigned int EBO = 0;
+        worldgen::RangeAllocator vertices;
+        worldgen::RangeAllocator indices;
+    };
+
+    // Configura os atributos do formato (e, se 'instanced', os das matrizes) no VAO vinculado.
+    static void setupAttributes(VertexFormat format, bool instanced);
+    // Reserva 'count' elementos, crescendo o buffer e o alocador se não houver espaço.
+    uint32_t allocateRange(Pool &pool, worldgen::RangeAllocator &allocator, unsigned int &buffer, size_t elementSize, uint32_t count);
+    // Aponta os dois VAOs do formato para os buffers atuais (após um crescimento).
+    void attachBuffers(Pool &pool);
+
+    Pool m_pools[FORMAT_COUNT];
+    unsigned int m_boundVAO = 0;
+};
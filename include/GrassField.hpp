@@ -2,27 +2,100 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
 #include <vector>
 #include "Shader.hpp"
-#include "Terrain.hpp"
+#include "AssetLoader.hpp"
+#include "InstanceCuller.hpp"
 #include "Model.hpp"
-#include "db_perlin.hpp" // <-- ADICIONE ESTA LINHA
+#include "ResourceManager.hpp"
+#include "TextureArray.hpp"
+#include "worldgen/Culling.hpp"
+#include "worldgen/GrassTiles.hpp"
+#include "worldgen/Heightfield.hpp"
 
+/**
+ * @class GrassField
+ * @brief Grama densa em ladrilhos em volta da câmera (ver worldgen::GrassStreamingParams).
+ *
+ * Os ladrilhos são gerados nas threads do AssetLoader e copiados para um pool de tamanho fixo:
+ * um único buffer de instâncias dividido em slots de tileCapacity instâncias cada. Quando a câmera
+ * anda, os ladrilhos que saíram dos anéis cedem os seus slots aos que entraram, e a memória
+ * não cresce com a área percorrida.
+ */
 class GrassField
 {
 public:
-    GrassField(Terrain &terrain, Shader &shader, const std::string &modelPath, const std::string &texturePath, float spacing=3.0f);
+    // A camada de cada instância escolhe uma das texturas de 'texturePaths'.
+    // Com 'cullShader' (shaders/cull_instances.comp), o culling é feito na GPU; sem ele, por ladrilho na CPU.
+    // 'loader' gera os ladrilhos e deve ser destruído antes da grama.
+    GrassField(Shader &shader, ResourceManager &resources, const std::string &modelPath, const std::vector<std::string> &texturePaths,
+               std::shared_ptr<const worldgen::Heightfield> heightfield, AssetLoader &loader, Shader *cullShader = nullptr);
     ~GrassField();
 
-    void Draw(const glm::mat4 &view, const glm::mat4 &projection);
+    GrassField(const GrassField &) = delete;
+    GrassField &operator=(const GrassField &) = delete;
+
+    // Pede os ladrilhos que faltam em volta da câmera, do mais próximo ao mais distante. Uma vez por frame.
+    void update(const glm::vec3 &cameraPos);
+
+    // Desenha apenas as instâncias visíveis no frustum da passada (e do lado certo do plano de corte),
+    // até 'maxDistance' da câmera: por instância na GPU, por ladrilho na CPU.
+    void Draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec4 &clipPlane = glm::vec4(0.0f), worldgen::CullStats *stats = nullptr,
+              float maxDistance = std::numeric_limits<float>::infinity());
 
 private:
+    // Um trecho do buffer do pool: livre, aguardando um ladrilho em geração, ou com um ladrilho pronto.
+    struct Slot
+    {
+        enum State
+        {
+            Free,
+            Loading,
+            Resident
+        };
+        State state = Free;
+        worldgen::GrassTileKey key;
+        uint32_t count = 0;
+        worldgen::Aabb bounds;
+    };
+
     void setupInstancing();
+    // Slot livre ou, se não houver, o de um ladrilho que não faz mais parte dos anéis; -1 se nenhum.
+    int acquireSlot() const;
+    // Copia o ladrilho gerado para o seu slot e libera o slot do ladrilho que ele substitui.
+    void uploadTile(size_t slot, const worldgen::GrassTile &tile);
+    // Passa ao culler da GPU só os tufos dos slots prontos (slots vizinhos viram um único intervalo).
+    void updateCullRanges();
+    bool isDesired(const worldgen::GrassTileKey &key) const;
+
+    // Os uniformes do programa da grama, resolvidos no construtor.
+    struct Uniforms
+    {
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<glm::mat4> view;
+        Uniform<glm::mat4> projection;
+        Uniform<int> textureDiffuse;
+        Model::PositionUniforms position;
+    };
 
-    Terrain &terrain;
     Shader &shader;
-    Model grassModel;
-    float spacing;
-    std::vector<glm::mat4> instanceMatrices;
-    unsigned int instanceVBO;
-};
\ No newline at end of file
+    Uniforms uniforms;
+    std::shared_ptr<Model> grassModel;
+    std::shared_ptr<TextureArray> grassTextures; // Uma camada por variante de grama.
+    std::shared_ptr<const worldgen::Heightfield> heightfield;
+    AssetLoader &loader;
+    worldgen::GrassStreamingParams params;
+
+    std::vector<Slot> slots;
+    std::vector<worldgen::GrassTileKey> desiredTiles; // Do mais próximo ao mais distante da câmera.
+    glm::ivec2 cameraTile = glm::ivec2(INT32_MIN);
+    int loadingTiles = 0;
+
+    unsigned int instanceVBO = 0; // slots.size() * tileCapacity instâncias.
+    std::unique_ptr<InstanceCuller> culler; // Nulo no culling pela CPU.
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include "GeometryArena.hpp"
+#include "Model.hpp"
+#include "Shader.hpp"
+#include "TextureArray.hpp"
+
+/**
+ * @class ImpostorAtlas
+ * @brief Impostor octaédrico de um modelo: o modelo renderizado, no carregamento, a partir de
+ * framesPerSide x framesPerSide direções do hemisfério superior (mapeamento hemi-octaédrico),
+ * cada uma num quadro do atlas.
+ *
+ * O atlas tem duas texturas array, com uma camada por variante da TextureArray do modelo: a cor (com
+ * alfa para o recorte) e a normal em unidades do modelo, para que o impostor seja iluminado pelo sol
+ * do momento como a malha. De longe, cada instância vira um único quad voltado para a câmera
+ * (shaders/impostor.vert), que mistura os quatro quadros mais próximos da direção de visão.
+ */
+class ImpostorAtlas
+{
+public:
+    /**
+     * @brief Renderiza os quadros do atlas (requer o contexto OpenGL; restaura o framebuffer e o viewport).
+     * @param bakeShader O programa de shaders/impostor_bake.vert e .frag.
+     * @param geometry A arena onde fica o quad desenhado por instância.
+     */
+    ImpostorAtlas(Model &model, const TextureArray &textures, Shader &bakeShader, GeometryArena &geometry,
+                  int framesPerSide = 8, int frameSize = 64);
+    ~ImpostorAtlas();
+
+    ImpostorAtlas(const ImpostorAtlas &) = delete;
+    ImpostorAtlas &operator=(const ImpostorAtlas &) = delete;
+
+    // Os uniformes "impostor*" de um programa, resolvidos uma vez.
+    struct Uniforms
+    {
+        Uniforms() = default;
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<int> albedo;
+        Uniform<int> normal;
+        Uniform<float> frames;
+        Uniform<glm::vec3> center;
+        Uniform<float> radius;
+    };
+
+    /**
+     * @brief Vincula as texturas às unidades dadas e define os uniformes "impostor*" do programa ativo.
+     */
+    void bind(const Uniforms &uniforms, int albedoUnit, int normalUnit) const;
+
+    // Vincula o VAO instanciado do quad, lendo as instâncias de 'instanceVBO'.
+    void bindInstanced(unsigned int instanceVBO);
+    // Desenha 'instanceCount' quads; requer bindInstanced().
+    void drawInstanced(unsigned int instanceCount, unsigned int baseInstance = 0) const;
+    // Comando de desenho indireto do quad, com instanceCount e baseInstance zerados.
+    DrawElementsIndirectCommand indirectCommand() const;
+    // Desenha o comando em 'byteOffset' do GL_DRAW_INDIRECT_BUFFER vinculado; requer bindInstanced().
+    void drawIndirect(size_t byteOffset) const;
+
+    // Memória ocupada na GPU pelas texturas do atlas.
+    size_t getByteSize() const { return m_byteSize; }
+
+private:
+    void bake(Model &model, const TextureArray &textures, Shader &bakeShader);
+
+    GeometryArena &m_geometry;
+    MeshRange m_quad;
+    int m_framesPerSide;
+    int m_frameSize;
+    unsigned int m_layerCount;
+
+    // Esfera envolvente do modelo: o quad e cada quadro cobrem o seu diâmetro.
+    glm::vec3 m_center = glm::vec3(0.0f);
+    float m_radius = 1.0f;
+
+    unsigned int m_albedo = 0;
+    unsigned int m_normal = 0;
+    size_t m_byteSize = 0;
+};
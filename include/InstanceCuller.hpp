@@ -0,0 +1,125 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "ImpostorAtlas.hpp"
+#include "Model.hpp"
+#include "Shader.hpp"
+#include "worldgen/Culling.hpp"
+
+/**
+ * @class InstanceCuller
+ * @brief Culling de instâncias na GPU, sem nenhuma leitura de volta para a CPU.
+ *
+ * Um compute shader (shaders/cull_instances.comp) lê todas as instâncias (worldgen::InstanceData) do buffer
+ * de origem como SSBO, testa a esfera de cada uma contra o frustum da passada (e o plano de corte da água)
+ * e a distância máxima, escolhe o LOD pela distância e acrescenta as sobreviventes a um buffer compacto.
+ * O próprio shader conta as instâncias nos comandos de desenho indireto, um por LOD, consumidos por
+ * glMultiDrawElementsIndirect.
+ *
+ * Com um impostor, as instâncias além de fadeStart também vão para um último comando, o do quad do
+ * impostor, e as além de fadeEnd só para ele.
+ *
+ * Por padrão todas as instâncias da origem são testadas; setSourceRanges() restringe o teste a alguns
+ * intervalos (um dispatch por intervalo), para buffers como o pool da grama, que só em parte têm instâncias.
+ *
+ * Cada LOD tem a sua região no buffer compacto, com espaço para todas as instâncias; com poucos LODs,
+ * isso evita uma segunda passada de soma de prefixos. Usa apenas recursos do núcleo do OpenGL 4.3
+ * (compute shaders, SSBOs, atomicAdd e desenho indireto), disponíveis também no llvmpipe do Mesa.
+ */
+class InstanceCuller
+{
+public:
+    // Impostor usado a partir de 'fadeStart'; até 'fadeEnd' a instância também é desenhada com a malha.
+    struct ImpostorRange
+    {
+        DrawElementsIndirectCommand command;
+        float fadeStart;
+        float fadeEnd;
+    };
+
+    // Verdadeiro se o contexto atual suporta compute shaders e desenho indireto (OpenGL 4.3).
+    static bool isSupported();
+
+    /**
+     * @param cullShader O programa de shaders/cull_instances.comp, compartilhado por todos os cullers.
+     * @param sourceBuffer O buffer com as instâncias; não é alterado.
+     * @param instanceCount O número de instâncias em 'sourceBuffer'.
+     * @param model O modelo desenhado; define a esfera envolvente e os LODs.
+     * @param lodCount Quantos LODs do modelo usar (1 = apenas a malha completa).
+     * @param maxDistance Distância da câmera até a posição da instância a partir da qual ela é descartada.
+     * @param impostor O comando do quad do impostor e a faixa de transição, ou nulo se não houver impostor.
+     */
+    InstanceCuller(Shader &cullShader, unsigned int sourceBuffer, uint32_t instanceCount, const Model &model, size_t lodCount, float maxDistance,
+                   const ImpostorRange *impostor = nullptr);
+    ~InstanceCuller();
+
+    InstanceCuller(const InstanceCuller &) = delete;
+    InstanceCuller &operator=(const InstanceCuller &) = delete;
+
+    // Intervalos do buffer de origem testados a partir do próximo cull(), dentro de [0, instanceCount).
+    void setSourceRanges(std::vector<worldgen::InstanceRange> ranges);
+    // Instâncias testadas por cull(): a soma dos intervalos.
+    uint32_t testedCount() const { return m_testedCount; }
+
+    /**
+     * @brief Executa o culling da passada atual e deixa os comandos prontos para draw().
+     * O LOD usa o mesmo critério da CPU: o erro do LOD, projetado no alvo da passada, abaixo de 'maxPixelError'.
+     * @param viewportHeight Altura do alvo da passada, em pixels (ver PassSettings).
+     * @param clipPlane O plano de corte da passada (vec4(0) se não houver).
+     * @param maxDistance Distância máxima desta passada; vale a menor entre ela e a do construtor.
+     */
+    void cull(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, const glm::vec4 &clipPlane, float maxPixelError = 1.0f,
+              float maxDistance = std::numeric_limits<float>::infinity());
+
+    /**
+     * @brief Desenha as instâncias visíveis com uma única chamada, com os shaders e texturas já vinculados.
+     * @return O número de comandos (LODs) submetidos.
+     */
+    size_t draw(Model &model);
+    // Desenha os quads das instâncias que usam o impostor (se houver), com o shader do impostor já vinculado.
+    void drawImpostors(ImpostorAtlas &impostor);
+
+private:
+    // Os uniforms de shaders/cull_instances.comp, resolvidos no construtor.
+    struct Uniforms
+    {
+        Uniform<glm::vec4> planes[7];
+        Uniform<int> planeCount;
+        Uniform<int> firstInstance;
+        Uniform<int> instanceCount;
+        Uniform<glm::vec3> boundsCenter;
+        Uniform<float> boundsRadius;
+        Uniform<glm::vec3> cameraPos;
+        Uniform<float> maxDistance;
+        Uniform<int> lodCount;
+        std::vector<Uniform<float>> lodDistances;
+        Uniform<int> impostorCommand;
+        Uniform<float> impostorFadeStart;
+        Uniform<float> impostorFadeEnd;
+    };
+
+    Shader &m_shader;
+    Uniforms m_uniforms;
+    unsigned int m_sourceBuffer;
+    uint32_t m_instanceCount;
+    float m_maxDistance;
+    std::vector<worldgen::InstanceRange> m_sourceRanges;
+    uint32_t m_testedCount;
+
+    // Esfera envolvente do modelo, em unidades do modelo.
+    glm::vec3 m_boundsCenter = glm::vec3(0.0f);
+    float m_boundsRadius = 0.0f;
+    std::vector<float> m_lodErrors;
+    bool m_hasImpostor = false;
+    float m_impostorFadeStart = 0.0f;
+    float m_impostorFadeEnd = 0.0f;
+
+    // Comandos com as contagens zeradas, reenviados antes de cada culling: um por LOD e, por último, o do impostor.
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    unsigned int m_visibleBuffer = 0;
+    unsigned int m_commandBuffer = 0;
+};
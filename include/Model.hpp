@@ -2,87 +2,118 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 #include <vector>
+#include "GeometryArena.hpp"
 #include "Shader.hpp"
-#include <glm/gtx/hash.hpp>
-
-/**
- * @struct Vertex
- * @brief Estrutura que encapsula todos os atributos de um único vértice.
- * Combina posição, normal e coordenadas de textura em uma única unidade de dados,
- * facilitando o gerenciamento e o envio para a GPU.
- */
-struct Vertex
-{
-    glm::vec3 Position;
-    glm::vec3 Normal;
-    glm::vec2 TexCoords;
-
-    // Sobrecarga do operador de igualdade, essencial para usar esta struct
-    // como chave em um std::unordered_map para otimização de vértices.
-    bool operator==(const Vertex &other) const
-    {
-        return Position == other.Position && Normal == other.Normal && TexCoords == other.TexCoords;
-    }
-};
-
-// Especialização de std::hash para a struct Vertex
-// Permite que a struct Vertex seja usada em estruturas de dados baseadas em hash,
-// como std::unordered_map. Isso é crucial para a otimização que remove vértices duplicados.
-namespace std
-{
-    template <>
-    struct hash<Vertex>
-    {
-        size_t operator()(Vertex const &vertex) const
-        {
-            return ((hash<glm::vec3>()(vertex.Position) ^
-                     (hash<glm::vec3>()(vertex.Normal) << 1)) >>
-                    1) ^
-                   (hash<glm::vec2>()(vertex.TexCoords) << 1);
-        }
-    };
-}
+#include "Texture.hpp"
+#include "worldgen/Culling.hpp"
+#include "worldgen/GlbLoader.hpp"
+#include "worldgen/MeshCache.hpp"
+#include "worldgen/VertexQuantizer.hpp"
 
 /**
  * @class Model
  * @brief Representa um modelo 3D renderizável.
- * Esta classe gerencia o carregamento de dados de um arquivo .obj, o envio desses dados
- * para a GPU através de buffers (VBO, EBO, VAO) e a renderização do modelo.
+ * Esta classe envia uma malha já carregada para a GPU, como um intervalo dos buffers compartilhados
+ * da GeometryArena, e a renderiza com a sua textura. Modelos são criados e compartilhados pelo ResourceManager,
+ * que evita carregar o mesmo arquivo duas vezes.
+ *
+ * Modelos lidos de um .glb são a exceção: os bufferViews do arquivo são enviados como estão para um buffer
+ * próprio, e o VAO do modelo descreve cada atributo com o formato do seu accessor (glVertexAttribFormat),
+ * sem nenhuma conversão na CPU.
  */
 class Model
 {
 public:
-    // O construtor carrega um modelo 3D e sua textura associada.
-    Model(const std::string &path, const std::string &texturePath);
-    ~Model(); // O destrutor é responsável por liberar os recursos da GPU.
+    // Envia a malha para a arena; a textura é compartilhada com outros modelos que a usem.
+    // Ela pode ser nula quando quem desenha o modelo vincula a sua própria textura (ex: uma TextureArray).
+    Model(GeometryArena &geometry, const worldgen::MeshView &mesh, std::shared_ptr<Texture> texture, VertexFormat format = VertexFormat::Float);
+    // Envia os bufferViews do .glb diretamente para a GPU, no formato de cada accessor.
+    Model(GeometryArena &geometry, const worldgen::GlbMesh &mesh, std::shared_ptr<Texture> texture);
+    ~Model(); // O destrutor devolve o intervalo da malha à arena (ou libera os buffers próprios do .glb).
+
+    // Um Model é dono do seu intervalo na arena e por isso não pode ser copiado.
+    Model(const Model &) = delete;
+    Model &operator=(const Model &) = delete;
 
     // Desenha o modelo na cena.
     void Draw(Shader &shader);
 
     // Getters para permitir que outras classes interajam com os dados do modelo (ex: para instancing).
-    unsigned int getVAO();
-    unsigned int getIndicesCount();
+    unsigned int getIndicesCount(); // Índices do LOD 0 (malha completa).
+    // Níveis de detalhe do modelo; todos compartilham os vértices e são intervalos dos mesmos índices.
+    const std::vector<worldgen::MeshLod> &getLods() const;
+    // Memória ocupada na arena (sem a textura).
+    size_t getByteSize() const;
+    const MeshRange &getRange() const { return m_range; }
+    // Caixa da malha em unidades do modelo (vazia se o arquivo não a informar), usada no culling das instâncias.
+    const worldgen::Aabb &getBounds() const { return m_bounds; }
+
+    /**
+     * @brief Vincula o VAO instanciado do formato do modelo, lendo as instâncias (worldgen::InstanceData) de 'instanceVBO'.
+     * Usado por quem desenha o modelo com dados de instância (atributos 3-6).
+     */
+    void bindInstanced(unsigned int instanceVBO);
 
-    // Ativa a textura do modelo para renderização.
+    // Desenha 'instanceCount' instâncias de um LOD; requer bindInstanced().
+    void drawLodInstanced(size_t lod, unsigned int instanceCount, unsigned int baseInstance = 0) const;
+
+    // Comando de desenho indireto de um LOD, com instanceCount e baseInstance zerados.
+    DrawElementsIndirectCommand indirectCommand(size_t lod) const;
+    // Desenha 'commandCount' comandos do GL_DRAW_INDIRECT_BUFFER vinculado (gerados por indirectCommand()); requer bindInstanced().
+    void drawIndirect(size_t commandCount) const;
+
+    // Ativa a textura do modelo para renderização (se houver).
     void bindTexture();
 
+    // Os uniformes "positionScale" e "positionOffset" de um programa, resolvidos uma vez.
+    struct PositionUniforms
+    {
+        PositionUniforms() = default;
+        explicit PositionUniforms(const Shader &shader);
+
+        Uniform<glm::vec3> scale;
+        Uniform<glm::vec3> offset;
+    };
+
+    // Define os uniformes "positionScale" e "positionOffset" usados pelo vertex shader para
+    // reconstruir a posição (identidade no formato Float).
+    void setPositionUniforms(Shader &shader) const;
+    void setPositionUniforms(const PositionUniforms &uniforms) const;
+
 private:
     // Métodos privados que organizam a lógica interna da classe.
 
-    // Carrega a geometria do modelo a partir de um arquivo .obj.
-    void loadModel(const std::string &path);
-    // Configura os buffers da GPU (VAO, VBO, EBO) com os dados do modelo.
-    void setupMesh();
-    // Carrega a textura a partir de um arquivo de imagem.
-    void loadTexture(const std::string &path);
-
-    // Dados do modelo armazenados na CPU.
-    std::vector<Vertex> vertices;      // Lista de vértices únicos.
-    std::vector<unsigned int> indices; // Ordem de desenho dos vértices para formar triângulos.
-
-    // IDs dos objetos OpenGL na GPU.
-    unsigned int VAO, VBO, EBO;
-    unsigned int m_textureID; // ID da textura na GPU.
-};
\ No newline at end of file
+    // Envia os vértices e índices do modelo para a arena.
+    void setupMesh(const worldgen::MeshView &mesh);
+    // Compacta os vértices e os envia para a arena.
+    void uploadPackedVertices(const worldgen::MeshView &mesh);
+    // Cria o buffer e os VAOs próprios de um modelo .glb.
+    void setupGlbMesh(const worldgen::GlbMesh &mesh);
+
+    // Número de índices do LOD 0 e tabela de LODs. Os dados de vértices e índices não ficam na CPU após o envio.
+    unsigned int m_indexCount;
+    std::vector<worldgen::MeshLod> m_lods;
+    VertexFormat m_format;
+    size_t m_byteSize = 0;
+    worldgen::Aabb m_bounds;
+
+    // Transformação da posição compactada de volta para unidades do modelo.
+    glm::vec3 m_positionScale = glm::vec3(1.0f);
+    glm::vec3 m_positionOffset = glm::vec3(0.0f);
+
+    // Intervalo da malha nos buffers compartilhados.
+    GeometryArena &m_geometry;
+    MeshRange m_range;
+    std::shared_ptr<Texture> m_texture;
+
+    // Apenas em modelos .glb: buffer com os bufferViews do arquivo, VAOs com o layout dos accessors
+    // e tipo/posição dos índices dentro do buffer.
+    unsigned int m_glbBuffer = 0;
+    unsigned int m_glbVAO = 0;
+    unsigned int m_glbInstancedVAO = 0;
+    GLenum m_indexType = GL_UNSIGNED_INT;
+    size_t m_indexByteOffset = 0;
+};
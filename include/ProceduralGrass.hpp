@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "GeometryArena.hpp"
+#include "Shader.hpp"
+#include "worldgen/Culling.hpp"
+#include "worldgen/GrassTiles.hpp"
+
+/**
+ * @class ProceduralGrass
+ * @brief Lâminas de grama geradas inteiramente no vertex shader (shaders/grass_blades.vert), sem malha e
+ * sem buffer de instâncias: a alternativa à GrassField.
+ *
+ * Cada instância do desenho é uma lâmina numa grade alinhada ao mundo em volta da câmera; o shader tira
+ * a posição, a altura, a largura e a curvatura de um hash da célula, e a altura do terreno e a cobertura
+ * de uma textura do tamanho da grade (worldgen::buildGrassMap). A memória não depende da densidade nem do
+ * quanto a câmera anda: só o mapa do terreno e um VAO vazio. A densidade é um uniforme, limitado por um
+ * orçamento de lâminas por desenho.
+ */
+class ProceduralGrass
+{
+public:
+    /**
+     * @param shader O programa de shaders/grass_blades.vert e grass_blades.frag.
+     * @param geometry A arena que vincula os VAOs da cena; o VAO vazio das lâminas também é vinculado por ela.
+     * @param width, depth O tamanho da grade do terreno.
+     * @param grassMap O resultado de worldgen::buildGrassMap para o mesmo terreno.
+     * @param coverage A faixa de altura e o limiar do ruído usados para gerar 'grassMap'.
+     */
+    ProceduralGrass(Shader &shader, GeometryArena &geometry, int width, int depth, const std::vector<float> &grassMap, const worldgen::GrassCoverage &coverage);
+    ~ProceduralGrass();
+
+    ProceduralGrass(const ProceduralGrass &) = delete;
+    ProceduralGrass &operator=(const ProceduralGrass &) = delete;
+
+    // Lâminas por unidade² perto da câmera, antes do limite de 'maxBlades'.
+    void setDensity(float bladesPerUnit) { m_density = bladesPerUnit; }
+    float getDensity() const { return m_density; }
+    // Lâminas por desenho, no máximo: acima disso, a densidade efetiva é reduzida.
+    void setBudget(uint32_t maxBlades) { m_maxBlades = maxBlades; }
+
+    // Desenha as lâminas em volta de 'cameraPos'. O shader recebe os uniformes da passada (luz, plano de corte) antes.
+    // Cada unidade de 'lodBias' corta a densidade pela metade; 'maxDistance' encurta o raio da grade.
+    void Draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPos, worldgen::CullStats *stats = nullptr,
+              float lodBias = 0.0f, float maxDistance = std::numeric_limits<float>::infinity());
+
+private:
+    // Os uniformes de shaders/grass_blades.vert, resolvidos no construtor.
+    struct Uniforms
+    {
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<glm::mat4> view;
+        Uniform<glm::mat4> projection;
+        Uniform<int> grassMap;
+        Uniform<glm::vec2> terrainSize;
+        Uniform<glm::vec2> heightBand;
+        Uniform<float> noiseThreshold;
+        Uniform<int> gridSide;
+        Uniform<glm::vec2> gridOrigin;
+        Uniform<float> spacing;
+        Uniform<float> fadeStart;
+        Uniform<float> radius;
+    };
+
+    Shader &m_shader;
+    Uniforms m_uniforms;
+    GeometryArena &m_geometry;
+    int m_width;
+    int m_depth;
+    glm::vec2 m_heightBand; // Alturas do terreno, em unidades do mundo, onde a grama cresce.
+    float m_noiseThreshold;
+    float m_density = 16.0f;
+    uint32_t m_maxBlades = 262144;
+    float m_radius = 48.0f;     // Raio da grade de lâminas em volta da câmera.
+    float m_fadeStart = 24.0f;  // Distância a partir da qual as lâminas rareiam até o raio.
+
+    unsigned int m_grassMap = 0; // Textura RG32F: altura do terreno e ruído de cobertura.
+    unsigned int m_vao = 0;      // Sem atributos; o perfil core exige um VAO ligado para desenhar.
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// As camadas da cena que cada passada pode desenhar ou omitir.
+enum class SceneLayer
+{
+    Terrain,
+    Sun,
+    Grass,
+    Vegetation,
+    Count
+};
+
+/**
+ * @struct LayerSettings
+ * @brief Como uma passada desenha uma camada da cena.
+ */
+struct LayerSettings
+{
+    bool visible = true;
+    // Somado ao nível de detalhe: cada unidade dobra o erro aceito em pixels dos LODs da vegetação, sobe um
+    // nível na textura virtual do terreno e corta pela metade a densidade da grama procedural.
+    float lodBias = 0.0f;
+    // Distância da câmera além da qual as instâncias não são desenhadas (o terreno e o sol a ignoram).
+    float maxDistance = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * @struct PassSettings
+ * @brief A máscara, o bias de LOD e a distância máxima de cada camada numa passada de renderização.
+ * As passadas da água enxergam a cena num FBO menor, ou através da água, e dispensam parte do detalhe.
+ */
+struct PassSettings
+{
+    std::string name;
+    // Altura do alvo da passada, em pixels: converte o erro dos LODs em pixels sem consultar o viewport.
+    int viewportHeight = 0;
+    LayerSettings layers[static_cast<size_t>(SceneLayer::Count)];
+
+    LayerSettings &operator[](SceneLayer layer) { return layers[static_cast<size_t>(layer)]; }
+    const LayerSettings &operator[](SceneLayer layer) const { return layers[static_cast<size_t>(layer)]; }
+};
+
+/**
+ * @class PassTimer
+ * @brief Tempo de cada passada na GPU (GL_TIME_ELAPSED) e na CPU, em médias entre dois relatórios.
+ *
+ * O resultado de uma consulta só é lido LATENCY frames depois, quando a GPU já terminou aquele frame:
+ * a medição não sincroniza a CPU com a GPU.
+ */
+class PassTimer
+{
+public:
+    explicit PassTimer(size_t passCount);
+    ~PassTimer();
+
+    PassTimer(const PassTimer &) = delete;
+    PassTimer &operator=(const PassTimer &) = delete;
+
+    // Envolve os comandos de uma passada. Consultas de tempo não podem se aninhar: uma passada de cada vez.
+    void begin(size_t pass);
+    void end(size_t pass);
+
+    // Médias por frame, em milissegundos, desde o último reset().
+    double gpuMilliseconds(size_t pass) const;
+    double cpuMilliseconds(size_t pass) const;
+    void reset();
+
+private:
+    static const size_t LATENCY = 3;
+
+    struct Pass
+    {
+        unsigned int queries[LATENCY] = {};
+        bool pending[LATENCY] = {};
+        size_t frame = 0;
+        std::chrono::steady_clock::time_point cpuStart;
+        double gpuTotal = 0.0;
+        double cpuTotal = 0.0;
+        uint64_t gpuSamples = 0;
+        uint64_t cpuSamples = 0;
+    };
+
+    std::vector<Pass> m_passes;
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GeometryArena.hpp"
+#include "Model.hpp"
+#include "Texture.hpp"
+#include "TextureArray.hpp"
+#include "worldgen/GlbLoader.hpp"
+#include "worldgen/MeshCache.hpp"
+#include "worldgen/TextureCache.hpp"
+
+/**
+ * @class ResourceManager
+ * @brief Carrega modelos e texturas uma única vez e os compartilha entre quem os usa.
+ *
+ * Os recursos são entregues como std::shared_ptr (contagem de referências) e ficam em cache
+ * em dois níveis: dados lidos na CPU, indexados pelo caminho normalizado, e objetos na GPU,
+ * indexados pelo caminho normalizado mais as opções de importação. Assim, a mesma imagem com
+ * opções diferentes é lida uma vez só, e o mesmo .obj em formatos diferentes é lido uma vez só.
+ * As imagens chegam comprimidas em blocos e com mipmaps, do cache .texbin gravado ao lado de cada uma.
+ *
+ * Tempo de vida: os objetos OpenGL são liberados quando o último shared_ptr é destruído.
+ * O ResourceManager e todos os objetos que recebem recursos dele devem viver dentro do
+ * escopo que termina antes de glfwTerminate(); criá-lo antes dos demais garante que ele
+ * seja destruído por último.
+ *
+ * Threads: o cache da CPU é protegido por um mutex e pode ser preenchido de qualquer thread
+ * com prefetchMesh()/prefetchImage(); pedidos simultâneos do mesmo arquivo esperam a mesma leitura.
+ * Os métodos que criam objetos na GPU só podem ser chamados na thread do contexto OpenGL.
+ */
+class ResourceManager
+{
+public:
+    // Os modelos são alocados em 'geometry', que deve ser destruída depois do ResourceManager.
+    explicit ResourceManager(GeometryArena &geometry) : m_geometry(geometry) {}
+    ~ResourceManager();
+
+    ResourceManager(const ResourceManager &) = delete;
+    ResourceManager &operator=(const ResourceManager &) = delete;
+
+    /**
+     * @brief Devolve a textura do arquivo, carregando-a e enviando-a à GPU apenas na primeira vez.
+     */
+    std::shared_ptr<Texture> getTexture(const std::string &path, const TextureOptions &options = TextureOptions());
+
+    /**
+     * @brief Devolve uma textura array com uma camada por arquivo, na ordem dada, criando-a apenas na primeira vez
+     * para cada lista de arquivos e opções. As imagens vêm do mesmo cache da CPU que getTexture() usa.
+     * Lança std::runtime_error se as imagens não tiverem o mesmo tamanho e formato.
+     */
+    std::shared_ptr<TextureArray> getTextureArray(const std::vector<std::string> &paths, const TextureOptions &options = TextureOptions());
+
+    /**
+     * @brief Devolve o modelo (malha + textura), criando-o apenas na primeira vez para cada combinação
+     * de arquivo, textura e formato de vértices. Com 'texturePath' vazio o modelo fica sem textura, para quem
+     * desenha com uma TextureArray.
+     * A malha pode vir de um .obj (com cache binário e LODs) ou de um .glb, cujos atributos são enviados
+     * à GPU no formato em que estão no arquivo (nesse caso 'format' é ignorado).
+     */
+    std::shared_ptr<Model> getModel(const std::string &path, const std::string &texturePath, VertexFormat format = VertexFormat::Float);
+
+    /**
+     * @brief Lê a malha do arquivo (.obj ou .glb) para o cache da CPU, sem tocar na GPU. Pode ser chamada de qualquer thread.
+     */
+    void prefetchMesh(const std::string &path);
+
+    /**
+     * @brief Lê a imagem do arquivo, já comprimida, para o cache da CPU, sem tocar na GPU. Pode ser chamada de qualquer thread.
+     * Na primeira execução é aqui que a imagem é decodificada, comprimida e tem o cache gravado.
+     */
+    void prefetchImage(const std::string &path, worldgen::TextureCompression compression = worldgen::TextureCompression::Auto);
+
+    /**
+     * @brief Descarta os dados lidos na CPU. Chamar após carregar a cena: os objetos na GPU
+     * continuam em cache, mas um novo formato do mesmo arquivo voltará a lê-lo do disco.
+     */
+    void releaseCpuData();
+
+    /**
+     * @brief Libera os recursos da GPU que só o cache ainda referencia.
+     */
+    void releaseUnused();
+
+    // Imprime acertos, faltas e bytes economizados de cada cache.
+    void printStats() const;
+
+private:
+    // Estatísticas de um cache. 'bytesSaved' soma o tamanho dos dados que não precisaram ser
+    // decodificados ou enviados à GPU novamente graças aos acertos.
+    struct CacheStats
+    {
+        unsigned int hits = 0;
+        unsigned int misses = 0;
+        size_t bytesSaved = 0;
+    };
+
+    // Dados na CPU. Cada entrada é o resultado (futuro) da leitura, para que quem pedir o mesmo
+    // arquivo durante a leitura espere por ela em vez de lê-lo de novo.
+    template <typename T>
+    using CpuCache = std::unordered_map<std::string, std::shared_future<std::shared_ptr<const T>>>;
+
+    template <typename T, typename Load>
+    std::shared_ptr<const T> getOrLoad(CpuCache<T> &cache, CacheStats &stats, const std::string &key, size_t (*byteSize)(const T &), Load load);
+
+    std::shared_ptr<const worldgen::CachedMesh> getMeshData(const std::string &key);
+    std::shared_ptr<const worldgen::GlbMesh> getGlbData(const std::string &key);
+    std::shared_ptr<const worldgen::CompressedTexture> getImageData(const std::string &path, worldgen::TextureCompression compression);
+
+    static bool isGlb(const std::string &path);
+
+    // Caminho absoluto e sem "." / ".." / barras duplicadas, para que grafias diferentes do mesmo arquivo coincidam.
+    static std::string normalizePath(const std::string &path);
+    // Parte da chave de cache da GPU que identifica as opções de importação.
+    static std::string optionsKey(const TextureOptions &options);
+
+    GeometryArena &m_geometry;
+
+    // Protege m_meshData, m_glbData, m_imageData e as suas estatísticas.
+    mutable std::mutex m_cpuMutex;
+    CpuCache<worldgen::CachedMesh> m_meshData;
+    CpuCache<worldgen::GlbMesh> m_glbData;
+    CpuCache<worldgen::CompressedTexture> m_imageData; // Chave: caminho + modo de compressão.
+    std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+    std::unordered_map<std::string, std::shared_ptr<TextureArray>> m_textureArrays;
+    std::unordered_map<std::string, std::shared_ptr<Model>> m_models;
+
+    CacheStats m_meshDataStats;
+    CacheStats m_imageDataStats;
+    CacheStats m_textureStats;
+    CacheStats m_modelStats;
+};
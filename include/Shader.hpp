@@ -3,7 +3,13 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+template <typename T>
+class Uniform;
 
 /**
  * @class Shader
@@ -12,6 +18,13 @@
  * Esta classe abstrai o processo de carregar shaders de vertex e fragment a partir de ficheiros,
  * compilá-los, ligá-los a um programa de shader e fornecer uma interface
  * fácil para ativar o programa e definir as suas variáveis 'uniform'.
+ *
+ * As localizações de todos os uniforms ativos (e de cada elemento dos arrays) são lidas uma vez, logo
+ * depois da ligação; os setters só procuram o nome nesse cache, sem glGetUniformLocation. O programa
+ * guarda o último valor enviado a cada uniform, e um valor igual não é reenviado. Nos pontos quentes,
+ * um Uniform<T> obtido com uniform<T>() evita até a busca pelo nome.
+ *
+ * Não é copiável: os Uniform<T> guardam um ponteiro para o Shader que os criou.
  */
 class Shader
 {
@@ -26,6 +39,15 @@ public:
      */
     Shader(const char *vertexPath, const char *fragmentPath);
 
+    /**
+     * @brief Construtor de um programa de compute shader (requer OpenGL 4.3).
+     * @param computePath O caminho do ficheiro para o código-fonte do compute shader.
+     */
+    explicit Shader(const char *computePath);
+
+    Shader(const Shader &) = delete;
+    Shader &operator=(const Shader &) = delete;
+
     /**
      * @brief Ativa este programa de shader para ser usado nas subsequentes chamadas de renderização.
      */
@@ -41,13 +63,106 @@ public:
     void setVec4(const std::string &name, const glm::vec4 &value) const;
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
+    // Handle de um uniform, resolvido uma vez. Um nome que não é um uniform ativo, ou cujo tipo no GLSL não
+    // corresponde a T, dá um handle que não faz nada (o tipo incompatível é reportado).
+    template <typename T>
+    Uniform<T> uniform(const std::string &name) const;
+
+    // Chamadas glUniform* feitas e evitadas (valor igual ao último enviado), somadas em todos os programas
+    // desde o último resetUniformCounters().
+    static uint64_t uniformCallCount();
+    static uint64_t skippedUniformCount();
+    static void resetUniformCounters();
+
 private:
+    template <typename T>
+    friend class Uniform;
+
+    // O tipo do uniform no GLSL e o último valor enviado, como bytes (até uma mat4).
+    struct UniformSlot
+    {
+        GLint location;
+        GLenum type;
+        bool known = false;
+        unsigned char value[sizeof(glm::mat4)];
+    };
+
+    // Lê as localizações dos uniforms ativos do programa recém-ligado.
+    void cacheUniforms();
+    // Índice do uniform em m_slots, ou -1 se o programa não o tiver.
+    int slotOf(const std::string &name) const;
+    // Como slotOf, mas também -1 se o tipo do uniform no GLSL não aceitar um valor do tipo T.
+    template <typename T>
+    int typedSlotOf(const std::string &name) const
+    {
+        int slot = slotOf(name);
+        return slot >= 0 && accepts(m_slots[slot].type, static_cast<const T *>(nullptr)) ? slot : -1;
+    }
+
+    // Verdadeiro se um uniform do tipo GLSL 'type' pode receber o valor do tipo C++ do segundo argumento
+    // (int também serve para bool, samplers e images).
+    static bool accepts(GLenum type, const int *);
+    static bool accepts(GLenum type, const float *);
+    static bool accepts(GLenum type, const glm::vec2 *);
+    static bool accepts(GLenum type, const glm::vec3 *);
+    static bool accepts(GLenum type, const glm::vec4 *);
+    static bool accepts(GLenum type, const glm::mat4 *);
+    static void reportTypeMismatch(const std::string &name);
+    // Verdadeiro se 'value' difere do último valor enviado ao slot (e passa a ser o último).
+    bool changed(int slot, const void *value, size_t size) const;
+
+    void upload(int slot, int value) const;
+    void upload(int slot, float value) const;
+    void upload(int slot, const glm::vec2 &value) const;
+    void upload(int slot, const glm::vec3 &value) const;
+    void upload(int slot, const glm::vec4 &value) const;
+    void upload(int slot, const glm::mat4 &value) const;
+
+    std::unordered_map<std::string, int> m_slotByName;
+    mutable std::vector<UniformSlot> m_slots;
+
     /**
      * @brief Verifica erros de compilação ou de ligação de shaders.
      * @param shader O ID do objeto shader ou do programa a ser verificado.
-     * @param type O tipo de objeto ("VERTEX", "FRAGMENT" ou "PROGRAM") para contextualizar a mensagem de erro.
+     * @param type O tipo de objeto ("VERTEX", "FRAGMENT", "COMPUTE" ou "PROGRAM") para contextualizar a mensagem de erro.
      */
     void checkCompileErrors(unsigned int shader, std::string type);
 };
 
+/**
+ * @class Uniform
+ * @brief Um uniform de um Shader, com a localização já resolvida: set() não procura o nome nem
+ * chama o OpenGL se o valor for o último enviado. O programa deve estar ativo (use()).
+ */
+template <typename T>
+class Uniform
+{
+public:
+    Uniform() = default;
+
+    void set(const T &value) const
+    {
+        if (m_shader)
+            m_shader->upload(m_slot, value);
+    }
+    // Falso se o programa não tem esse uniform (por exemplo, removido pelo compilador por não ser usado).
+    bool valid() const { return m_shader != nullptr; }
+
+private:
+    friend class Shader;
+    Uniform(const Shader *shader, int slot) : m_shader(slot >= 0 ? shader : nullptr), m_slot(slot) {}
+
+    const Shader *m_shader = nullptr;
+    int m_slot = -1;
+};
+
+template <typename T>
+Uniform<T> Shader::uniform(const std::string &name) const
+{
+    int slot = typedSlotOf<T>(name);
+    if (slot < 0 && slotOf(name) >= 0)
+        reportTypeMismatch(name);
+    return Uniform<T>(this, slot);
+}
+
 #endif
\ No newline at end of file
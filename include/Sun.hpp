@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
+#include "GeometryArena.hpp"
 #include "Shader.hpp"
 
 /**
@@ -20,9 +21,10 @@ public:
     /**
      * @brief Construtor da classe Sun.
      * @param shader A referência ao programa de shader que será usado para desenhar o sol.
+     * @param geometry A arena onde a malha da esfera é alocada.
      */
-    Sun(Shader &shader);
-    ~Sun(); // Destrutor para liberar os recursos da GPU.
+    Sun(Shader &shader, GeometryArena &geometry);
+    ~Sun(); // Destrutor que devolve a malha à arena.
 
     /**
      * @brief Atualiza o estado do sol.
@@ -46,9 +48,9 @@ public:
 private:
     // Referência ao shader do sol.
     Shader &m_shader;
-    // IDs dos objetos OpenGL para a malha da esfera.
-    unsigned int m_vao, m_vbo, m_ebo;
-    unsigned int m_indexCount; // Número de índices para desenhar a esfera.
+    // Intervalo da malha da esfera nos buffers compartilhados da arena.
+    GeometryArena &m_geometry;
+    MeshRange m_range;
 
     glm::vec3 m_position;       // Posição atual no espaço do mundo.
     glm::vec3 m_lightDirection; // Direção normalizada da luz.
@@ -1,7 +1,13 @@
 #ifndef TERRAIN_H
 #define TERRAIN_H
 
+#include "AssetLoader.hpp"
+#include "GeometryArena.hpp"
 #include "Shader.hpp"
+#include "VirtualTexture.hpp"
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/TerrainSurface.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
@@ -10,31 +16,41 @@
  * @class Terrain
  * @brief Gerencia a geração procedural, texturização e renderização do terreno.
  *
- * Esta classe cria uma malha de terreno baseada em Ruído de Perlin,
- * aplica múltiplas texturas (areia, grama, rocha) que são misturadas no shader
- * com base na altura, e fornece informações sobre sua geometria para outros objetos.
+ * A grade de alturas e a malha são geradas pela libworldgen (sem OpenGL); esta classe
+ * apenas envia o resultado para a GPU e fornece informações sobre sua geometria para outros objetos.
+ * A superfície é uma textura virtual com detalhe único por texel: a mistura de areia, grama e rocha por
+ * altura e inclinação é composta na CPU, página a página, só onde e na resolução em que a câmera a vê.
  */
 class Terrain
 {
 public:
     /**
-     * @brief Construtor da classe Terrain.
-     * @param width A largura do terreno na grade de vértices.
-     * @param depth A profundidade do terreno na grade de vértices.
+     * @brief Construtor da classe Terrain. Só envia à GPU dados já gerados, para que a geração
+     * (worldgen::generateHeightfield / buildTerrainMesh) possa rodar numa thread de trabalho.
+     * @param heightfield A grade de alturas e normais do terreno.
+     * @param mesh A geometria do terreno, gerada a partir da grade.
      * @param shader A referência ao shader que será usado para renderizar o terreno.
-     * @param sandTexturePath O caminho para a textura de areia.
-     * @param grassTexturePath O caminho para a textura de grama.
-     * @param rockTexturePath O caminho para a textura de rocha.
+     * @param geometry A arena onde a malha do terreno é alocada.
+     * @param loader Compõe as páginas da textura virtual nas suas threads; deve viver enquanto o terreno existir.
+     * @param surface As texturas de detalhe já decodificadas, que compõem as páginas.
      */
-    Terrain(int width, int depth, Shader &shader, const std::string &sandTexturePath, const std::string &grassTexturePath, const std::string &rockTexturePath);
+    Terrain(worldgen::Heightfield heightfield, const worldgen::TerrainMesh &mesh, Shader &shader, GeometryArena &geometry, AssetLoader &loader, std::shared_ptr<const worldgen::TerrainSurface> surface);
     ~Terrain(); // Destrutor para liberar os recursos da GPU.
 
     /**
      * @brief Desenha o terreno na cena.
      * @param view A matriz de visão da câmera.
      * @param projection A matriz de projeção da câmera.
+     * @param lodBias Níveis somados ao mipmap da textura virtual (positivo = páginas mais grosseiras).
      */
-    void Draw(const glm::mat4 &view, const glm::mat4 &projection);
+    void Draw(const glm::mat4 &view, const glm::mat4 &projection, float lodBias = 0.0f);
+
+    /**
+     * @brief Atualiza a textura virtual com o feedback já lido e desenha o terreno no buffer de feedback,
+     * que registra as páginas necessárias para a vista da câmera. Chamar uma vez por frame, com a vista principal.
+     * @param feedbackShader Shader com terrain.vert e terrain_feedback.frag.
+     */
+    void DrawFeedback(const glm::mat4 &view, const glm::mat4 &projection, Shader &feedbackShader, int screenWidth, int screenHeight);
 
     // Getters
     //  Funções essenciais para que outros objetos possam interagir com o terreno.
@@ -42,45 +58,39 @@ public:
     int getDepth() const;
     float getHeight(int x, int z) const;
     glm::vec3 getNormal(float x, float z) const;
+    const worldgen::Heightfield &getHeightfield() const;
 
 private:
+    // Os uniformes de um programa do terreno (o da cena ou o de feedback), resolvidos uma vez.
+    struct Uniforms
+    {
+        Uniforms() = default;
+        explicit Uniforms(const Shader &shader);
+
+        const Shader *shader = nullptr;
+        Uniform<glm::mat4> projection;
+        Uniform<glm::mat4> view;
+        Uniform<glm::mat4> model;
+        Uniform<glm::vec4> plane;
+        VirtualTexture::Uniforms surface;
+    };
+
     // Dimensões da grade do terreno.
     int m_width, m_depth;
-    // IDs dos objetos OpenGL.
-    unsigned int m_VAO, m_VBO, m_EBO;
-    unsigned int m_indexCount;
     // Referência ao shader do terreno.
     Shader &m_shader;
+    Uniforms m_uniforms;
+    Uniforms m_feedbackUniforms; // Resolvidos no primeiro DrawFeedback, e de novo se o programa mudar.
+    // Intervalo da malha nos buffers compartilhados da arena.
+    GeometryArena &m_geometry;
+    MeshRange m_range;
 
-    // Cache das alturas do terreno para acesso rápido.
-    std::vector<float> m_heights;
+    // Cache das alturas e normais do terreno para acesso rápido.
+    worldgen::Heightfield m_heightfield;
 
-    // IDs das texturas na GPU.
-    unsigned int m_grassTextureID;
-    unsigned int m_rockTextureID;
-    unsigned int m_sandTextureID;
+    // Superfície do terreno: páginas compostas sob demanda.
+    std::unique_ptr<VirtualTexture> m_virtualTexture;
 
-    /**
-     * @brief Configura os buffers da GPU (VAO, VBO, EBO) com a geometria do terreno.
-     */
-    void setupTerrain(const std::vector<float> &vertices, const std::vector<unsigned int> &indices);
-
-    /**
-     * @brief Carrega uma textura a partir de um arquivo e retorna seu ID OpenGL.
-     */
-    unsigned int loadTexture(const char *path);
-
-    // Funções Auxiliares para Geração Procedural
-
-    /**
-     * @brief Calcula a altura (coordenada Y) de um ponto no terreno usando Ruído de Perlin.
-     */
-    float calculateHeight(float x, float z) const;
-
-    /**
-     * @brief Calcula a normal da superfície em um ponto do terreno.
-     */
-    glm::vec3 calculateNormal(int x, int z) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include "worldgen/TextureCache.hpp"
+
+/**
+ * @struct TextureOptions
+ * @brief Opções de importação de uma textura; fazem parte da chave de cache no ResourceManager.
+ */
+struct TextureOptions
+{
+    GLint wrap = GL_REPEAT; // Modo de repetição nos eixos S e T.
+    bool mipmaps = true;    // Envia a cadeia de mipmaps do cache e usa filtragem trilinear.
+    worldgen::TextureCompression compression = worldgen::TextureCompression::Auto;
+};
+
+/**
+ * @class Texture
+ * @brief Textura 2D na GPU, criada a partir de uma imagem já comprimida em blocos (BC1/BC3/BC4/BC5)
+ * e com os mipmaps prontos; nada é descomprimido nem gerado na GPU.
+ * É dona do objeto OpenGL e o libera no destrutor; por isso não pode ser copiada.
+ * Normalmente é obtida e compartilhada através do ResourceManager.
+ */
+class Texture
+{
+public:
+    Texture(const worldgen::CompressedTexture &image, const TextureOptions &options);
+    ~Texture();
+
+    Texture(const Texture &) = delete;
+    Texture &operator=(const Texture &) = delete;
+
+    unsigned int getID() const { return m_id; }
+    // Memória ocupada na GPU, incluindo os mipmaps.
+    size_t getByteSize() const { return m_byteSize; }
+
+    // Vincula a textura à unidade de textura ativa.
+    void bind() const;
+
+    // Formato interno do OpenGL para os blocos comprimidos.
+    static GLenum internalFormat(worldgen::BlockFormat format);
+
+private:
+    unsigned int m_id;
+    size_t m_byteSize = 0;
+};
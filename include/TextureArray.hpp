@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+#include "Texture.hpp"
+#include "worldgen/TextureCache.hpp"
+
+/**
+ * @class TextureArray
+ * @brief Textura GL_TEXTURE_2D_ARRAY com várias imagens do mesmo tamanho e formato, uma por camada.
+ * As variantes de um modelo (ex: os tipos de grama) ficam em camadas da mesma textura, e cada instância
+ * escolhe a sua pela camada nos dados de instância; qualquer mistura de variantes sai numa única
+ * chamada de desenho instanciada, sem trocar de textura.
+ * É dona do objeto OpenGL e o libera no destrutor; normalmente é obtida através do ResourceManager.
+ */
+class TextureArray
+{
+public:
+    /**
+     * @brief Envia as imagens, já comprimidas e com mipmaps, como camadas 0..n-1.
+     * Lança std::runtime_error se as imagens não tiverem todas o mesmo tamanho e formato.
+     */
+    TextureArray(const std::vector<const worldgen::CompressedTexture *> &layers, const TextureOptions &options);
+    ~TextureArray();
+
+    TextureArray(const TextureArray &) = delete;
+    TextureArray &operator=(const TextureArray &) = delete;
+
+    unsigned int getID() const { return m_id; }
+    unsigned int getLayerCount() const { return m_layerCount; }
+    // Memória ocupada na GPU, somando todas as camadas e mipmaps.
+    size_t getByteSize() const { return m_byteSize; }
+
+    // Vincula a textura à unidade de textura ativa.
+    void bind() const;
+
+private:
+    unsigned int m_id;
+    unsigned int m_layerCount = 0;
+    size_t m_byteSize = 0;
+};
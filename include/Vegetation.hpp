@@ -1,58 +1,127 @@
 #ifndef VEGETATION_H
 #define VEGETATION_H
 
+#include <limits>
+#include <memory>
 #include <vector>
 #include <glm/glm.hpp>
 #include "Shader.hpp"
+#include "ImpostorAtlas.hpp"
+#include "InstanceCuller.hpp"
 #include "Model.hpp"
-#include "Terrain.hpp"
+#include "TextureArray.hpp"
+#include "worldgen/Culling.hpp"
+#include "worldgen/Placement.hpp"
 
 /**
  * @class Vegetation
  * @brief Gerencia a criação e renderização de um grande número de instâncias de um modelo.
  *
  * Esta classe utiliza a técnica de renderização instanciada para desenhar de forma eficiente
- * múltiplos objetos (como flores, rochas, etc.) na paisagem. Ela posiciona os objetos
- * aleatoriamente no terreno e os alinha com a normal da superfície para maior realismo.
+ * múltiplos objetos (como flores, rochas, etc.) na paisagem. As posições vêm de
+ * worldgen::placeVegetation, que espalha os objetos aleatoriamente no terreno e os alinha
+ * com a normal da superfície para maior realismo.
+ * As texturas das variantes ficam numa TextureArray e cada instância escolhe a sua camada, de modo que
+ * misturar variantes não acrescenta chamadas de desenho.
+ * A cada desenho, as células da grade fora do frustum são descartadas, e as instâncias restantes
+ * são agrupadas pelo LOD do modelo adequado à sua distância da câmera, com uma chamada de desenho
+ * instanciada por LOD. Com um InstanceCuller, o teste, a escolha do LOD e o agrupamento são feitos
+ * por instância na GPU, e as instâncias não passam mais pela CPU depois do envio inicial.
+ * Com um ImpostorAtlas, as instâncias distantes viram um quad cada, com uma transição por dithering
+ * entre a malha e o impostor.
  */
 class Vegetation
 {
 public:
     /**
      * @brief Construtor da classe Vegetation.
-     * @param terrain A referência ao terreno onde a vegetação será colocada.
      * @param shader A referência ao shader usado para renderizar a vegetação.
-     * @param model A referência ao modelo 3D que será instanciado.
-     * @param count O número desejado de instâncias a serem geradas.
-     * @param minHeight A altura mínima no terreno para posicionar uma instância.
-     * @param maxHeight A altura máxima no terreno para posicionar uma instância.
-     * @param scale A escala a ser aplicada a cada instância.
-     * @param modelUp O vetor que representa a direção "para cima" no modelo original (padrão é 0,1,0).
+     * @param model O modelo 3D que será instanciado (compartilhado, obtido do ResourceManager).
+     * @param textures As texturas das variantes do modelo, uma por camada.
+     * @param instances A transformação e a camada de cada instância, geradas por worldgen::placeVegetation e
+     * worldgen::assignVariants (possivelmente numa thread de trabalho).
+     * @param cullShader Programa de culling na GPU (shaders/cull_instances.comp), ou nulo para usar a grade na CPU.
+     * @param impostor O atlas de impostores do modelo, ou nulo para desenhar sempre a malha.
+     * @param impostorShader O programa de shaders/impostor.vert e .frag (obrigatório com 'impostor').
      */
-    Vegetation(Terrain &terrain, Shader &shader, Model &model, int count, float minHeight, float maxHeight, float scale, glm::vec3 modelUp = glm::vec3(0.0f, 1.0f, 0.0f));
+    Vegetation(Shader &shader, std::shared_ptr<Model> model, std::shared_ptr<TextureArray> textures, std::vector<worldgen::InstanceData> instances,
+               Shader *cullShader = nullptr, std::shared_ptr<ImpostorAtlas> impostor = nullptr, Shader *impostorShader = nullptr);
     ~Vegetation(); // Destrutor para liberar os recursos da GPU.
 
     /**
-     * @brief Desenha todas as instâncias da vegetação.
+     * @brief Desenha as instâncias visíveis da vegetação.
      * @param view A matriz de visão da câmera.
      * @param projection A matriz de projeção da câmera.
+     * @param viewportHeight Altura do alvo da passada, em pixels (ver PassSettings).
+     * @param clipPlane O plano de corte da passada (vec4(0) se não houver).
+     * @param stats Se não for nulo, acumula as instâncias enviadas e descartadas e o número de desenhos.
+     * @param lodBias Cada unidade dobra o erro em pixels aceito na escolha do LOD (LODs mais simples).
+     * @param maxDistance Instâncias mais distantes da câmera não são desenhadas.
      */
-    void Draw(const glm::mat4 &view, const glm::mat4 &projection);
+    void Draw(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, const glm::vec4 &clipPlane = glm::vec4(0.0f),
+              worldgen::CullStats *stats = nullptr, float lodBias = 0.0f, float maxDistance = std::numeric_limits<float>::infinity());
 
 private:
+    // Os uniformes do programa da malha e do programa do impostor, resolvidos no construtor.
+    struct Uniforms
+    {
+        Uniforms() = default;
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<glm::mat4> projection;
+        Uniform<glm::mat4> view;
+        Uniform<int> textureDiffuse;
+        Uniform<float> impostorFadeStart;
+        Uniform<float> impostorFadeEnd;
+        Model::PositionUniforms position;
+        ImpostorAtlas::Uniforms impostor;
+    };
+
     // Referências a objetos externos.
     Shader &m_shader;
-    Model &m_model;
+    std::shared_ptr<Model> m_model;
+    std::shared_ptr<TextureArray> m_textures;
+    std::shared_ptr<ImpostorAtlas> m_impostor;
+    Shader *m_impostorShader;
+    Uniforms m_uniforms;
+    Uniforms m_impostorUniforms; // Vazios sem impostor.
 
     // Propriedades das instâncias.
-    int m_count; // O número final de instâncias geradas.
-    unsigned int m_instanceVBO; // ID do VBO que armazena as matrizes de modelo.
-    std::vector<glm::mat4> m_modelMatrices; // Lista de matrizes de transformação para cada instância.
+    int m_count; // O número de instâncias.
+    unsigned int m_instanceVBO; // ID do VBO que armazena os dados das instâncias.
+    std::vector<worldgen::InstanceData> m_instances; // Transformação compacta e variante de cada instância, por célula.
+    worldgen::InstanceGrid m_grid;
+    std::vector<worldgen::InstanceRange> m_visibleRanges; // Células visíveis no último desenho.
+    std::unique_ptr<InstanceCuller> m_culler; // Nulo no culling pela CPU.
+
+    // Instâncias visíveis reordenadas por LOD a cada desenho, e quantas caem em cada LOD; as que usam
+    // o impostor vêm depois de todas as outras (na transição, a mesma instância aparece nos dois grupos).
+    // Cada desenho pela CPU descarta o armazenamento anterior do VBO (orphaning), que as passadas
+    // anteriores ainda podem estar lendo, em vez de esperar a GPU terminar com ele.
+    std::vector<worldgen::InstanceData> m_lodInstances;
+    std::vector<unsigned int> m_lodCounts;
+    unsigned int m_impostorCount = 0;
+    // Áreas de trabalho de bucketByLod, reaproveitadas entre desenhos: o LOD de cada instância, as que
+    // vão para o impostor e a próxima posição livre de cada LOD em m_lodInstances.
+    std::vector<unsigned int> m_instanceLod;
+    std::vector<uint32_t> m_impostorInstances;
+    std::vector<unsigned int> m_lodNext;
 
     /**
-     * @brief Configura o VBO de instâncias e os atributos de vértice no VAO do modelo.
+     * @brief Cria o VBO de instâncias desta vegetação.
      */
     void setupBuffers();
+
+    /**
+     * @brief Escolhe o LOD de cada instância visível e reordena m_lodInstances agrupando-as por LOD.
+     * Uma instância usa o LOD mais simples cujo erro, projetado na tela, fica abaixo de um limite em pixels.
+     * Além da distância de transição, ela vai também (ou apenas) para o grupo do impostor; além de
+     * 'maxDistance', é omitida.
+     */
+    void bucketByLod(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, float maxPixelError, float maxDistance);
+
+    // Desenha os quads do impostor das instâncias distantes (depois da malha, com o shader do impostor).
+    void drawImpostors(const glm::mat4 &view, const glm::mat4 &projection, unsigned int baseInstance);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "AssetLoader.hpp"
+#include "Shader.hpp"
+#include "worldgen/PageCache.hpp"
+#include "worldgen/TextureCompressor.hpp"
+
+/**
+ * @class VirtualTexture
+ * @brief Textura virtual esparsa: só as páginas que a câmera precisa ficam na GPU.
+ *
+ * - Atlas físico: uma textura BC1 com um número fixo de slots, cada um com uma página e a sua borda.
+ * - Tabela de páginas: textura RGBA8UI com um mipmap por nível da textura virtual, que diz ao shader
+ *   em qual slot (e de qual nível) está cada página; páginas ausentes apontam para o ancestral residente.
+ * - Feedback: a cena é desenhada numa resolução baixa com um shader que escreve a página que cada pixel
+ *   usaria; o resultado volta para a CPU de forma assíncrona (PBO + fence) e vira a lista de pedidos.
+ *
+ * As páginas pedidas são compostas e comprimidas nas threads do AssetLoader e enviadas ao atlas na
+ * thread principal, dentro do orçamento de processUploads(). A memória ocupada é a do atlas,
+ * qualquer que seja o tamanho do mundo; páginas vistas há mais tempo são despejadas (LRU).
+ */
+class VirtualTexture
+{
+public:
+    // Gera os texels de uma página (slotSize x slotSize, com a borda). Chamada de várias threads ao mesmo tempo.
+    using PageSource = std::function<worldgen::RgbaImage(worldgen::PageId)>;
+
+    /**
+     * @param layout Tamanho das páginas e da textura virtual.
+     * @param slotsPerSide Slots por lado do atlas físico (no máximo 256).
+     * @param loader Executa a composição das páginas; deve viver enquanto houver páginas pedidas.
+     * @param source Composição de uma página.
+     * @param feedbackWidth Largura do buffer de feedback (a altura acompanha feedbackHeight).
+     */
+    VirtualTexture(const worldgen::VirtualTextureLayout &layout, uint32_t slotsPerSide, AssetLoader &loader, PageSource source,
+                   int feedbackWidth, int feedbackHeight);
+    ~VirtualTexture();
+
+    VirtualTexture(const VirtualTexture &) = delete;
+    VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+    /**
+     * @brief Lê o feedback do frame anterior, se já chegou, e pede as páginas que faltam.
+     * Chamar uma vez por frame, antes de desenhar com a textura.
+     */
+    void update();
+
+    // Os uniformes "vt*" de um programa, resolvidos uma vez (o de feedback só tem parte deles).
+    struct Uniforms
+    {
+        Uniforms() = default;
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<int> atlas;
+        Uniform<int> pageTable;
+        Uniform<float> pagesPerSide;
+        Uniform<float> pageSize;
+        Uniform<float> border;
+        Uniform<float> atlasSize;
+        Uniform<int> maxLevel;
+        Uniform<float> lodBias;
+    };
+
+    /**
+     * @brief Vincula o atlas e a tabela de páginas às unidades dadas e define os uniformes "vt*" do programa ativo.
+     * @param lodBias Somado ao nível calculado no shader (o feedback usa log2 da redução de resolução).
+     */
+    void bind(const Uniforms &uniforms, int atlasUnit, int pageTableUnit, float lodBias = 0.0f);
+
+    /**
+     * @brief Vincula o framebuffer de feedback, o limpa e prepara o shader de feedback; em seguida, desenhar
+     * a cena com ele e chamar endFeedback().
+     * @param uniforms Os uniformes de 'shader'.
+     * @param lodBias -log2 da redução de resolução em relação à tela, para pedir o nível que a tela usaria.
+     * @return false (sem alterar nada) se a leitura anterior ainda não terminou: o desenho pode ser pulado.
+     */
+    bool beginFeedback(Shader &shader, const Uniforms &uniforms, float lodBias);
+    // Inicia a leitura assíncrona do feedback e volta a desenhar na tela.
+    void endFeedback(int screenWidth, int screenHeight);
+
+    size_t residentPages() const { return m_cache.residentCount(); }
+
+private:
+    // Envia uma página comprimida ao atlas, na thread principal.
+    void uploadPage(worldgen::PageId page, const std::vector<uint8_t> &blocks);
+    void uploadPageTable();
+    void processFeedback(const uint32_t *feedback, size_t pixelCount);
+
+    worldgen::VirtualTextureLayout m_layout;
+    worldgen::PageCache m_cache;
+    AssetLoader &m_loader;
+    // Compartilhada com as tarefas ainda em execução.
+    std::shared_ptr<const PageSource> m_source;
+
+    uint64_t m_frame = 0;
+    std::unordered_set<uint32_t> m_inFlight; // Páginas pedidas e ainda não enviadas.
+    bool m_pageTableDirty = true;
+    std::vector<std::vector<worldgen::PageTableEntry>> m_pageTables;
+
+    unsigned int m_atlas = 0;
+    unsigned int m_pageTable = 0;
+
+    int m_feedbackWidth, m_feedbackHeight;
+    unsigned int m_feedbackFBO = 0;
+    unsigned int m_feedbackTexture = 0;
+    unsigned int m_feedbackDepth = 0;
+    unsigned int m_feedbackPBO = 0;
+    GLsync m_feedbackFence = nullptr; // Leitura em andamento, se não for nulo.
+};
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "GeometryArena.hpp"
 #include "Shader.hpp"
 
 /**
@@ -21,9 +22,10 @@ public:
      * @param width A largura da superfície da água.
      * @param depth A profundidade da superfície da água.
      * @param shader A referência ao shader da água (embora não seja diretamente usada nesta classe, é uma boa prática passá-la).
+     * @param geometry A arena onde o plano é alocado.
      */
-    Water(float width, float depth, Shader &shader);
-    ~Water(); // Destrutor para liberar os recursos da GPU.
+    Water(float width, float depth, Shader &shader, GeometryArena &geometry);
+    ~Water(); // Destrutor que devolve a malha à arena.
 
     /**
      * @brief Desenha a malha da superfície da água.
@@ -37,8 +39,9 @@ private:
      */
     void setupMesh();
 
-    // IDs dos objetos OpenGL para a malha.
-    unsigned int VAO, VBO, EBO;
+    // Intervalo da malha nos buffers compartilhados da arena.
+    GeometryArena &m_geometry;
+    MeshRange m_range;
     // Dimensões da malha.
     float m_width, m_depth;
 };
\ No newline at end of file
@@ -29,6 +29,9 @@ public:
     int getReflectionTexture() const { return m_reflectionTexture; }
     int getRefractionTexture() const { return m_refractionTexture; }
     int getRefractionDepthTexture() const { return m_refractionDepthTexture; }
+    // Alturas dos FBOs, em pixels.
+    static int getReflectionHeight() { return REFLECTION_HEIGHT; }
+    static int getRefractionHeight() { return REFRACTION_HEIGHT; }
 
 private:
     // Constantes de Configuração
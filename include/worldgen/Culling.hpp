@@ -0,0 +1,110 @@
+#ifndef WORLDGEN_CULLING_H
+#define WORLDGEN_CULLING_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Placement.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct Aabb
+     * @brief Caixa alinhada aos eixos. Uma caixa vazia (min > max) representa limites desconhecidos.
+     */
+    struct Aabb
+    {
+        glm::vec3 min = glm::vec3(1e30f);
+        glm::vec3 max = glm::vec3(-1e30f);
+
+        bool empty() const { return min.x > max.x; }
+        void expand(const glm::vec3 &point);
+        void expand(const Aabb &other);
+        // Caixa que contém esta caixa depois de transformada por 'matrix'.
+        Aabb transformed(const glm::mat4 &matrix) const;
+        // Distância de 'point' ao ponto mais próximo da caixa (0 dentro dela ou se ela for vazia).
+        float distanceTo(const glm::vec3 &point) const;
+    };
+
+    /**
+     * @struct Frustum
+     * @brief Os 6 planos de uma matriz projection * view e, opcionalmente, o plano de corte
+     * da água (gl_ClipDistance), todos com a normal apontando para dentro.
+     */
+    struct Frustum
+    {
+        glm::vec4 planes[7];
+        int planeCount = 0;
+
+        /**
+         * @param viewProjection projection * view da passada.
+         * @param clipPlane O plano de corte usado pelos shaders; vec4(0) (sem corte) é ignorado.
+         */
+        static Frustum fromMatrix(const glm::mat4 &viewProjection, const glm::vec4 &clipPlane = glm::vec4(0.0f));
+
+        // Falso apenas se a caixa estiver inteiramente fora de algum plano (uma caixa vazia é sempre visível).
+        bool intersects(const Aabb &box) const;
+    };
+
+    // Intervalo contíguo de instâncias, pronto para um desenho com baseInstance.
+    struct InstanceRange
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Instâncias enviadas e descartadas, somadas ao longo de uma passada. As testadas na GPU não são
+    // lidas de volta: entram apenas em 'gpuTested'.
+    struct CullStats
+    {
+        uint64_t submitted = 0;
+        uint64_t culled = 0;
+        uint64_t gpuTested = 0;
+        uint64_t draws = 0;
+    };
+
+    /**
+     * @class InstanceGrid
+     * @brief Agrupa instâncias em células quadradas alinhadas ao terreno (no plano XZ), cada uma com
+     * a caixa que contém o modelo em todas as suas instâncias.
+     *
+     * O construtor reordena as instâncias por célula, de modo que cada célula seja um intervalo
+     * contíguo; as células ficam em ordem de linha, e células vizinhas visíveis formam um único
+     * intervalo. As caixas ficam em arrays separados por componente (SoA), testadas contra o
+     * frustum em lotes de 4 com SSE quando disponível.
+     */
+    class InstanceGrid
+    {
+    public:
+        InstanceGrid() = default;
+
+        /**
+         * @param instances Reordenadas por célula; enviar à GPU nesta nova ordem.
+         * @param modelBounds Caixa do modelo em unidades do modelo. Se estiver vazia (desconhecida),
+         * nenhuma célula é descartada.
+         * @param cellSize Lado de uma célula, em unidades do mundo.
+         */
+        InstanceGrid(std::vector<InstanceData> &instances, const Aabb &modelBounds, float cellSize);
+
+        /**
+         * @brief Testa as células contra o frustum e devolve os intervalos de instâncias visíveis.
+         * @param stats Se não for nulo, recebe as instâncias enviadas e descartadas (o número de
+         * desenhos fica a cargo de quem desenha).
+         */
+        void cull(const Frustum &frustum, std::vector<InstanceRange> &visible, CullStats *stats = nullptr) const;
+
+        size_t cellCount() const { return m_cellFirst.size(); }
+        uint32_t instanceCount() const { return m_instanceCount; }
+
+    private:
+        std::vector<uint32_t> m_cellFirst;
+        std::vector<uint32_t> m_cellCount;
+        // Caixas das células (SoA), com preenchimento até um múltiplo de 4.
+        std::vector<float> m_minX, m_minY, m_minZ;
+        std::vector<float> m_maxX, m_maxY, m_maxZ;
+        uint32_t m_instanceCount = 0;
+        bool m_unbounded = false;
+    };
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef WORLDGEN_GLBLOADER_H
+#define WORLDGEN_GLBLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Culling.hpp"
+#include "worldgen/MappedFile.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct GlbBufferView
+     * @brief Trecho contíguo do chunk binário de um .glb.
+     */
+    struct GlbBufferView
+    {
+        uint32_t byteOffset = 0; // Relativo ao início do chunk binário.
+        uint32_t byteLength = 0;
+        uint32_t byteStride = 0; // 0 = elementos contíguos (sem intercalação).
+    };
+
+    /**
+     * @struct GlbAccessor
+     * @brief Descrição de um atributo (ou dos índices) dentro de um bufferView.
+     * 'componentType' usa os mesmos valores dos enums do OpenGL (GL_FLOAT = 5126, GL_UNSIGNED_SHORT = 5123, ...),
+     * então pode ser passado diretamente a glVertexAttribFormat.
+     */
+    struct GlbAccessor
+    {
+        int bufferView = -1; // -1 = atributo ausente.
+        uint32_t byteOffset = 0; // Relativo ao início do bufferView.
+        uint32_t componentType = 0;
+        uint32_t componentCount = 0; // 1 (SCALAR) a 4 (VEC4).
+        bool normalized = false;
+        uint32_t count = 0;
+
+        bool present() const { return bufferView >= 0; }
+        // Tamanho de um elemento em bytes.
+        uint32_t elementSize() const;
+    };
+
+    /**
+     * @struct GlbMesh
+     * @brief Primeira primitiva da primeira malha de um .glb, sem nenhum processamento por vértice.
+     *
+     * Os dados continuam no arquivo mapeado: os accessors apenas descrevem onde estão e em que
+     * formato, para que sejam enviados à GPU como estão (inclusive atributos quantizados,
+     * extensão KHR_mesh_quantization).
+     */
+    struct GlbMesh
+    {
+        MappedFile file;
+        const unsigned char *binary = nullptr; // Chunk BIN do arquivo.
+        size_t binarySize = 0;
+        std::vector<GlbBufferView> bufferViews;
+
+        GlbAccessor position;
+        GlbAccessor normal;   // Opcional.
+        GlbAccessor texCoord; // Opcional (TEXCOORD_0).
+        GlbAccessor indices;
+
+        // Transformação do nó que usa a malha (escala e translação), que também desfaz a quantização
+        // das posições: posição = atributo * positionScale + positionOffset.
+        glm::vec3 positionScale = glm::vec3(1.0f);
+        glm::vec3 positionOffset = glm::vec3(0.0f);
+        // Caixa das posições, já transformada pelo nó, lida do min/max do accessor (vazia se ausentes).
+        Aabb bounds;
+
+        // Ponteiro para o início dos dados de um accessor no arquivo mapeado.
+        const unsigned char *data(const GlbAccessor &accessor) const;
+    };
+
+    /**
+     * @brief Mapeia um .glb (glTF 2.0 binário) e lê a descrição da sua primeira primitiva.
+     * Apenas o JSON é analisado; os vértices e índices não são copiados nem convertidos.
+     * Lança std::runtime_error se o arquivo não existir, for inválido ou usar recursos não suportados
+     * (buffers externos, accessors esparsos, primitivas que não sejam triângulos indexados,
+     * extensões obrigatórias além de KHR_mesh_quantization).
+     */
+    GlbMesh loadGlb(const std::string &path);
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef WORLDGEN_GRASS_TILES_H
+#define WORLDGEN_GRASS_TILES_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Culling.hpp"
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/Placement.hpp"
+#include "worldgen/Random.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct GrassCoverage
+     * @brief Onde a grama cresce: em altitudes médias, evitando praias e picos de montanhas, e onde um
+     * ruído de baixa frequência passa de um limiar, formando aglomerados e clareiras.
+     */
+    struct GrassCoverage
+    {
+        float terrainAmplitude = 50.0f; // Deve ser o mesmo valor usado na geração do terreno.
+        float minHeight = 0.4f;         // Faixa da altura normalizada, (altura / amplitude + 1) / 2.
+        float maxHeight = 0.7f;
+        // Valores maiores criam aglomerados menores e mais detalhados; menores, grandes clareiras.
+        float noiseFrequency = 0.01f;
+        float noiseThreshold = 0.2f; // O ruído fica em [-1, 1]: a grama só cresce acima do limiar.
+
+        // Ruído de cobertura num ponto do mundo.
+        float noise(float worldX, float worldZ) const;
+        bool inHeightBand(float height) const;
+    };
+
+    /**
+     * @struct GrassStreamingParams
+     * @brief Ladrilhos de grama em anéis quadrados em volta do ladrilho da câmera.
+     *
+     * Perto da câmera os tufos ficam a 'spacing' uns dos outros; depois de 'fullDensityRings' anéis,
+     * a densidade cai pela metade a cada 'falloffRings' anéis. Cada ladrilho cabe num buffer de
+     * tamanho fixo (tileCapacity), e o número de ladrilhos não depende do tamanho do terreno.
+     *
+     * A cobertura (GrassCoverage) aproveita só ~12% das posições possíveis do terreno padrão (512x512):
+     * os valores padrão mantêm em média ~12 mil tufos só nos ladrilhos de densidade máxima (até ~100 mil
+     * no total), num pool de ~18 MB.
+     */
+    struct GrassStreamingParams
+    {
+        float tileSize = 16.0f;       // Lado de um ladrilho, em unidades do mundo.
+        int radius = 5;               // Anéis em volta do ladrilho da câmera.
+        float spacing = 0.25f;        // Espaçamento entre tufos na densidade máxima.
+        int fullDensityRings = 3;     // Anéis com a densidade máxima (o da câmera incluído).
+        int falloffRings = 2;         // Anéis por redução da densidade pela metade, depois deles.
+        uint32_t stream = 0;          // Sequência do gerador (ver counterRandom).
+        uint64_t seed = DEFAULT_SEED; // Semente do mundo.
+        GrassCoverage coverage;
+
+        // Lado da grade de posições possíveis de um ladrilho.
+        int candidatesPerSide() const { return static_cast<int>(tileSize / spacing); }
+        // Tufos de um ladrilho na densidade máxima: a capacidade do buffer de cada ladrilho.
+        uint32_t tileCapacity() const { return static_cast<uint32_t>(candidatesPerSide() * candidatesPerSide()); }
+        // Ladrilhos carregados ao mesmo tempo, no máximo.
+        uint32_t tileCount() const { return static_cast<uint32_t>((2 * radius + 1) * (2 * radius + 1)); }
+        // Nível de densidade do anel 'ring' (0 = máxima; cada nível tem metade dos tufos do anterior).
+        int densityLevel(int ring) const;
+    };
+
+    // Um ladrilho da grade do mundo e o nível de densidade com que ele é gerado.
+    struct GrassTileKey
+    {
+        int x = 0;
+        int z = 0;
+        int level = 0;
+
+        bool sameTile(const GrassTileKey &other) const { return x == other.x && z == other.z; }
+        bool operator==(const GrassTileKey &other) const { return sameTile(other) && level == other.level; }
+        bool operator!=(const GrassTileKey &other) const { return !(*this == other); }
+    };
+
+    // Os tufos de um ladrilho e a caixa que os contém.
+    struct GrassTile
+    {
+        GrassTileKey key;
+        std::vector<InstanceData> instances;
+        Aabb bounds;
+    };
+
+    /**
+     * @brief Ladrilhos que devem estar carregados com a câmera em 'cameraPos', do mais próximo ao
+     * mais distante, cada um com o nível de densidade do seu anel. Ladrilhos fora do terreno são omitidos.
+     */
+    std::vector<GrassTileKey> desiredGrassTiles(const Heightfield &heightfield, const glm::vec3 &cameraPos, const GrassStreamingParams &params);
+
+    /**
+     * @brief Gera os tufos de grama de um ladrilho.
+     * Cada posição possível tem o seu próprio bloco aleatório (counterRandom, com o ladrilho como
+     * célula e a posição como índice), que decide o deslocamento, a largura e se ela sobrevive ao
+     * nível de densidade: o mesmo ladrilho sempre gera os mesmos tufos, e os tufos de um nível são
+     * um subconjunto dos tufos de um nível mais denso. Pode rodar em qualquer thread.
+     * @param modelBounds Caixa do modelo da grama, para a caixa do ladrilho (vazia = desconhecida).
+     * @param layerCount Número de variantes de textura, sorteadas como em assignVariants.
+     */
+    GrassTile placeGrassTile(const Heightfield &heightfield, const GrassTileKey &key, const GrassStreamingParams &params,
+                             const Aabb &modelBounds, uint32_t layerCount);
+
+    /**
+     * @brief Altura do terreno e ruído de cobertura em cada ponto da grade, dois floats por ponto, linha
+     * a linha (z * width + x): o mapa que a grama procedural lê no vertex shader.
+     */
+    std::vector<float> buildGrassMap(const Heightfield &heightfield, const GrassCoverage &coverage);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef WORLDGEN_HASH_H
+#define WORLDGEN_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace worldgen
+{
+    /**
+     * @brief Hash de 64 bits de um bloco de memória (FNV-1a processando 8 bytes por passo).
+     * Não é criptográfico; serve para detectar arquivos alterados ou corrompidos em caches.
+     */
+    inline uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 14695981039346656037ull)
+    {
+        const uint64_t prime = 1099511628211ull;
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        uint64_t hash = seed;
+
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 32;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ bytes[i]) * prime;
+        return hash;
+    }
+}
+
+#endif
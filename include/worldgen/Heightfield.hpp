@@ -0,0 +1,64 @@
+#ifndef WORLDGEN_HEIGHTFIELD_H
+#define WORLDGEN_HEIGHTFIELD_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace worldgen
+{
+    /**
+     * @struct Heightfield
+     * @brief Grade de alturas e normais do terreno, gerada inteiramente na CPU.
+     *
+     * Não depende de nenhum contexto OpenGL, o que permite gerá-la em threads de trabalho,
+     * ferramentas e benchmarks sem janela.
+     */
+    struct Heightfield
+    {
+        int width = 0;
+        int depth = 0;
+        std::vector<float> heights;     // width * depth alturas, linha a linha (z * width + x).
+        std::vector<glm::vec3> normals; // Normal de cada ponto da grade, no mesmo layout.
+
+        // Altura em um ponto da grade, com as coordenadas limitadas às bordas.
+        float getHeight(int x, int z) const;
+        // Normal em um ponto da grade, com as coordenadas limitadas às bordas.
+        glm::vec3 getNormal(int x, int z) const;
+        // Altura entre os pontos da grade, interpolada bilinearmente (coordenadas da grade, não do mundo).
+        float getInterpolatedHeight(float x, float z) const;
+    };
+
+    /**
+     * @struct TerrainMesh
+     * @brief Geometria do terreno pronta para envio à GPU.
+     * Os vértices são intercalados como Posição(3) + Normal(3) + TexCoord(2).
+     */
+    struct TerrainMesh
+    {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    /**
+     * @brief Uma oitava de Ruído de Perlin, em [-1, 1]. A implementação da biblioteca fica numa única
+     * unidade de tradução (Heightfield.cpp); os outros módulos da libworldgen usam esta função.
+     */
+    float perlinNoise(float x, float z);
+
+    /**
+     * @brief Calcula a altura procedural usando múltiplas oitavas de Ruído de Perlin.
+     */
+    float sampleHeight(float x, float z);
+
+    /**
+     * @brief Gera a grade de alturas e normais de um terreno width x depth.
+     */
+    Heightfield generateHeightfield(int width, int depth);
+
+    /**
+     * @brief Monta os vértices e índices da malha a partir da grade de alturas.
+     */
+    TerrainMesh buildTerrainMesh(const Heightfield &heightfield);
+}
+
+#endif
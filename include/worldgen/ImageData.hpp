@@ -0,0 +1,37 @@
+#ifndef WORLDGEN_IMAGEDATA_H
+#define WORLDGEN_IMAGEDATA_H
+
+#include <memory>
+#include <string>
+
+namespace worldgen
+{
+    // Libera a memória alocada pelo stb_image.
+    struct ImageDeleter
+    {
+        void operator()(unsigned char *data) const;
+    };
+
+    /**
+     * @struct ImageData
+     * @brief Imagem decodificada na CPU, pronta para ser enviada a uma textura.
+     * Os pixels são liberados automaticamente quando a estrutura sai de escopo.
+     */
+    struct ImageData
+    {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<unsigned char, ImageDeleter> pixels;
+
+        explicit operator bool() const { return pixels != nullptr; }
+    };
+
+    /**
+     * @brief Decodifica um arquivo de imagem (png, jpg, ...).
+     * Em caso de falha, retorna uma ImageData vazia (avaliada como false).
+     */
+    ImageData loadImage(const std::string &path);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef WORLDGEN_JSON_H
+#define WORLDGEN_JSON_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace worldgen
+{
+    /**
+     * @class JsonValue
+     * @brief Valor JSON (DOM mínimo), suficiente para ler o cabeçalho de arquivos glTF.
+     *
+     * O acesso é tolerante: pedir uma chave ou posição inexistente devolve um valor nulo,
+     * e os conversores recebem um valor padrão para quando o tipo não bate.
+     */
+    class JsonValue
+    {
+    public:
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        Type type() const { return m_type; }
+        bool isNull() const { return m_type == Type::Null; }
+        bool isArray() const { return m_type == Type::Array; }
+        bool isObject() const { return m_type == Type::Object; }
+
+        double asNumber(double fallback = 0.0) const { return m_type == Type::Number ? m_number : fallback; }
+        bool asBool(bool fallback = false) const { return m_type == Type::Bool ? m_bool : fallback; }
+        const std::string &asString() const { return m_string; }
+
+        // Número de elementos (array) ou de membros (objeto).
+        size_t size() const { return m_items.size(); }
+        const JsonValue &operator[](size_t index) const;
+        const JsonValue &operator[](const std::string &key) const;
+        // Verdadeiro se o objeto tem a chave com um valor não nulo.
+        bool has(const std::string &key) const;
+
+    private:
+        friend class JsonParser;
+
+        Type m_type = Type::Null;
+        bool m_bool = false;
+        double m_number = 0.0;
+        std::string m_string;
+        std::vector<std::string> m_keys; // Chaves dos membros (apenas em objetos), na mesma ordem de m_items.
+        std::vector<JsonValue> m_items;  // Elementos do array ou valores dos membros do objeto.
+    };
+
+    /**
+     * @brief Analisa um documento JSON (UTF-8).
+     * Lança std::runtime_error, com a posição do erro, se o texto for inválido.
+     */
+    JsonValue parseJson(const char *begin, const char *end);
+}
+
+#endif
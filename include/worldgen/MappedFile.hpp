@@ -0,0 +1,61 @@
+#ifndef WORLDGEN_MAPPEDFILE_H
+#define WORLDGEN_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace worldgen
+{
+    /**
+     * @class MappedFile
+     * @brief Mapeia um arquivo inteiro na memória, apenas para leitura (mmap).
+     *
+     * Evita copiar o conteúdo do arquivo para buffers intermediários: os dados são lidos
+     * diretamente das páginas do cache do sistema. O mapeamento é desfeito no destrutor.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        // Tenta mapear o arquivo; use isOpen() para verificar o resultado.
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool isOpen() const { return m_data != nullptr; }
+        const unsigned char *data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        void close();
+
+        const unsigned char *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    /**
+     * @struct FileStamp
+     * @brief Tamanho e data de modificação de um arquivo, usados para validar caches.
+     */
+    struct FileStamp
+    {
+        uint64_t size = 0;
+        uint64_t mtimeNs = 0; // Data de modificação em nanossegundos.
+        bool exists = false;
+    };
+
+    FileStamp statFile(const std::string &path);
+
+    /**
+     * @brief Sobrescreve 'size' bytes de um arquivo existente a partir de 'offset', sem truncá-lo.
+     * @return false se o arquivo não puder ser aberto para escrita ou se a escrita falhar.
+     */
+    bool overwriteFileBytes(const std::string &path, uint64_t offset, const void *data, size_t size);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef WORLDGEN_MESHCACHE_H
+#define WORLDGEN_MESHCACHE_H
+
+#include <cstddef>
+#include <string>
+#include "worldgen/MappedFile.hpp"
+#include "worldgen/MeshData.hpp"
+#include "worldgen/MeshOptimizer.hpp"
+#include "worldgen/MeshSimplifier.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct MeshView
+     * @brief Visão somente leitura de uma malha indexada, sem posse dos dados.
+     * Pode apontar tanto para vetores na memória quanto para um arquivo mapeado.
+     */
+    struct MeshView
+    {
+        const Vertex *vertices = nullptr;
+        size_t vertexCount = 0;
+        const unsigned int *indices = nullptr;
+        size_t indexCount = 0;   // Total, somando todos os LODs.
+        const MeshLod *lods = nullptr;
+        size_t lodCount = 0;     // Ao menos 1: o LOD 0 é a malha completa.
+    };
+
+    /**
+     * @class CachedMesh
+     * @brief Resultado de loadMeshCached: a malha vem do cache binário mapeado (sem cópias)
+     * ou, na primeira carga, dos vetores produzidos pelo parser de .obj.
+     */
+    class CachedMesh
+    {
+    public:
+        MeshView view() const;
+        // Verdadeiro se os dados vêm do arquivo de cache mapeado.
+        bool fromCache() const { return m_file.isOpen(); }
+        // ACMR/ATVR antes e depois da otimização feita ao gerar o cache.
+        const MeshOptimizationReport &report() const { return m_report; }
+
+    private:
+        friend CachedMesh loadMeshCached(const std::string &objPath);
+
+        MappedFile m_file;  // Cache mapeado (quando válido).
+        MeshData m_mesh;    // Malha recém-analisada (quando o cache não existia ou estava inválido).
+        MeshView m_view;    // Visão sobre o arquivo mapeado.
+        std::vector<MeshLod> m_lods; // LODs gerados junto com m_mesh.
+        MeshOptimizationReport m_report;
+    };
+
+    // Caminho do cache binário gravado ao lado do .obj.
+    std::string meshCachePath(const std::string &objPath);
+
+    /**
+     * @brief Grava a malha já sem vértices duplicados em um arquivo binário compacto.
+     * O cabeçalho guarda o tamanho, a data de modificação e o hash do .obj de origem,
+     * além da tabela de LODs e das estatísticas da otimização aplicada à malha.
+     * @return false se o arquivo não puder ser gravado (ex: diretório somente leitura).
+     */
+    bool saveMeshCache(const std::string &cachePath, const MeshData &mesh, const std::vector<MeshLod> &lods,
+                       const FileStamp &source, uint64_t sourceHash, const MeshOptimizationReport &report);
+
+    /**
+     * @brief Carrega um .obj usando o cache binário sempre que ele for válido.
+     * O cache é aceito se o tamanho do .obj bater e se a data de modificação ou o hash do
+     * conteúdo também baterem. Caso contrário, o .obj é analisado, otimizado (optimizeMesh),
+     * ganha uma cadeia de LODs (buildLodChain) e o cache é regravado.
+     * Lança std::runtime_error se o .obj não puder ser lido.
+     */
+    CachedMesh loadMeshCached(const std::string &objPath);
+}
+
+#endif
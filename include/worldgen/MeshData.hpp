@@ -0,0 +1,45 @@
+#ifndef WORLDGEN_MESHDATA_H
+#define WORLDGEN_MESHDATA_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @struct Vertex
+ * @brief Estrutura que encapsula todos os atributos de um único vértice.
+ * Combina posição, normal e coordenadas de textura em uma única unidade de dados,
+ * facilitando o gerenciamento e o envio para a GPU.
+ */
+struct Vertex
+{
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+
+    bool operator==(const Vertex &other) const
+    {
+        return Position == other.Position && Normal == other.Normal && TexCoords == other.TexCoords;
+    }
+};
+
+namespace worldgen
+{
+    /**
+     * @struct MeshData
+     * @brief Malha indexada na CPU: vértices únicos e a ordem de desenho dos triângulos.
+     */
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    /**
+     * @brief Carrega a geometria de um arquivo .obj, removendo vértices duplicados.
+     * Lança std::runtime_error se o arquivo não puder ser lido.
+     */
+    MeshData loadObj(const std::string &path);
+}
+
+#endif
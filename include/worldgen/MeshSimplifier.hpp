@@ -0,0 +1,46 @@
+#ifndef WORLDGEN_MESHSIMPLIFIER_H
+#define WORLDGEN_MESHSIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "worldgen/MeshData.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct MeshLod
+     * @brief Um nível de detalhe: um intervalo do index buffer que referencia o vertex buffer
+     * compartilhado por todos os níveis. O nível 0 é sempre a malha completa.
+     */
+    struct MeshLod
+    {
+        uint32_t indexOffset = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f; // Maior desvio geométrico em relação à malha completa, em unidades do modelo.
+        uint32_t reserved = 0;
+    };
+
+    /**
+     * @brief Simplifica uma malha por colapso de arestas guiado por quádricas de erro (Garland-Heckbert).
+     * Cada colapso move um vértice para a posição de um vizinho, de modo que o resultado continua
+     * usando o vertex buffer original. Bordas abertas e costuras de UV/normal (vértices na mesma
+     * posição com atributos diferentes) só colapsam ao longo de si mesmas; cantos nunca se movem.
+     * @param targetIndexCount Número de índices desejado.
+     * @param targetError Erro máximo permitido, relativo à maior dimensão da malha.
+     * @param resultError Se não for nulo, recebe o maior desvio medido entre os vértices da entrada e o resultado (também relativo).
+     * @return Os índices da malha simplificada.
+     */
+    std::vector<unsigned int> simplifyMesh(const std::vector<Vertex> &vertices, const unsigned int *indices, size_t indexCount,
+                                           size_t targetIndexCount, float targetError, float *resultError = nullptr);
+
+    /**
+     * @brief Gera a cadeia de LODs de uma malha, cada nível com cerca de metade dos triângulos do anterior.
+     * Os índices dos níveis simplificados são acrescentados ao final de mesh.indices.
+     * A cadeia para antes se o erro ficar grande demais ou se a malha não puder mais ser reduzida.
+     * @return Os níveis gerados; o primeiro é a malha original.
+     */
+    std::vector<MeshLod> buildLodChain(MeshData &mesh);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef WORLDGEN_OBJPARSER_H
+#define WORLDGEN_OBJPARSER_H
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace worldgen
+{
+    /// Marca uma normal ou coordenada de textura ausente no canto; nenhum índice resolvido assume este valor.
+    constexpr int OBJ_INDEX_ABSENT = std::numeric_limits<int>::min();
+
+    /**
+     * @struct ObjIndex
+     * @brief Trinca de índices (base zero) de um canto de face no .obj; OBJ_INDEX_ABSENT indica atributo ausente.
+     */
+    struct ObjIndex
+    {
+        int vertex;
+        int normal;
+        int texcoord;
+    };
+
+    /**
+     * @struct ObjGeometry
+     * @brief Atributos brutos de um .obj e os cantos das faces já trianguladas, na ordem do arquivo.
+     */
+    struct ObjGeometry
+    {
+        std::vector<float> positions; // x, y, z por vértice.
+        std::vector<float> normals;   // x, y, z por normal.
+        std::vector<float> texcoords; // u, v por coordenada de textura.
+        std::vector<ObjIndex> indices; // Três cantos por triângulo.
+    };
+
+    /**
+     * @brief Lê um .obj em paralelo: o arquivo é mapeado na memória, dividido em blocos nos
+     * limites de linha e cada bloco é analisado por uma thread.
+     *
+     * Apenas a geometria (v, vt, vn, f) é lida; grupos, materiais e suavização são ignorados.
+     * A junção dos blocos é determinística e a triangulação reproduz a do tinyobj, de modo que
+     * a ordem dos vértices e índices é a mesma da leitura sequencial.
+     *
+     * @param threadCount Número de threads; 0 usa std::thread::hardware_concurrency().
+     * @return false se o arquivo não puder ser lido ou tiver uma linha de face inválida.
+     * Lança std::runtime_error se uma face referenciar um atributo que não existe (ver validateObjIndices).
+     */
+    bool parseObjParallel(const std::string &path, ObjGeometry &out, unsigned int threadCount = 0);
+
+    /**
+     * @brief Verifica que todos os cantos referenciam posições, normais e coordenadas de textura existentes.
+     * Só OBJ_INDEX_ABSENT conta como ausente: um índice relativo que resolve para -1 está fora do intervalo.
+     * Lança std::runtime_error, citando 'path', no primeiro índice fora do intervalo.
+     */
+    void validateObjIndices(const ObjGeometry &geometry, const std::string &path);
+}
+
+#endif
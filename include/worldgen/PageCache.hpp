@@ -0,0 +1,124 @@
+#ifndef WORLDGEN_PAGECACHE_H
+#define WORLDGEN_PAGECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace worldgen
+{
+    /**
+     * @struct VirtualTextureLayout
+     * @brief Geometria de uma textura virtual: uma pirâmide de mipmaps dividida em páginas quadradas.
+     * No nível 0 há pagesPerSide x pagesPerSide páginas; cada nível acima tem metade por lado, até 1.
+     * Na memória física cada página ocupa um "slot" com 'border' texels extras de cada lado, para que
+     * a filtragem bilinear não leia a página vizinha do atlas.
+     */
+    struct VirtualTextureLayout
+    {
+        uint32_t pageSize = 128;    // Texels úteis por lado de página.
+        uint32_t border = 4;        // Texels de borda de cada lado (múltiplo de 4 para a compressão em blocos).
+        uint32_t pagesPerSide = 64; // Páginas por lado no nível 0 (potência de 2).
+
+        uint32_t levelCount() const;
+        uint32_t pagesAt(uint32_t level) const { return pagesPerSide >> level > 0 ? pagesPerSide >> level : 1; }
+        uint32_t slotSize() const { return pageSize + 2 * border; }
+        // Texels por lado no nível 0.
+        uint32_t virtualSize() const { return pageSize * pagesPerSide; }
+    };
+
+    /**
+     * @struct PageId
+     * @brief Uma página da textura virtual. Compactada em 32 bits (4 de nível e 14 para cada coordenada),
+     * que é também o valor escrito pelo shader de feedback.
+     */
+    struct PageId
+    {
+        uint32_t level = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+
+        uint32_t pack() const { return level << 28 | y << 14 | x; }
+        static PageId unpack(uint32_t packed) { return {packed >> 28, packed & 0x3FFF, (packed >> 14) & 0x3FFF}; }
+        // A página do nível de cima que contém esta.
+        PageId parent() const { return {level + 1, x / 2, y / 2}; }
+    };
+
+    // Valor de feedback para pixels que não mostram a textura virtual.
+    const uint32_t NO_PAGE = 0xFFFFFFFFu;
+
+    /**
+     * @struct PageTableEntry
+     * @brief Entrada da tabela de páginas, no layout RGBA8UI lido pelo shader: o slot físico e o nível
+     * da página que de fato está lá (a própria ou o ancestral residente mais próximo).
+     */
+    struct PageTableEntry
+    {
+        uint8_t slotX;
+        uint8_t slotY;
+        uint8_t level;
+        uint8_t valid;
+    };
+    static_assert(sizeof(PageTableEntry) == 4, "PageTableEntry deve ter 4 bytes");
+
+    /**
+     * @class PageCache
+     * @brief Residência das páginas no atlas físico, com despejo da página usada há mais tempo (LRU).
+     *
+     * O atlas tem um número fixo de slots, então a memória ocupada não depende do tamanho do mundo.
+     * Páginas fixadas (pin) nunca são despejadas; a página do último nível cobre a textura inteira e,
+     * fixada, garante que toda consulta à tabela de páginas encontre algum ancestral residente.
+     */
+    class PageCache
+    {
+    public:
+        // slotsPerSide no máximo 256 (as coordenadas do slot vão em 8 bits na tabela de páginas).
+        PageCache(const VirtualTextureLayout &layout, uint32_t slotsPerSide);
+
+        const VirtualTextureLayout &layout() const { return m_layout; }
+        uint32_t slotsPerSide() const { return m_slotsPerSide; }
+        size_t capacity() const { return m_slotOwners.size(); }
+        size_t residentCount() const { return m_pages.size(); }
+
+        bool isResident(PageId page) const { return m_pages.count(page.pack()) > 0; }
+
+        // Registra que a página foi vista no feedback do frame 'frame' (se for residente).
+        void touch(PageId page, uint64_t frame);
+
+        /**
+         * @brief Reserva um slot para a página, despejando a menos usada entre as que não foram vistas
+         * desde 'frame' - 1 (as do frame atual podem estar na tela).
+         * @return false se todos os slots estiverem em uso recente; a página fica para um próximo pedido.
+         */
+        bool insert(PageId page, uint64_t frame, uint32_t &slot, bool pinned = false);
+
+        /**
+         * @brief Monta a tabela de páginas de todos os níveis, do último para o nível 0: uma página
+         * ausente herda a entrada da página de cima. tables[level] tem pagesAt(level)^2 entradas.
+         */
+        void buildPageTable(std::vector<std::vector<PageTableEntry>> &tables) const;
+
+    private:
+        struct Residency
+        {
+            uint32_t slot;
+            uint64_t lastUsed;
+            bool pinned;
+        };
+
+        VirtualTextureLayout m_layout;
+        uint32_t m_slotsPerSide;
+        std::unordered_map<uint32_t, Residency> m_pages; // Chave: PageId::pack().
+        std::vector<uint32_t> m_slotOwners;              // Página de cada slot, ou NO_PAGE.
+    };
+
+    /**
+     * @brief Converte o buffer de feedback (um PageId compactado por pixel) na lista de páginas pedidas,
+     * sem repetições e já incluindo os ancestrais de cada uma, de modo que a imagem melhore aos poucos.
+     * A ordem é de prioridade: níveis mais grossos primeiro e, dentro do nível, as páginas vistas em mais pixels.
+     */
+    std::vector<PageId> collectPageRequests(const uint32_t *feedback, size_t pixelCount, const VirtualTextureLayout &layout);
+}
+
+#endif
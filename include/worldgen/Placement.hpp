@@ -0,0 +1,114 @@
+#ifndef WORLDGEN_PLACEMENT_H
+#define WORLDGEN_PLACEMENT_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/PlacementIndex.hpp"
+#include "worldgen/Random.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct VegetationParams
+     * @brief Parâmetros de distribuição de um tipo de vegetação sobre o terreno.
+     */
+    struct VegetationParams
+    {
+        int count;        // Número desejado de instâncias.
+        float minHeight;  // Altura mínima no terreno para posicionar uma instância.
+        float maxHeight;  // Altura máxima no terreno para posicionar uma instância.
+        float scale;      // Escala aplicada a cada instância.
+        glm::vec3 modelUp = glm::vec3(0.0f, 1.0f, 0.0f); // Direção "para cima" no modelo original.
+        uint32_t stream = 1;          // Sequência do gerador (ver counterRandom); diferente para cada tipo de vegetação.
+        uint64_t seed = DEFAULT_SEED; // Semente do mundo.
+        float footprint = 1.0f;       // Raio livre em volta de cada instância, que as outras vegetações respeitam.
+        float maxSlope = 1.0f;        // Inclinação máxima do terreno, 1 - normal.y.
+        uint32_t biomes = ALL_BIOMES; // Biomas onde a vegetação cresce (máscara de biomeBit()).
+
+        PlacementFilter filter() const { return {minHeight, maxHeight, maxSlope, biomes}; }
+    };
+
+    /**
+     * @struct VegetationPlacement
+     * @brief As instâncias de uma vegetação e quantas o terreno comporta.
+     */
+    struct VegetationPlacement
+    {
+        // Exatamente min(count, capacity) matrizes.
+        std::vector<glm::mat4> transforms;
+        // O máximo de instâncias que a vegetação pode ter, no espaço que as vegetações distribuídas antes dela
+        // deixaram: os pontos da grade do filtro a mais de 'footprint' das instâncias delas ou, se o espaço
+        // livre estiver fragmentado, o que a amostragem mais densa alcança.
+        size_t capacity = 0;
+    };
+
+    /**
+     * @struct InstanceData
+     * @brief Dados de uma instância como a GPU os lê: posição (atributo 3), escala (atributo 4), rotação
+     * (atributo 5) e a camada da textura array com a variante da instância (atributo 6).
+     *
+     * Em vez da matriz inteira (64 bytes), a instância guarda só o que as matrizes da libworldgen têm:
+     * translação, rotação e escala igual nos eixos x e z do modelo (a grama é mais alta do que larga).
+     * O vertex shader remonta a transformação com um quatérnio, e a normal só precisa dividir pela escala,
+     * sem a inversa de uma mat4 por vértice.
+     */
+    struct InstanceData
+    {
+        glm::vec3 position;
+        uint32_t layer;
+        glm::vec2 scale;      // Escala nos eixos x e z do modelo (x) e no eixo y (y).
+        int16_t rotation[4];  // Quatérnio (x, y, z, w) normalizado em 16 bits com sinal (snorm16).
+
+        /**
+         * @brief Decompõe uma matriz de translação, rotação e escala (x e z iguais) na forma compacta.
+         */
+        static InstanceData fromMatrix(const glm::mat4 &transform, uint32_t layer);
+
+        // Remonta a matriz de modelo da instância.
+        glm::mat4 matrix() const;
+        // Maior escala da instância, usada para converter distâncias do modelo para o mundo.
+        float maxScale() const { return glm::max(scale.x, scale.y); }
+    };
+    static_assert(sizeof(InstanceData) == 32, "InstanceData deve ter 32 bytes, sem preenchimento");
+
+    /**
+     * @brief Gera as matrizes de instância de várias vegetações alinhadas à normal do terreno, juntas.
+     *
+     * As posições vêm de samplePoissonDisk, com um único SpatialHash para todas as camadas: instâncias
+     * do mesmo tipo ficam a um espaçamento mínimo umas das outras, derivado de 'count' e da área dentro
+     * do filtro, e instâncias de tipos diferentes a pelo menos o maior dos dois 'footprint'.
+     * As vegetações são distribuídas uma por vez, da mais esparsa (count pela área do filtro) à mais densa,
+     * cada uma no espaço que as anteriores deixaram livre. As sementes são sorteadas entre os pontos de
+     * 'index' que passam no filtro, sem tentativas perdidas fora dele; um mapa dos pontos ocupados pelas
+     * vegetações anteriores descarta as que caem neles. A amostragem gera um pouco mais do que 'count'
+     * instâncias: um descarte uniforme deixa exatamente 'count' (ou 'capacity'), sem aproximar nenhum par.
+     *
+     * Custo: proporcional a 'count' por vegetação, mais footprint² por instância distribuída (a marcação
+     * do mapa e a contagem da capacidade, feita junto), sem percorrer a área do filtro. Se o espaço livre
+     * estiver fragmentado, a vegetação é refeita com o dobro do objetivo até chegar a 'count': no pior
+     * caso, quando nem assim chega, o custo é proporcional a 'capacity'. O mapa ocupa um byte por ponto
+     * da grade. O resultado não depende do número de threads.
+     *
+     * @param index O índice do mesmo terreno.
+     * @param threadCount Número de threads; 0 usa std::thread::hardware_concurrency().
+     * @return Uma distribuição por vegetação, na ordem de 'layers'.
+     */
+    std::vector<VegetationPlacement> placeVegetationLayers(const Heightfield &heightfield, const PlacementIndex &index,
+                                                           const std::vector<VegetationParams> &layers, unsigned int threadCount = 0);
+
+    /**
+     * @brief Uma única vegetação (ver placeVegetationLayers), sem outras para respeitar.
+     */
+    std::vector<glm::mat4> placeVegetation(const Heightfield &heightfield, const VegetationParams &params);
+
+    /**
+     * @brief Sorteia uma das 'layerCount' variantes para cada instância.
+     * A escolha vem de um hash da posição, sem estado, como a distribuição: a mesma cena sempre
+     * recebe as mesmas variantes.
+     */
+    std::vector<InstanceData> assignVariants(const std::vector<glm::mat4> &transforms, uint32_t layerCount);
+}
+
+#endif
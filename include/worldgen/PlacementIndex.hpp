@@ -0,0 +1,113 @@
+#ifndef WORLDGEN_PLACEMENT_INDEX_H
+#define WORLDGEN_PLACEMENT_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Heightfield.hpp"
+
+namespace worldgen
+{
+    // A textura predominante de um ponto do terreno (ver surfaceWeights).
+    enum class Biome : uint8_t
+    {
+        Sand,
+        Grass,
+        Rock
+    };
+    const int BIOME_COUNT = 3;
+
+    // Máscara de biomas: um bit por Biome.
+    inline uint32_t biomeBit(Biome biome) { return 1u << static_cast<uint32_t>(biome); }
+    const uint32_t ALL_BIOMES = (1u << BIOME_COUNT) - 1;
+
+    /**
+     * @struct PlacementFilter
+     * @brief Os pontos do terreno onde uma vegetação pode crescer.
+     */
+    struct PlacementFilter
+    {
+        float minHeight;
+        float maxHeight;
+        float maxSlope = 1.0f;        // Inclinação máxima, 1 - normal.y.
+        uint32_t biomes = ALL_BIOMES; // Máscara de biomeBit().
+
+        bool accepts(float height, float slope, Biome biome) const
+        {
+            return height >= minHeight && height <= maxHeight && slope <= maxSlope && (biomes & biomeBit(biome)) != 0;
+        }
+    };
+
+    /**
+     * @class PlacementIndex
+     * @brief Os pontos da grade do terreno agrupados por faixa de altura, faixa de inclinação e bioma.
+     *
+     * Construído uma vez por terreno, em tempo linear (ordenação por contagem). Uma consulta visita só
+     * os grupos que cruzam o filtro: os grupos inteiramente dentro dele entram como intervalos, sem
+     * olhar os pontos, e só os das bordas do filtro são testados ponto a ponto. Depois de construído,
+     * é imutável e pode ser consultado de várias threads.
+     */
+    class PlacementIndex
+    {
+    public:
+        /**
+         * @param amplitude Altura que normaliza a classificação dos biomas (a mesma de TerrainSurfaceParams).
+         * @param bandHeight Altura de cada faixa, em unidades do mundo.
+         */
+        explicit PlacementIndex(const Heightfield &heightfield, float amplitude = 50.0f, float bandHeight = 1.0f);
+
+        /**
+         * @class Selection
+         * @brief Os pontos da grade que passam num filtro, acessados por índice em O(log grupos).
+         * Referencia o índice que a criou, que deve continuar existindo.
+         */
+        class Selection
+        {
+        public:
+            size_t size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+            // Coordenadas na grade do i-ésimo ponto.
+            glm::ivec2 operator[](size_t i) const;
+
+        private:
+            friend class PlacementIndex;
+            const PlacementIndex *m_index = nullptr;
+            std::vector<size_t> m_rangeBegin; // Início de cada intervalo em PlacementIndex::m_cells.
+            std::vector<size_t> m_rangeEnd;   // Fim acumulado de cada intervalo, em índices da seleção.
+            std::vector<uint32_t> m_partial;  // Pontos aprovados dos grupos das bordas, depois dos intervalos.
+            size_t m_size = 0;
+        };
+
+        Selection select(const PlacementFilter &filter) const;
+
+        // Bioma de um ponto da grade, com as coordenadas limitadas às bordas.
+        Biome biomeAt(int x, int z) const;
+
+        int width() const { return m_width; }
+        int depth() const { return m_depth; }
+
+    private:
+        static const int SLOPE_BANDS = 8; // Faixas de inclinação de mesma largura em [0, 1].
+
+        size_t bucketOf(int band, int slopeBand, Biome biome) const
+        {
+            return (static_cast<size_t>(band) * SLOPE_BANDS + slopeBand) * BIOME_COUNT + static_cast<size_t>(biome);
+        }
+        int bandOf(float height) const;
+        static int slopeBandOf(float slope);
+
+        int m_width;
+        int m_depth;
+        float m_minHeight;
+        float m_bandHeight;
+        int m_bandCount;
+        std::vector<uint32_t> m_bucketStart; // Início de cada grupo em m_cells (mais um, o total).
+        std::vector<uint32_t> m_cells;       // Índices z * width + x, ordenados por grupo.
+        std::vector<float> m_heights;        // Altura de cada ponto de m_cells, na mesma ordem.
+        std::vector<float> m_slopes;         // Inclinação de cada ponto de m_cells, na mesma ordem.
+        std::vector<Biome> m_biomes;         // Bioma de cada ponto, linha a linha (z * width + x).
+    };
+}
+
+#endif
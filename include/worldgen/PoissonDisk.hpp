@@ -0,0 +1,103 @@
+#ifndef WORLDGEN_POISSON_DISK_H
+#define WORLDGEN_POISSON_DISK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/Random.hpp"
+
+namespace worldgen
+{
+    // Um ponto aceito pela amostragem, com a camada a que pertence.
+    struct PoissonSample
+    {
+        glm::vec2 position;
+        uint32_t layer;
+        RandomBlock random; // Bloco que gerou o ponto; os números 2 e 3 ficam livres para quem o usa.
+    };
+
+    /**
+     * @class SpatialHash
+     * @brief Grade uniforme de pontos no plano, com uma lista de pontos por célula.
+     *
+     * Com células do tamanho da maior distância de conflito, todos os vizinhos de um ponto
+     * estão nas 3x3 células em volta da sua. Inserções em células diferentes podem ocorrer em
+     * threads diferentes, desde que nenhuma delas leia as células que a outra escreve.
+     */
+    class SpatialHash
+    {
+    public:
+        SpatialHash(const glm::vec2 &min, const glm::vec2 &max, float cellSize);
+
+        void insert(const PoissonSample &sample);
+
+        // Verdadeiro se 'conflicts' aceitar algum ponto das 3x3 células em volta de 'position'.
+        template <typename F>
+        bool anyNear(const glm::vec2 &position, F conflicts) const
+        {
+            glm::ivec2 cell = cellOf(position);
+            for (int z = std::max(cell.y - 1, 0); z <= std::min(cell.y + 1, m_rows - 1); ++z)
+            {
+                for (int x = std::max(cell.x - 1, 0); x <= std::min(cell.x + 1, m_columns - 1); ++x)
+                {
+                    for (const PoissonSample &other : m_cells[z * m_columns + x])
+                    {
+                        if (conflicts(other))
+                            return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        glm::ivec2 cellOf(const glm::vec2 &position) const;
+        float cellSize() const { return m_cellSize; }
+
+    private:
+        glm::vec2 m_min;
+        float m_cellSize;
+        int m_columns;
+        int m_rows;
+        std::vector<std::vector<PoissonSample>> m_cells;
+    };
+
+    /**
+     * @struct PoissonLayer
+     * @brief Uma classe de pontos da amostragem (por exemplo, um tipo de vegetação).
+     */
+    struct PoissonLayer
+    {
+        float spacing;   // Distância mínima entre dois pontos desta camada.
+        float footprint; // Distância mínima entre um ponto desta camada e um de outra (vale a maior das duas).
+        uint32_t stream; // Sequência do gerador (ver counterRandom).
+        uint64_t seed;
+        // Decide se um ponto candidato pode ser usado (faixa de altura, por exemplo). Chamada em várias threads.
+        std::function<bool(const glm::vec2 &)> accept;
+        // Pontos de partida, já dentro das regiões aceitas (ver PlacementIndex). Vazio: lançamentos uniformes
+        // em cada ladrilho, que nas regiões recusadas são descartados.
+        std::vector<glm::vec2> seeds;
+        // Pontos já aceitos desta camada, numa amostragem anterior: são respeitados como os novos, mas não
+        // fazem parte do resultado. Uma camada com espaçamento <= 0 e pontos aceitos só ocupa espaço.
+        std::vector<glm::vec2> placed;
+    };
+
+    /**
+     * @brief Amostragem de disco de Poisson (Bridson, "Fast Poisson Disk Sampling in Arbitrary
+     * Dimensions") de várias camadas no retângulo [min, max], com um único SpatialHash para todas.
+     *
+     * O retângulo é dividido em ladrilhos de 4x4 células, processados em quatro fases pela paridade
+     * das suas coordenadas: ladrilhos da mesma fase ficam a um ladrilho de distância e não se afetam,
+     * então cada fase roda em paralelo. Cada ladrilho tem o seu próprio gerador (counterRandom com o
+     * ladrilho como célula), e o resultado não depende do número de threads. O custo é linear na
+     * área e no número de pontos.
+     *
+     * @param threadCount Número de threads; 0 usa std::thread::hardware_concurrency().
+     * @return Os pontos novos de cada camada (sem os PoissonLayer::placed), na ordem das camadas.
+     */
+    std::vector<std::vector<PoissonSample>> samplePoissonDisk(const glm::vec2 &min, const glm::vec2 &max, const std::vector<PoissonLayer> &layers,
+                                                             unsigned int threadCount = 0);
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef WORLDGEN_RANDOM_H
+#define WORLDGEN_RANDOM_H
+
+#include <cstdint>
+
+namespace worldgen
+{
+    // Semente usada quando nenhuma outra é escolhida: a mesma cena a cada execução.
+    const uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ull;
+
+    /**
+     * @struct RandomBlock
+     * @brief Quatro números aleatórios de 32 bits, resultado de uma chamada a counterRandom().
+     */
+    struct RandomBlock
+    {
+        uint32_t bits[4];
+
+        // O número 'i' (0 a 3) como float uniforme em [0, 1), com 24 bits de precisão.
+        float uniform(int i) const { return static_cast<float>(bits[i] >> 8) * (1.0f / 16777216.0f); }
+        // O número 'i' (0 a 3) como inteiro uniforme em [0, n).
+        uint32_t below(int i, uint32_t n) const { return static_cast<uint32_t>((static_cast<uint64_t>(bits[i]) * n) >> 32); }
+    };
+
+    /**
+     * @brief Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"): cifra o
+     * contador de 128 bits com a chave de 64 bits em 10 rodadas de multiplicação e troca.
+     *
+     * Não guarda estado: o mesmo contador e a mesma chave sempre dão o mesmo bloco, em qualquer
+     * thread e em qualquer ordem. Cada objeto gerado usa o seu próprio contador, em vez de consumir
+     * uma sequência global como rand().
+     */
+    inline RandomBlock philox4x32(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1)
+    {
+        const uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+        const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+        for (int round = 0; round < 10; ++round)
+        {
+            if (round > 0)
+            {
+                k0 += W0;
+                k1 += W1;
+            }
+            uint64_t p0 = M0 * c0;
+            uint64_t p1 = M1 * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+        }
+        return {{c0, c1, c2, c3}};
+    }
+
+    /**
+     * @brief Bloco aleatório de um objeto gerado proceduralmente.
+     * @param seed A semente do mundo (a chave).
+     * @param stream O gerador que pede os números (grama, cada vegetação...), para que não compartilhem sequências.
+     * @param cellX, cellZ A célula ou ladrilho do objeto (0, 0 se a distribuição não for por células).
+     * @param index O índice do objeto dentro da célula.
+     */
+    inline RandomBlock counterRandom(uint64_t seed, uint32_t stream, int32_t cellX, int32_t cellZ, uint32_t index)
+    {
+        return philox4x32(stream, static_cast<uint32_t>(cellX), static_cast<uint32_t>(cellZ), index,
+                          static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32));
+    }
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef WORLDGEN_RANGEALLOCATOR_H
+#define WORLDGEN_RANGEALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace worldgen
+{
+    /**
+     * @class RangeAllocator
+     * @brief Subalocador de intervalos [offset, offset + size) dentro de uma capacidade fixa.
+     *
+     * Não conhece a memória que gerencia: serve para dividir um buffer grande (ex: um VBO
+     * compartilhado na GPU) em pedaços. Usa uma lista de blocos livres ordenada por offset,
+     * com escolha do primeiro bloco que couber (first-fit) e fusão de blocos vizinhos na liberação.
+     */
+    class RangeAllocator
+    {
+    public:
+        static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+        explicit RangeAllocator(uint32_t capacity = 0);
+
+        /**
+         * @brief Reserva 'size' elementos contíguos.
+         * @return O offset do intervalo, ou INVALID_OFFSET se não houver um bloco livre grande o bastante.
+         */
+        uint32_t allocate(uint32_t size);
+
+        // Devolve um intervalo obtido com allocate(), fundindo-o com os blocos livres vizinhos.
+        void free(uint32_t offset, uint32_t size);
+
+        // Aumenta a capacidade; o espaço novo, no fim, fica livre.
+        void grow(uint32_t newCapacity);
+
+        uint32_t capacity() const { return m_capacity; }
+        uint32_t used() const { return m_used; }
+        // Número de blocos livres: mais de um indica fragmentação.
+        size_t freeBlockCount() const { return m_freeBlocks.size(); }
+
+    private:
+        std::map<uint32_t, uint32_t> m_freeBlocks; // offset -> tamanho
+        uint32_t m_capacity = 0;
+        uint32_t m_used = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef WORLDGEN_TASKPOOL_H
+#define WORLDGEN_TASKPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace worldgen
+{
+    /**
+     * @class TaskPool
+     * @brief Conjunto fixo de threads que executam tarefas em ordem de chegada (FIFO).
+     * Tarefas podem enfileirar novas tarefas. No destrutor, as tarefas que ainda não
+     * começaram são descartadas e o pool espera as que estão em execução terminarem.
+     */
+    class TaskPool
+    {
+    public:
+        // threadCount = 0 usa o número de núcleos disponíveis.
+        explicit TaskPool(unsigned int threadCount = 0);
+        ~TaskPool();
+
+        TaskPool(const TaskPool &) = delete;
+        TaskPool &operator=(const TaskPool &) = delete;
+
+        // Enfileira uma tarefa. Ignorada se o pool já estiver sendo destruído.
+        void submit(std::function<void()> task);
+
+        unsigned int threadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        bool m_stopping = false;
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef WORLDGEN_TERRAINSURFACE_H
+#define WORLDGEN_TERRAINSURFACE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/PageCache.hpp"
+#include "worldgen/TextureCompressor.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct TerrainSurfaceParams
+     * @brief Texturas de detalhe do terreno e as regras de mistura por altura e inclinação.
+     */
+    struct TerrainSurfaceParams
+    {
+        std::string sandPath;
+        std::string grassPath;
+        std::string rockPath;
+        float sandTiling = 15.0f;  // Repetições de cada textura ao longo do terreno.
+        float grassTiling = 20.0f;
+        float rockTiling = 15.0f;
+        float amplitude = 50.0f;   // Altura que normaliza a mistura por altura.
+    };
+
+    /**
+     * @brief Pesos de areia (x), grama (y) e rocha (z) de um ponto do terreno, que somam 1: areia e grama
+     * pela altura, e rocha pela altura e pela inclinação.
+     * @param heightNormalized Altura levada de [-amplitude, amplitude] para [0, 1].
+     * @param slope Inclinação, 1 - normal.y (0 = plano).
+     */
+    glm::vec3 surfaceWeights(float heightNormalized, float slope);
+
+    /**
+     * @class TerrainSurface
+     * @brief Compõe as páginas da textura virtual do terreno: cada texel recebe a mistura de areia,
+     * grama e rocha que antes era feita no fragment shader, mas agora com detalhe único por texel.
+     *
+     * As texturas de origem são decodificadas (com os seus mipmaps) uma vez, no construtor; depois disso
+     * o objeto é imutável e composePage() pode ser chamada de várias threads ao mesmo tempo.
+     * Lança std::runtime_error se alguma textura não puder ser lida.
+     */
+    class TerrainSurface
+    {
+    public:
+        TerrainSurface(std::shared_ptr<const Heightfield> heightfield, const TerrainSurfaceParams &params);
+
+        /**
+         * @brief Gera os texels de uma página, com a borda, no tamanho do slot do layout.
+         * As texturas de origem são lidas no mipmap cuja densidade mais se aproxima da do nível da página.
+         */
+        RgbaImage composePage(const VirtualTextureLayout &layout, PageId page) const;
+
+    private:
+        struct Layer
+        {
+            std::vector<RgbaImage> mips;
+            float tiling;
+        };
+
+        Layer loadLayer(const std::string &path, float tiling) const;
+        // Cor bilinear da camada, repetindo a textura, no mipmap adequado a 'texelsPerPixel'.
+        glm::vec3 sampleLayer(const Layer &layer, glm::vec2 uv, float texelsPerPixel) const;
+
+        std::shared_ptr<const Heightfield> m_heightfield;
+        float m_amplitude;
+        Layer m_sand;
+        Layer m_grass;
+        Layer m_rock;
+    };
+}
+
+#endif
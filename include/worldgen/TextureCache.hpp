@@ -0,0 +1,86 @@
+#ifndef WORLDGEN_TEXTURECACHE_H
+#define WORLDGEN_TEXTURECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "worldgen/MappedFile.hpp"
+#include "worldgen/TextureCompressor.hpp"
+
+namespace worldgen
+{
+    /**
+     * @enum TextureCompression
+     * @brief Como a imagem é comprimida ao gerar o cache.
+     */
+    enum class TextureCompression
+    {
+        Auto, // BC1, BC3 ou BC4, conforme os canais e a transparência da imagem.
+        RG,   // BC5 com os canais R e G: mapas de distorção e normais (o shader reconstrói o Z).
+    };
+
+    /**
+     * @struct TextureLevel
+     * @brief Um nível de mipmap no cache: dimensões e posição dos blocos comprimidos.
+     */
+    struct TextureLevel
+    {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset; // A partir do início dos dados comprimidos.
+        uint64_t size;
+    };
+
+    /**
+     * @class CompressedTexture
+     * @brief Resultado de loadTextureCached: todos os níveis de mipmap já comprimidos, vindos do
+     * cache mapeado (sem cópias) ou, na primeira carga, recém-comprimidos na memória.
+     * Fica vazia (avaliada como false) se a imagem não pôde ser lida.
+     */
+    class CompressedTexture
+    {
+    public:
+        explicit operator bool() const { return !m_levels.empty(); }
+        // Verdadeiro se os dados vêm do arquivo de cache mapeado.
+        bool fromCache() const { return m_file.isOpen(); }
+
+        BlockFormat format() const { return m_format; }
+        size_t levelCount() const { return m_levels.size(); }
+        const TextureLevel &level(size_t index) const { return m_levels[index]; }
+        const unsigned char *levelData(size_t index) const { return data() + m_levels[index].offset; }
+        // Soma dos blocos de todos os níveis.
+        size_t byteSize() const;
+
+    private:
+        friend CompressedTexture loadTextureCached(const std::string &imagePath, TextureCompression compression);
+
+        const unsigned char *data() const { return fromCache() ? m_file.data() + m_dataOffset : m_data.data(); }
+
+        MappedFile m_file;              // Cache mapeado (quando válido).
+        size_t m_dataOffset = 0;        // Início dos blocos dentro de m_file.
+        std::vector<uint8_t> m_data;    // Blocos recém-comprimidos (quando o cache não existia ou estava inválido).
+        std::vector<TextureLevel> m_levels;
+        BlockFormat m_format = BlockFormat::BC1;
+    };
+
+    // Caminho do cache gravado ao lado da imagem; cada modo de compressão tem o seu.
+    std::string textureCachePath(const std::string &imagePath, TextureCompression compression);
+
+    /**
+     * @brief Grava os níveis comprimidos em um contêiner no estilo KTX2: cabeçalho, tabela de níveis
+     * e os blocos de cada nível, do maior para o menor, prontos para glCompressedTexImage2D.
+     * @return false se o arquivo não puder ser gravado (ex: diretório somente leitura).
+     */
+    bool saveTextureCache(const std::string &cachePath, BlockFormat format, const std::vector<TextureLevel> &levels,
+                          const std::vector<uint8_t> &data, const FileStamp &source, uint64_t sourceHash);
+
+    /**
+     * @brief Carrega a imagem já comprimida e com a cadeia completa de mipmaps, usando o cache sempre que válido.
+     * A validação segue a do cache de malhas (tamanho, data ou hash da imagem de origem e hash dos dados).
+     * Caso contrário, a imagem é decodificada, reduzida até 1x1, comprimida e o cache é regravado.
+     */
+    CompressedTexture loadTextureCached(const std::string &imagePath, TextureCompression compression);
+}
+
+#endif
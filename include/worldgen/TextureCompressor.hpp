@@ -0,0 +1,61 @@
+#ifndef WORLDGEN_TEXTURECOMPRESSOR_H
+#define WORLDGEN_TEXTURECOMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "worldgen/ImageData.hpp"
+
+namespace worldgen
+{
+    /**
+     * @enum BlockFormat
+     * @brief Formatos de compressão em blocos de 4x4 pixels aceitos diretamente pela GPU.
+     */
+    enum class BlockFormat : uint32_t
+    {
+        BC1 = 1, // RGB, 8 bytes por bloco (4 bits por pixel).
+        BC3 = 3, // RGBA: alfa como em BC4 + cor como em BC1, 16 bytes por bloco.
+        BC4 = 4, // Um canal (R), 8 bytes por bloco.
+        BC5 = 5, // Dois canais (RG), 16 bytes por bloco; ideal para mapas de distorção e normais.
+    };
+
+    // Bytes de um bloco 4x4 no formato; 0 se o formato for desconhecido.
+    size_t blockBytes(BlockFormat format);
+
+    // Bytes de uma imagem width x height no formato (os blocos das bordas são completos).
+    size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+    const char *blockFormatName(BlockFormat format);
+
+    /**
+     * @struct RgbaImage
+     * @brief Imagem com 4 canais de 8 bits por pixel, usada como entrada da compressão e dos mipmaps.
+     */
+    struct RgbaImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels; // width * height * 4 bytes, linha a linha.
+    };
+
+    // Expande uma imagem de 1 a 4 canais para RGBA (cinza vira RGB iguais; sem alfa, alfa = 255).
+    RgbaImage toRgba(const ImageData &image);
+
+    // Escolhe o formato pelo conteúdo: BC4 para um canal, BC3 se houver transparência e BC1 nos demais casos.
+    BlockFormat chooseBlockFormat(const ImageData &image, const RgbaImage &rgba);
+
+    /**
+     * @brief Próximo nível de mipmap: metade do tamanho em cada eixo (mínimo 1), pela média de 2x2 pixels.
+     */
+    RgbaImage downsample(const RgbaImage &image);
+
+    /**
+     * @brief Comprime a imagem bloco a bloco. Os blocos das bordas replicam a última linha/coluna.
+     * BC1 ajusta os extremos pelo eixo principal das cores do bloco e os refina por mínimos quadrados;
+     * BC4/BC5 usam o mínimo e o máximo de cada canal com 8 níveis.
+     */
+    std::vector<uint8_t> compressImage(const RgbaImage &image, BlockFormat format);
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef WORLDGEN_VERTEXQUANTIZER_H
+#define WORLDGEN_VERTEXQUANTIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "worldgen/MeshData.hpp"
+
+namespace worldgen
+{
+    /**
+     * @struct PackedVertex
+     * @brief Vértice compactado de 16 bytes (metade da struct Vertex), lido diretamente pela GPU:
+     * posição em unorm16 relativa à caixa da malha (GL_UNSIGNED_SHORT normalizado), normal em
+     * snorm 10_10_10_2 (GL_INT_2_10_10_10_REV) e coordenadas de textura em half float (GL_HALF_FLOAT).
+     */
+    struct PackedVertex
+    {
+        uint16_t Position[4]; // xyz; w não é usado e só mantém o alinhamento.
+        uint32_t Normal;
+        uint16_t TexCoords[2];
+    };
+    static_assert(sizeof(PackedVertex) == 16, "PackedVertex deve ter 16 bytes");
+
+    /**
+     * @struct QuantizationError
+     * @brief Maior erro introduzido pela compactação, medido vértice a vértice.
+     */
+    struct QuantizationError
+    {
+        float position = 0.0f;      // Em unidades do modelo.
+        float normalDegrees = 0.0f; // Ângulo entre a normal original e a compactada.
+        float texCoord = 0.0f;      // Em unidades de UV.
+    };
+
+    /**
+     * @struct QuantizedMesh
+     * @brief Vértices compactados e a transformação que o vertex shader aplica para recuperar a posição:
+     * posição = aPos * positionScale + positionOffset (aPos chega em [0, 1]).
+     */
+    struct QuantizedMesh
+    {
+        std::vector<PackedVertex> vertices;
+        glm::vec3 positionOffset = glm::vec3(0.0f); // Canto mínimo da caixa da malha.
+        glm::vec3 positionScale = glm::vec3(1.0f);  // Tamanho da caixa em cada eixo.
+        QuantizationError error;
+    };
+
+    /**
+     * @brief Compacta os vértices de uma malha e mede o erro da conversão.
+     */
+    QuantizedMesh quantizeVertices(const Vertex *vertices, size_t vertexCount);
+}
+
+#endif
@@ -6,9 +6,10 @@ out vec4 FragColor;
 in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoords;
+flat in uint Layer;
 
 //Uniforms
-uniform sampler2D texture_diffuse1;
+uniform sampler2DArray texture_diffuse1; // Uma camada por variante
 uniform vec3 lightDir;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
@@ -16,7 +17,7 @@ uniform vec3 viewPos;
 void main()
 {
     // Obtém a cor da textura
-    vec4 texColor = texture(texture_diffuse1, TexCoords);
+    vec4 texColor = texture(texture_diffuse1, vec3(TexCoords, Layer));
 
     // Alpha-testing: descarta píxeis transparentes para recortar a forma
     if(texColor.a < 0.1)
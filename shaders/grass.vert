@@ -4,25 +4,40 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in mat4 aInstanceMatrix; // Matriz de transformação da instância
+layout (location = 3) in vec3 aInstancePosition; // Posição da instância
+layout (location = 4) in vec2 aInstanceScale;    // Largura (eixos x/z) e altura (eixo y) da instância
+layout (location = 5) in vec4 aInstanceRotation; // Quatérnio da rotação da instância
+layout (location = 6) in uint aLayer;            // Camada da textura array (variante da instância)
 
 //Saídas para o Fragment Shader
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out uint Layer;
 
 //Uniforms
 uniform mat4 projection;
 uniform mat4 view;
+uniform vec3 positionScale;  // Tamanho da caixa da malha, para vértices compactados (1 se não forem)
+uniform vec3 positionOffset; // Canto mínimo da caixa da malha (0 se não forem)
 uniform vec4 plane; // Plano de corte para a água
 
+// Rotaciona 'v' pelo quatérnio unitário 'q'.
+vec3 quatRotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
 void main()
 {
-    // Posiciona e orienta o vértice no mundo usando a matriz da instância
-    vec4 worldPosition = aInstanceMatrix * vec4(aPos, 1.0);
+    // Posiciona e orienta o vértice no mundo com a escala, a rotação e a posição da instância
+    vec4 rotation = normalize(aInstanceRotation);
+    vec3 scale = aInstanceScale.xyx;
+    vec4 worldPosition = vec4(aInstancePosition + quatRotate(rotation, (aPos * positionScale + positionOffset) * scale), 1.0);
     FragPos = worldPosition.xyz;
-    Normal = normalize(mat3(transpose(inverse(aInstanceMatrix))) * aNormal);
+    Normal = normalize(quatRotate(rotation, aNormal / scale));
     TexCoords = aTexCoords;
+    Layer = aLayer;
 
     // Aplica o plano de corte (para reflexo/refração da água)
     gl_ClipDistance[0] = dot(worldPosition, plane);
@@ -0,0 +1,42 @@
+#version 460 core
+
+out vec4 FragColor;
+
+//Entradas do Vertex Shader
+in vec3 FragPos;
+in vec3 Normal;
+in float BladeHeight;
+flat in float Tint;
+
+//Uniforms
+uniform vec3 lightDir;
+uniform vec3 lightColor;
+uniform vec3 viewPos;
+
+void main()
+{
+    // Cor da lâmina: mais escura na base, mais clara na ponta, com uma variação por lâmina.
+    vec3 baseColor = mix(vec3(0.10, 0.25, 0.05), vec3(0.18, 0.38, 0.08), Tint);
+    vec3 tipColor = mix(vec3(0.45, 0.65, 0.20), vec3(0.60, 0.70, 0.25), Tint);
+    vec3 color = mix(baseColor, tipColor, BladeHeight);
+
+    // A lâmina é vista dos dois lados: a normal aponta para a câmera.
+    vec3 norm = normalize(gl_FrontFacing ? Normal : -Normal);
+
+    //Iluminação de Phong
+    // Ambiente
+    vec3 ambient = 0.4 * lightColor;
+
+    // Difusa (meia-luz do lado de trás, pela translucidez da lâmina)
+    vec3 lightDirectionToFrag = normalize(-lightDir);
+    float diff = max(dot(norm, lightDirectionToFrag), 0.0) + 0.3 * max(dot(-norm, lightDirectionToFrag), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Especular (brilho fraco para vegetação)
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 8);
+    vec3 specular = 0.05 * spec * lightColor;
+
+    FragColor = vec4((ambient + diffuse) * color + specular, 1.0);
+}
@@ -0,0 +1,115 @@
+#version 460 core
+
+// Lâminas de grama sem nenhum atributo: cada instância é uma lâmina, e gl_VertexID escolhe o vértice
+// numa tira de BLADE_SEGMENTS segmentos (2 * BLADE_SEGMENTS + 1 vértices, a ponta por último).
+const int BLADE_SEGMENTS = 4;
+const float TWO_PI = 6.28318530718;
+
+//Saídas para o Fragment Shader
+out vec3 FragPos;
+out vec3 Normal;
+out float BladeHeight; // 0 na base, 1 na ponta
+flat out float Tint;   // Variação de cor da lâmina, em [0, 1)
+
+//Uniforms
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec4 plane; // Plano de corte para a água
+
+uniform sampler2D grassMap;    // R: altura do terreno; G: ruído de cobertura (um texel por ponto da grade)
+uniform vec2 terrainSize;      // Largura e profundidade da grade do terreno
+uniform vec2 heightBand;       // Alturas do terreno onde a grama cresce
+uniform float noiseThreshold;  // A grama só cresce onde o ruído de cobertura passa deste valor
+uniform int gridSide;          // Lâminas por lado da grade em volta da câmera
+uniform vec2 gridOrigin;       // Célula do canto da grade, em múltiplos de 'spacing'
+uniform float spacing;         // Lado de uma célula: uma lâmina por célula
+uniform float fadeStart;       // Distância a partir da qual as lâminas rareiam...
+uniform float radius;          // ...até não sobrar nenhuma
+uniform vec3 viewPos;
+uniform float bladeHeight = 0.6;
+uniform float bladeWidth = 0.06;
+
+// Hash de três inteiros para três inteiros (PCG3D, Jarzynski e Olano, "Hash Functions for GPU Rendering").
+uvec3 pcg3d(uvec3 v)
+{
+    v = v * 1664525u + 1013904223u;
+    v.x += v.y * v.z;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    v ^= v >> 16u;
+    v.x += v.y * v.z;
+    v.y += v.z * v.x;
+    v.z += v.x * v.y;
+    return v;
+}
+
+// Lâmina descartada: todos os vértices no mesmo ponto, fora do volume de visão.
+void discardBlade()
+{
+    FragPos = vec3(0.0);
+    Normal = vec3(0.0, 1.0, 0.0);
+    BladeHeight = 0.0;
+    Tint = 0.0;
+    gl_ClipDistance[0] = -1.0;
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+}
+
+void main()
+{
+    // A célula da lâmina no mundo e os seus números aleatórios: os mesmos a cada frame, onde quer que esteja a câmera.
+    ivec2 cell = ivec2(gridOrigin) + ivec2(gl_InstanceID % gridSide, gl_InstanceID / gridSide);
+    uvec3 hash = pcg3d(uvec3(uint(cell.x), uint(cell.y), 0x9E3779B9u));
+    vec3 random = vec3(hash >> 8u) * (1.0 / 16777216.0);
+    vec3 shape = vec3(pcg3d(hash) >> 8u) * (1.0 / 16777216.0);
+
+    vec2 world = (vec2(cell) + random.xy) * spacing;
+    // O ponto (x, z) da grade do terreno fica em x - largura / 2 no mundo, no centro do texel x.
+    vec2 uv = (world + terrainSize * 0.5 + 0.5) / terrainSize;
+    vec2 terrain = texture(grassMap, uv).rg;
+
+    // A mesma regra da grama em ladrilhos, e a densidade caindo com a distância.
+    float keep = 1.0 - smoothstep(fadeStart, radius, distance(world, viewPos.xz));
+    bool grows = all(greaterThanEqual(uv, vec2(0.0))) && all(lessThanEqual(uv, vec2(1.0))) &&
+                 terrain.r >= heightBand.x && terrain.r < heightBand.y && terrain.g > noiseThreshold && random.z < keep;
+    if (!grows)
+    {
+        discardBlade();
+        return;
+    }
+
+    vec3 base = vec3(world.x, terrain.r, world.y);
+    float height = bladeHeight * (0.6 + 0.8 * shape.x);
+
+    // Fora do frustum (com folga para a altura da lâmina), nenhum dos vértices precisa ser calculado.
+    vec4 clipCenter = projection * view * vec4(base + vec3(0.0, 0.5 * height, 0.0), 1.0);
+    float margin = clipCenter.w + height;
+    if (clipCenter.w < -height || any(greaterThan(abs(clipCenter.xy), vec2(margin * 1.1))))
+    {
+        discardBlade();
+        return;
+    }
+
+    // Vértice 2 * s e 2 * s + 1: os dois lados do segmento s; o último, a ponta.
+    int segment = gl_VertexID / 2;
+    float t = float(segment) / float(BLADE_SEGMENTS);
+    float side = gl_VertexID == 2 * BLADE_SEGMENTS ? 0.0 : (gl_VertexID % 2 == 0 ? -0.5 : 0.5);
+
+    float yaw = shape.y * TWO_PI;
+    vec3 facing = vec3(cos(yaw), 0.0, sin(yaw));
+    vec3 across = vec3(-facing.z, 0.0, facing.x);
+    // A ponta se desloca na direção 'facing', em curva (quadrática na altura).
+    float bend = (0.2 + 0.6 * shape.z) * height;
+    vec3 worldPos = base + across * (bladeWidth * (1.0 - t) * side) + facing * (bend * t * t) + vec3(0.0, height * t, 0.0);
+
+    vec3 tangent = normalize(facing * (2.0 * bend * t) + vec3(0.0, height, 0.0));
+    Normal = normalize(cross(across, tangent));
+    FragPos = worldPos;
+    BladeHeight = t;
+    Tint = random.z / max(keep, 1e-4);
+
+    // Aplica o plano de corte (para reflexo/refração da água)
+    gl_ClipDistance[0] = dot(vec4(worldPos, 1.0), plane);
+
+    // Posição final no ecrã
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
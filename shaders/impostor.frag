@@ -0,0 +1,68 @@
+#version 460 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec2 TexCoords;
+flat in uint Layer;
+flat in vec2 Frame;
+flat in vec2 FrameBlend;
+flat in vec4 ModelToWorld; // Quatérnio da rotação da instância
+flat in float Fade;
+
+uniform sampler2DArray impostorAlbedo;
+uniform sampler2DArray impostorNormal;
+uniform float impostorFrames;
+
+// Propriedades da luz (as mesmas da vegetação)
+uniform vec3 lightDir;
+uniform vec3 lightColor;
+uniform vec3 viewPos;
+
+// Limiar de dithering estável na tela, usado na transição entre a malha e o impostor.
+float ditherThreshold()
+{
+    return fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+}
+
+vec4 sampleFrame(sampler2DArray atlas, vec2 frame)
+{
+    return texture(atlas, vec3((frame + TexCoords) / impostorFrames, Layer));
+}
+
+vec3 quatRotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+    // Transição: o impostor aparece à medida que a malha desaparece (vegetation.frag usa o complemento).
+    if (ditherThreshold() >= Fade)
+        discard;
+
+    vec4 albedo = mix(mix(sampleFrame(impostorAlbedo, Frame), sampleFrame(impostorAlbedo, Frame + vec2(1.0, 0.0)), FrameBlend.x),
+                      mix(sampleFrame(impostorAlbedo, Frame + vec2(0.0, 1.0)), sampleFrame(impostorAlbedo, Frame + vec2(1.0, 1.0)), FrameBlend.x),
+                      FrameBlend.y);
+    if (albedo.a < 0.5)
+        discard;
+    vec3 packedNormal = mix(mix(sampleFrame(impostorNormal, Frame).rgb, sampleFrame(impostorNormal, Frame + vec2(1.0, 0.0)).rgb, FrameBlend.x),
+                            mix(sampleFrame(impostorNormal, Frame + vec2(0.0, 1.0)).rgb, sampleFrame(impostorNormal, Frame + vec2(1.0, 1.0)).rgb, FrameBlend.x),
+                            FrameBlend.y);
+
+    // O alfa pré-multiplica a cor nas bordas filtradas: divide para recuperar a cor do modelo.
+    vec3 color = albedo.rgb / albedo.a;
+    vec3 norm = normalize(quatRotate(ModelToWorld, packedNormal / albedo.a * 2.0 - 1.0));
+
+    // Iluminação igual à de vegetation.frag.
+    float ambientStrength = 0.4;
+    vec3 ambient = ambientStrength * lightColor;
+    float diff = max(dot(norm, normalize(-lightDir)), 0.0);
+    vec3 diffuse = diff * lightColor;
+    float specularStrength = 0.1;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 4);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    FragColor = vec4((ambient + diffuse) * color + specular, 1.0);
+}
@@ -0,0 +1,74 @@
+#version 460 core
+// Um quad por instância, voltado para a câmera, que amostra o atlas de impostores (ver ImpostorAtlas).
+layout (location = 0) in vec3 aPos;            // Canto do quad, em [-1, 1]
+layout (location = 3) in vec3 aInstancePosition; // Posição da instância
+layout (location = 4) in vec2 aInstanceScale;    // Escala nos eixos x/z e y do modelo
+layout (location = 5) in vec4 aInstanceRotation; // Quatérnio da rotação da instância
+layout (location = 6) in uint aLayer;            // Camada do atlas (variante da instância)
+
+out vec3 FragPos;
+out vec2 TexCoords;
+flat out uint Layer;
+flat out vec2 Frame;     // Quadro inferior esquerdo dos quatro misturados
+flat out vec2 FrameBlend; // Peso dos quadros à direita e acima
+flat out vec4 ModelToWorld; // Quatérnio da rotação da instância
+flat out float Fade;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec3 viewPos;
+uniform vec4 plane; // Plano de corte para a água
+
+uniform vec3 impostorCenter; // Esfera envolvente do modelo, em unidades do modelo
+uniform float impostorRadius;
+uniform float impostorFrames; // Quadros por lado do atlas
+uniform float impostorFadeStart; // Faixa de distância em que a malha dá lugar ao impostor
+uniform float impostorFadeEnd;
+
+// Inversa de hemiOctDecode (ImpostorAtlas.cpp): direção com y >= 0 -> coordenada no atlas.
+vec2 hemiOctEncode(vec3 d)
+{
+    d /= abs(d.x) + abs(d.y) + abs(d.z);
+    return vec2(d.x + d.z, d.x - d.z) * 0.5 + 0.5;
+}
+
+// Rotaciona 'v' pelo quatérnio unitário 'q'.
+vec3 quatRotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+    // Rotação da instância (escala uniforme): leva direções do modelo para o mundo.
+    float scale = max(aInstanceScale.x, aInstanceScale.y);
+    vec4 rotation = normalize(aInstanceRotation);
+    vec3 center = aInstancePosition + quatRotate(rotation, impostorCenter * scale);
+
+    // Direção da câmera vista pelo modelo (rotação inversa = quatérnio conjugado), limitada ao
+    // hemisfério superior que o atlas cobre.
+    vec3 toCamera = quatRotate(vec4(-rotation.xyz, rotation.w), normalize(viewPos - center));
+    toCamera.y = max(toCamera.y, 0.0);
+    toCamera = normalize(toCamera + vec3(0.0, 1e-4, 0.0));
+
+    // A mesma base dos quadros do atlas (frameUp em ImpostorAtlas.cpp).
+    vec3 reference = abs(toCamera.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(reference, toCamera));
+    vec3 up = cross(toCamera, right);
+    vec3 corner = quatRotate(rotation, right * aPos.x + up * aPos.y) * impostorRadius * scale;
+    vec4 worldPosition = vec4(center + corner, 1.0);
+
+    // Os quatro quadros mais próximos da direção de visão, misturados bilinearmente.
+    vec2 grid = clamp(hemiOctEncode(toCamera) * impostorFrames - 0.5, 0.0, impostorFrames - 1.0);
+    Frame = min(floor(grid), vec2(impostorFrames - 2.0));
+    FrameBlend = grid - Frame;
+
+    FragPos = worldPosition.xyz;
+    TexCoords = aPos.xy * 0.5 + 0.5;
+    Layer = aLayer;
+    ModelToWorld = rotation;
+    Fade = clamp((distance(aInstancePosition, viewPos) - impostorFadeStart) / max(impostorFadeEnd - impostorFadeStart, 1e-4), 0.0, 1.0);
+
+    gl_ClipDistance[0] = dot(worldPosition, plane);
+    gl_Position = projection * view * worldPosition;
+}
@@ -0,0 +1,20 @@
+#version 460 core
+layout (location = 0) out vec4 Albedo;
+layout (location = 1) out vec4 NormalOut;
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform sampler2DArray texture_diffuse1; // Uma camada por variante
+uniform int layer;
+
+void main()
+{
+    // Mesmo recorte da vegetação; o alfa do atlas marca os texels cobertos pelo modelo.
+    vec4 texColor = texture(texture_diffuse1, vec3(TexCoords, layer));
+    if (texColor.a < 0.1)
+        discard;
+
+    Albedo = vec4(texColor.rgb, 1.0);
+    NormalOut = vec4(normalize(Normal) * 0.5 + 0.5, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 460 core
+// Renderiza o modelo num quadro do atlas de impostores (ver ImpostorAtlas::bake).
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec3 Normal;
+out vec2 TexCoords;
+
+uniform mat4 viewProjection; // Câmera ortográfica do quadro, em unidades do modelo
+uniform vec3 positionScale;  // Tamanho da caixa da malha, para vértices compactados (1 se não forem)
+uniform vec3 positionOffset; // Canto mínimo da caixa da malha (0 se não forem)
+
+void main()
+{
+    // A normal fica em unidades do modelo; o impostor a leva para o mundo com a rotação da instância.
+    Normal = aNormal;
+    TexCoords = aTexCoords;
+
+    // O plano de corte da água está habilitado: nada é cortado aqui.
+    gl_ClipDistance[0] = 1.0;
+
+    gl_Position = viewProjection * vec4(aPos * positionScale + positionOffset, 1.0);
+}
@@ -5,50 +5,43 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in float Height;
 
-// Texturas
-uniform sampler2D grassTexture;
-uniform sampler2D rockTexture;
-uniform sampler2D sandTexture;
-
-// Propriedades do material (terreno)
-uniform float terrainAmplitude;
+// Textura virtual da superfície (ver VirtualTexture)
+uniform sampler2D vtAtlas;      // Slots com as páginas residentes (e suas bordas)
+uniform usampler2D vtPageTable; // Um mipmap por nível: slot (rg) e nível (b) da página residente
+uniform float vtPagesPerSide;
+uniform float vtPageSize;
+uniform float vtBorder;
+uniform float vtAtlasSize;
+uniform int vtMaxLevel;
+uniform float vtLodBias;
 
 // Propriedades da luz
 uniform vec3 lightDir;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 
-void main()
+vec3 vtSample(vec2 uv)
 {
-    //Cor base a partir das texturas
-    vec3 grassColor = texture(grassTexture, TexCoords * 20.0).rgb;
-    vec3 rockColor = texture(rockTexture, TexCoords * 15.0).rgb;
-    vec3 sandColor = texture(sandTexture, TexCoords * 15.0).rgb;
-
-    //Lógica de mistura (Blend) em duas etapas
-    float height_normalized = (Height / terrainAmplitude + 1.0) / 2.0;
-
-    // Etapa 1: Misturar Areia e Grama nas altitudes baixas
-    // Define a faixa onde a areia faz a transição para a grama (ex: entre 20% e 30% da altura)
-    float sandToGrassFactor = smoothstep(0.20, 0.50, height_normalized);
-    vec3 sandGrassColor = mix(sandColor, grassColor, sandToGrassFactor);
+    // Nível pela densidade de texels virtuais por pixel, como no mipmap comum.
+    vec2 texelCoord = uv * vtPagesPerSide * vtPageSize;
+    float density = max(length(dFdx(texelCoord)), length(dFdy(texelCoord)));
+    int level = clamp(int(floor(log2(max(density, 1e-6)) + vtLodBias)), 0, vtMaxLevel);
 
-    // Etapa 2: Misturar o resultado (Areia/Grama) com a Rocha
-    // Fator de rocha baseado na INCLINAÇÃO
-    vec3 up = vec3(0.0, 1.0, 0.0);
-    float slopeFactor = 1.0 - dot(normalize(Normal), up);
-    slopeFactor = smoothstep(0.3, 0.6, slopeFactor); // Íngremes ficam mais rochosos
+    // A tabela já aponta para o ancestral residente mais próximo quando a página pedida falta.
+    float pagesAtLevel = vtPagesPerSide / float(1 << level);
+    uvec4 entry = texelFetch(vtPageTable, ivec2(clamp(uv, 0.0, 0.9999) * pagesAtLevel), level);
+    float pagesAtMapped = vtPagesPerSide / float(1u << entry.b);
 
-    // Fator de rocha baseado na ALTURA
-    float rockHeightFactor = smoothstep(0.6, 0.8, height_normalized); // Alturas elevadas ficam mais rochosas
+    vec2 inPage = fract(uv * pagesAtMapped);
+    vec2 texel = vec2(entry.rg) * (vtPageSize + 2.0 * vtBorder) + vtBorder + inPage * vtPageSize;
+    return textureLod(vtAtlas, texel / vtAtlasSize, 0.0).rgb;
+}
 
-    // Combina os dois fatores, dando prioridade para a inclinação
-    float finalRockFactor = clamp(rockHeightFactor + slopeFactor, 0.0, 1.0);
-
-    // Mistura final: (Areia(agua)/Grama) com a Rocha
-    vec3 terrainColor = mix(sandGrassColor, rockColor, finalRockFactor);
+void main()
+{
+    // Cor base: a mistura de areia, grama e rocha já vem composta nas páginas.
+    vec3 terrainColor = vtSample(TexCoords);
 
     //Iluminação (mesma lógica de antes)
     // Ambiente
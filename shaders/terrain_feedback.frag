@@ -0,0 +1,22 @@
+#version 460 core
+// Escreve a página da textura virtual que este pixel usaria (ver VirtualTexture::beginFeedback).
+layout (location = 0) out uint PageRequest;
+
+in vec2 TexCoords;
+
+uniform float vtPagesPerSide;
+uniform float vtPageSize;
+uniform int vtMaxLevel;
+uniform float vtLodBias;
+
+void main()
+{
+    // Mesmo cálculo de nível do terrain.frag, corrigido pela resolução menor do buffer.
+    vec2 texelCoord = TexCoords * vtPagesPerSide * vtPageSize;
+    float density = max(length(dFdx(texelCoord)), length(dFdy(texelCoord)));
+    int level = clamp(int(floor(log2(max(density, 1e-6)) + vtLodBias)), 0, vtMaxLevel);
+
+    float pagesAtLevel = vtPagesPerSide / float(1 << level);
+    uvec2 page = uvec2(clamp(TexCoords, 0.0, 0.9999) * pagesAtLevel);
+    PageRequest = (uint(level) << 28) | (page.y << 14) | page.x;
+}
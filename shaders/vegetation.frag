@@ -4,18 +4,30 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+flat in uint Layer;
+flat in float Fade;
 
-uniform sampler2D texture_diffuse1;
+uniform sampler2DArray texture_diffuse1; // Uma camada por variante
 
 // Propriedades da luz (recebidas do C++)
 uniform vec3 lightDir;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 
+// Limiar de dithering estável na tela (o mesmo de impostor.frag).
+float ditherThreshold()
+{
+    return fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+}
+
 void main()
 {
+    // Transição para o impostor: a malha some nos pixels em que ele aparece.
+    if (ditherThreshold() < Fade)
+        discard;
+
     // Amostra a cor da textura
-    vec4 texColor = texture(texture_diffuse1, TexCoords);
+    vec4 texColor = texture(texture_diffuse1, vec3(TexCoords, Layer));
 
     // Alpha testing: descarta fragmentos transparentes
     if(texColor.a < 0.1)
@@ -2,27 +2,49 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in mat4 aInstanceMatrix; // Matriz de instância
+layout (location = 3) in vec3 aInstancePosition; // Posição da instância
+layout (location = 4) in vec2 aInstanceScale;    // Escala nos eixos x/z e y do modelo
+layout (location = 5) in vec4 aInstanceRotation; // Quatérnio da rotação da instância
+layout (location = 6) in uint aLayer;            // Camada da textura array (variante da instância)
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out uint Layer;
+flat out float Fade; // 0 = malha inteira; 1 = já substituída pelo impostor
 
 uniform mat4 projection;
 uniform mat4 view;
+uniform vec3 positionScale;  // Tamanho da caixa da malha, para vértices compactados (1 se não forem)
+uniform vec3 positionOffset; // Canto mínimo da caixa da malha (0 se não forem)
 uniform vec4 plane; // Uniform para o plano de corte
+uniform vec3 viewPos;
+uniform float impostorFadeStart; // Faixa de distância em que a malha dá lugar ao impostor
+uniform float impostorFadeEnd;
+
+// Rotaciona 'v' pelo quatérnio unitário 'q'.
+vec3 quatRotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
 
 void main()
 {
-    // Calcula a posição no mundo usando a matriz da instância
-    vec4 worldPosition = aInstanceMatrix * vec4(aPos, 1.0);
+    // Calcula a posição no mundo com a escala, a rotação e a posição da instância
+    vec4 rotation = normalize(aInstanceRotation);
+    vec3 scale = aInstanceScale.xyx;
+    vec4 worldPosition = vec4(aInstancePosition + quatRotate(rotation, (aPos * positionScale + positionOffset) * scale), 1.0);
     FragPos = worldPosition.xyz;
 
-    // A normal também usa a matriz da instância
-    Normal = normalize(mat3(transpose(inverse(aInstanceMatrix))) * aNormal);
+    // A normal usa a inversa transposta, que para rotação e escala é só a rotação da normal dividida pela escala
+    Normal = normalize(quatRotate(rotation, aNormal / scale));
     
     TexCoords = aTexCoords;
     
+    Layer = aLayer;
+
+    Fade = clamp((distance(aInstancePosition, viewPos) - impostorFadeStart) / max(impostorFadeEnd - impostorFadeStart, 1e-4), 0.0, 1.0);
+    
     // Aplica o plano de corte
     gl_ClipDistance[0] = dot(worldPosition, plane);
     
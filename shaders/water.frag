@@ -42,8 +42,10 @@ void main()
     vec4 reflectColor = texture(reflectionTexture, reflectTexCoords);
     vec4 refractColor = texture(refractionTexture, refractTexCoords);
 
-    // Obtém a normal do normal map para iluminação detalhada
-    vec3 normal = normalize(texture(normalMap, textureCoords).rgb * 2.0 - 1.0);
+    // Obtém a normal do normal map para iluminação detalhada.
+    // A textura (BC5) guarda só X e Y; o Z, sempre positivo, é reconstruído pelo comprimento unitário.
+    vec2 normalXY = texture(normalMap, textureCoords).rg * 2.0 - 1.0;
+    vec3 normal = normalize(vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0))));
 
     //Calcula o fator Fresnel usando a aproximação de Schlick para misturar reflexão e refração
     // Ângulos rasos refletem mais, ângulos diretos refratam mais
@@ -0,0 +1,61 @@
+#include "AssetLoader.hpp"
+#include <chrono>
+#include <exception>
+
+AssetLoader::AssetLoader(unsigned int threadCount)
+    : m_pool(threadCount)
+{
+}
+
+void AssetLoader::submit(std::function<Upload()> work)
+{
+    ++m_pending;
+    m_pool.submit([this, work = std::move(work)]()
+                  {
+                      Upload upload;
+                      try
+                      {
+                          upload = work();
+                      }
+                      catch (...)
+                      {
+                          std::exception_ptr error = std::current_exception();
+                          upload = [error]() { std::rethrow_exception(error); };
+                      }
+
+                      std::lock_guard<std::mutex> lock(m_mutex);
+                      m_uploads.push_back(std::move(upload)); });
+}
+
+size_t AssetLoader::processUploads(double budgetMs)
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t executed = 0;
+    for (;;)
+    {
+        Upload upload;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_uploads.empty())
+                break;
+            upload = std::move(m_uploads.front());
+            m_uploads.pop_front();
+        }
+
+        // Decrementa mesmo se o envio lançar uma exceção.
+        struct PendingGuard
+        {
+            std::atomic<int> &pending;
+            ~PendingGuard() { --pending; }
+        } guard{m_pending};
+
+        if (upload)
+            upload();
+        ++executed;
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs)
+            break;
+    }
+    return executed;
+}
@@ -0,0 +1,252 @@
+#include "GeometryArena.hpp"
+#include "worldgen/MeshData.hpp"
+#include "worldgen/Placement.hpp"
+#include "worldgen/VertexQuantizer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    // Capacidade inicial dos buffers de cada formato, em elementos. Crescem em dobro quando enchem.
+    const uint32_t INITIAL_VERTEX_CAPACITY = 1u << 16;
+    const uint32_t INITIAL_INDEX_CAPACITY = 1u << 18;
+
+    // Pontos de vínculo (binding points) dos VAOs: vértices da malha e dados de instância.
+    const GLuint VERTEX_BINDING = 0;
+    const GLuint INSTANCE_BINDING = 1;
+}
+
+/**
+ * @brief Cria os VAOs de cada formato. Os buffers só são criados na primeira alocação.
+ */
+GeometryArena::GeometryArena()
+{
+    for (int i = 0; i < FORMAT_COUNT; ++i)
+    {
+        VertexFormat format = static_cast<VertexFormat>(i);
+        Pool &pool = m_pools[i];
+        pool.stride = vertexStride(format);
+
+        glGenVertexArrays(1, &pool.VAO);
+        glBindVertexArray(pool.VAO);
+        setupAttributes(format, false);
+
+        glGenVertexArrays(1, &pool.instancedVAO);
+        glBindVertexArray(pool.instancedVAO);
+        setupAttributes(format, true);
+    }
+    glBindVertexArray(0);
+}
+
+GeometryArena::~GeometryArena()
+{
+    for (Pool &pool : m_pools)
+    {
+        if (pool.vertices.used() > 0 || pool.indices.used() > 0)
+            std::cerr << "Aviso: malhas ainda alocadas ao destruir a GeometryArena" << std::endl;
+
+        glDeleteVertexArrays(1, &pool.VAO);
+        glDeleteVertexArrays(1, &pool.instancedVAO);
+        glDeleteBuffers(1, &pool.VBO);
+        glDeleteBuffers(1, &pool.EBO);
+    }
+}
+
+GLsizei GeometryArena::vertexStride(VertexFormat format)
+{
+    switch (format)
+    {
+    case VertexFormat::Packed:
+        return sizeof(worldgen::PackedVertex);
+    case VertexFormat::Position:
+        return 3 * sizeof(float);
+    case VertexFormat::Float:
+    default:
+        return sizeof(Vertex);
+    }
+}
+
+/**
+ * @brief Descreve o layout do formato com vínculos separados (glVertexAttribFormat), de modo que
+ * trocar o buffer depois de um crescimento só exige um glBindVertexBuffer.
+ */
+void GeometryArena::setupAttributes(VertexFormat format, bool instanced)
+{
+    switch (format)
+    {
+    case VertexFormat::Float:
+        // Posição (0), Normal (1) e Coordenadas de Textura (2) em float.
+        glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Position));
+        glVertexAttribFormat(1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Normal));
+        glVertexAttribFormat(2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords));
+        break;
+    case VertexFormat::Packed:
+        // A GPU converte os formatos compactados durante a leitura: a posição chega ao shader em [0, 1]
+        // e é reconstruída com positionScale/positionOffset; normal e UV chegam prontas.
+        // Posição: 3 x unorm16. Normal: snorm 10_10_10_2, que exige 4 componentes (w é ignorado). UV: 2 x half float.
+        glVertexAttribFormat(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(worldgen::PackedVertex, Position));
+        glVertexAttribFormat(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(worldgen::PackedVertex, Normal));
+        glVertexAttribFormat(2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(worldgen::PackedVertex, TexCoords));
+        break;
+    case VertexFormat::Position:
+        glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0);
+        break;
+    }
+
+    GLuint attributeCount = format == VertexFormat::Position ? 1 : 3;
+    for (GLuint attribute = 0; attribute < attributeCount; ++attribute)
+    {
+        glVertexAttribBinding(attribute, VERTEX_BINDING);
+        glEnableVertexAttribArray(attribute);
+    }
+
+    if (instanced)
+        setupInstanceAttributes(INSTANCE_BINDING);
+}
+
+void GeometryArena::setupInstanceAttributes(GLuint binding)
+{
+    // Posição, escala e rotação (o quatérnio em snorm16 chega ao shader já convertido para [-1, 1]),
+    // atualizados uma vez por instância.
+    glVertexAttribFormat(3, 3, GL_FLOAT, GL_FALSE, offsetof(worldgen::InstanceData, position));
+    glVertexAttribFormat(4, 2, GL_FLOAT, GL_FALSE, offsetof(worldgen::InstanceData, scale));
+    glVertexAttribFormat(5, 4, GL_SHORT, GL_TRUE, offsetof(worldgen::InstanceData, rotation));
+    // A camada da textura array chega ao shader como inteiro (uint), sem conversão para float.
+    glVertexAttribIFormat(6, 1, GL_UNSIGNED_INT, offsetof(worldgen::InstanceData, layer));
+    for (GLuint attribute = 3; attribute <= 6; ++attribute)
+    {
+        glVertexAttribBinding(attribute, binding);
+        glEnableVertexAttribArray(attribute);
+    }
+    glVertexBindingDivisor(binding, 1);
+}
+
+MeshRange GeometryArena::allocate(VertexFormat format, const void *vertices, uint32_t vertexCount, const unsigned int *indices, uint32_t indexCount)
+{
+    Pool &pool = m_pools[static_cast<int>(format)];
+
+    MeshRange range;
+    range.format = format;
+    if (vertexCount == 0 || indexCount == 0)
+        return range; // Malha vazia: nada a alocar nem a desenhar.
+
+    range.vertexCount = vertexCount;
+    range.indexCount = indexCount;
+    range.baseVertex = allocateRange(pool, pool.vertices, pool.VBO, pool.stride, vertexCount);
+    range.firstIndex = allocateRange(pool, pool.indices, pool.EBO, sizeof(unsigned int), indexCount);
+
+    // GL_COPY_WRITE_BUFFER não faz parte do estado do VAO, então o envio não altera o VAO vinculado.
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.baseVertex) * pool.stride,
+                    static_cast<GLsizeiptr>(vertexCount) * pool.stride, vertices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.firstIndex) * sizeof(unsigned int),
+                    static_cast<GLsizeiptr>(indexCount) * sizeof(unsigned int), indices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return range;
+}
+
+/**
+ * @brief Reserva um intervalo no alocador; se não couber, cria um buffer maior, copia o conteúdo
+ * antigo na própria GPU (glCopyBufferSubData) e aponta os VAOs para ele.
+ */
+uint32_t GeometryArena::allocateRange(Pool &pool, worldgen::RangeAllocator &allocator, unsigned int &buffer, size_t elementSize, uint32_t count)
+{
+    uint32_t offset = allocator.allocate(count);
+    if (offset != worldgen::RangeAllocator::INVALID_OFFSET)
+        return offset;
+
+    uint32_t oldCapacity = allocator.capacity();
+    uint32_t initialCapacity = &allocator == &pool.vertices ? INITIAL_VERTEX_CAPACITY : INITIAL_INDEX_CAPACITY;
+    // O espaço novo fica no fim e se funde com o bloco livre final, então oldCapacity + count sempre basta.
+    uint32_t newCapacity = std::max({initialCapacity, oldCapacity * 2, oldCapacity + count});
+
+    unsigned int newBuffer;
+    glGenBuffers(1, &newBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newCapacity) * elementSize, nullptr, GL_STATIC_DRAW);
+    if (buffer != 0)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldCapacity) * elementSize);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    buffer = newBuffer;
+
+    allocator.grow(newCapacity);
+    attachBuffers(pool);
+    return allocator.allocate(count);
+}
+
+void GeometryArena::attachBuffers(Pool &pool)
+{
+    for (unsigned int vao : {pool.VAO, pool.instancedVAO})
+    {
+        glBindVertexArray(vao);
+        glBindVertexBuffer(VERTEX_BINDING, pool.VBO, 0, pool.stride);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+    }
+    glBindVertexArray(m_boundVAO);
+}
+
+void GeometryArena::free(MeshRange &range)
+{
+    Pool &pool = m_pools[static_cast<int>(range.format)];
+    pool.vertices.free(range.baseVertex, range.vertexCount);
+    pool.indices.free(range.firstIndex, range.indexCount);
+    range.vertexCount = 0;
+    range.indexCount = 0;
+}
+
+void GeometryArena::bindVertexArray(unsigned int vao)
+{
+    if (vao != m_boundVAO)
+    {
+        glBindVertexArray(vao);
+        m_boundVAO = vao;
+    }
+}
+
+void GeometryArena::bind(VertexFormat format)
+{
+    bindVertexArray(m_pools[static_cast<int>(format)].VAO);
+}
+
+void GeometryArena::bindInstanced(VertexFormat format, unsigned int instanceVBO)
+{
+    bindVertexArray(m_pools[static_cast<int>(format)].instancedVAO);
+    glBindVertexBuffer(INSTANCE_BINDING, instanceVBO, 0, INSTANCE_STRIDE);
+}
+
+void GeometryArena::draw(const MeshRange &range, uint32_t firstIndex, uint32_t indexCount, GLenum mode) const
+{
+    glDrawElementsBaseVertex(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                             (void *)((static_cast<size_t>(range.firstIndex) + firstIndex) * sizeof(unsigned int)), static_cast<GLint>(range.baseVertex));
+}
+
+void GeometryArena::drawInstanced(const MeshRange &range, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance) const
+{
+    glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                                                  (void *)((static_cast<size_t>(range.firstIndex) + firstIndex) * sizeof(unsigned int)),
+                                                  static_cast<GLsizei>(instanceCount), static_cast<GLint>(range.baseVertex), baseInstance);
+}
+
+void GeometryArena::printStats() const
+{
+    const char *names[FORMAT_COUNT] = {"float", "compactado", "posicao"};
+    std::cout << "Arena de geometria:" << std::endl;
+    for (int i = 0; i < FORMAT_COUNT; ++i)
+    {
+        const Pool &pool = m_pools[i];
+        if (pool.vertices.capacity() == 0)
+            continue;
+        size_t usedBytes = static_cast<size_t>(pool.vertices.used()) * pool.stride + static_cast<size_t>(pool.indices.used()) * sizeof(unsigned int);
+        size_t capacityBytes = static_cast<size_t>(pool.vertices.capacity()) * pool.stride + static_cast<size_t>(pool.indices.capacity()) * sizeof(unsigned int);
+        std::cout << "  " << names[i] << ": " << pool.vertices.used() << "/" << pool.vertices.capacity() << " vertices, "
+                  << pool.indices.used() << "/" << pool.indices.capacity() << " indices, "
+                  << usedBytes / 1024 << "/" << capacityBytes / 1024 << " KB, "
+                  << pool.vertices.freeBlockCount() + pool.indices.freeBlockCount() << " blocos livres" << std::endl;
+    }
+}
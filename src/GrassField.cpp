@@ -1,173 +1,255 @@
 #include "GrassField.hpp"
-#include <cstdlib>
+#include <algorithm>
+#include <climits>
 #include <iostream>
-#include "stb_image.h"
+
+namespace
+{
+    // Slots além dos ladrilhos dos anéis: um ladrilho que muda de densidade continua desenhado
+    // até a sua nova versão chegar, e os pedidos não esperam os ladrilhos antigos saírem.
+    const size_t SPARE_SLOTS = 24;
+    // Ladrilhos em geração ao mesmo tempo, para não ocupar todas as threads do loader.
+    const int MAX_LOADING_TILES = 8;
+}
 
 /**
  * @brief Construtor da classe GrassField.
- * @param terrain Referência ao objeto de terreno onde a grama será colocada.
  * @param shader Referência ao shader que será usado para renderizar a grama.
+ * @param resources Gerenciador que fornece o modelo e a textura (compartilhados).
  * @param modelPath Caminho para o arquivo do modelo 3D da grama.
- * @param texturePath Caminho para o arquivo de textura da grama.
- * @param spacing O espaçamento entre cada possível tufo de grama.
+ * @param texturePaths Caminhos das texturas das variantes de grama (mesmo tamanho e formato), uma camada cada.
+ * @param heightfield O terreno sobre o qual os ladrilhos são gerados.
+ * @param loader O carregador cujas threads geram os ladrilhos.
+ * @param cullShader Programa de culling na GPU, ou nulo para descartar ladrilhos inteiros na CPU.
  */
-GrassField::GrassField(Terrain &terrain, Shader &shader, const std::string &modelPath, const std::string &texturePath, float spacing)
-    : terrain(terrain), shader(shader), spacing(spacing), grassModel(modelPath, texturePath)
+GrassField::Uniforms::Uniforms(const Shader &shader)
+    : view(shader.uniform<glm::mat4>("view")), projection(shader.uniform<glm::mat4>("projection")),
+      textureDiffuse(shader.uniform<int>("texture_diffuse1")), position(shader)
 {
+}
+
+GrassField::GrassField(Shader &shader, ResourceManager &resources, const std::string &modelPath, const std::vector<std::string> &texturePaths,
+                       std::shared_ptr<const worldgen::Heightfield> heightfield, AssetLoader &loader, Shader *cullShader)
+    : shader(shader), uniforms(shader), grassModel(resources.getModel(modelPath, "", VertexFormat::Packed)),
+      grassTextures(resources.getTextureArray(texturePaths)), heightfield(std::move(heightfield)), loader(loader)
+{
+    slots.resize(params.tileCount() + SPARE_SLOTS);
     setupInstancing();
+
+    // A grama usa apenas a malha completa (LOD 0). Os tufos além do último anel já não existem.
+    // Até o primeiro ladrilho ficar pronto, o culler não testa nenhum trecho do pool.
+    float maxDistance = params.tileSize * (params.radius + 1) * 1.5f;
+    if (cullShader)
+    {
+        culler = std::make_unique<InstanceCuller>(*cullShader, instanceVBO, static_cast<uint32_t>(slots.size() * params.tileCapacity()), *grassModel, 1,
+                                                  maxDistance);
+        updateCullRanges();
+    }
 }
 
 /**
  * @brief Destrutor da classe GrassField.
- * Libera o buffer de VBO da instância para evitar vazamentos de memória na GPU.
+ * Libera o VBO das instâncias para evitar vazamentos de memória na GPU.
  */
 GrassField::~GrassField()
 {
-    if (!instanceMatrices.empty())
-    {
-        glDeleteBuffers(1, &instanceVBO);
-    }
+    glDeleteBuffers(1, &instanceVBO);
 }
 
 /**
- * @brief Configura e gera todas as instâncias de grama no cenário.
- * Esta função utiliza Ruído de Perlin para determinar a posição e a escala
- * de cada tufo de grama, resultando em uma distribuição natural.
+ * @brief Reserva o buffer do pool, de tamanho fixo. Só os primeiros 'count' tufos de cada slot pronto
+ * são lidos, pelo desenho na CPU ou pelo culling na GPU (ver updateCullRanges).
+ * Os atributos de instância ficam no VAO instanciado da GeometryArena, compartilhado com os outros
+ * modelos do mesmo formato.
  */
 void GrassField::setupInstancing()
 {
-    // Parâmetros para a Geração Procedural da Grama
-
-    // Define um limite máximo de instâncias para garantir a performance.
-    const unsigned int maxGrassInstances = 10000;
-    unsigned int currentInstanceCount = 0;
-
-    // A frequência do ruído controla a aparência dos "aglomerados" de grama.
-    // Valores maiores criam padrões menores e mais detalhados.
-    // Valores menores criam padrões maiores e mais suaves, como grandes clareiras.
-    float densityNoiseFrequency = 0.01f;
-    float heightNoiseFrequency = 10.0f;
-
-    // O limiar de densidade define quão "cheio" o campo de grama será.
-    // O Ruído de Perlin gera valores entre -1.0 e 1.0. A grama só será
-    // instanciada se o valor do ruído for maior que este limiar.
-    // Aumente o valor para criar mais clareiras; diminua para um campo mais denso.
-    float densityThreshold = 0.2f;
-
-    // Itera sobre a grade do terreno para posicionar a grama.
-    for (float x = 0; x < terrain.getWidth(); x += spacing)
+    size_t bytes = slots.size() * params.tileCapacity() * sizeof(worldgen::InstanceData);
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+
+    size_t megabytes = bytes / (1024 * 1024);
+    std::cout << "Grama: " << slots.size() << " ladrilhos de ate " << params.tileCapacity() << " tufos (" << megabytes << " MB)" << std::endl;
+}
+
+bool GrassField::isDesired(const worldgen::GrassTileKey &key) const
+{
+    return std::find(desiredTiles.begin(), desiredTiles.end(), key) != desiredTiles.end();
+}
+
+int GrassField::acquireSlot() const
+{
+    int fallback = -1;
+    for (size_t i = 0; i < slots.size(); ++i)
     {
-        for (float z = 0; z < terrain.getDepth(); z += spacing)
+        if (slots[i].state == Slot::Free)
+            return static_cast<int>(i);
+        // Um ladrilho fora dos anéis. Se ele só mudou de densidade, continua desenhado até ser substituído.
+        if (slots[i].state == Slot::Resident && !isDesired(slots[i].key))
         {
-            // Interrompe a geração se atingirmos o limite de instâncias.
-            if (currentInstanceCount >= maxGrassInstances)
-                break;
-
-            // Lógica de Posicionamento por Altura
-            // A grama só crescerá em faixas de altura específicas do terreno.
-            float height = terrain.getHeight(x, z);
-            float terrainAmplitude = 50.0f; // Deve ser o mesmo valor usado na geração do terreno.
-            float height_normalized = (height / terrainAmplitude + 1.0f) / 2.0f;
-
-            // Condição para que a grama cresça apenas em altitudes médias, evitando praias e picos de montanhas.
-            if (height_normalized >= 0.4f && height_normalized < 0.7f)
-            {
-                // Lógica de Instanciação com Ruído de Perlin
-
-                // 1. Calcula o ruído de densidade para a posição atual.
-                // Convertemos as coordenadas para o espaço do mundo para que o padrão de ruído
-                // seja consistente e não dependa do 'spacing'.
-                float worldX = x - terrain.getWidth() / 2.0f;
-                float worldZ = z - terrain.getDepth() / 2.0f;
-                float densityNoise = db::perlin(worldX * densityNoiseFrequency, worldZ * densityNoiseFrequency);
-
-                // 2. Verifica se o valor do ruído ultrapassa nosso limiar de densidade.
-                if (densityNoise > densityThreshold)
-                {
-                    // Se sim, criamos uma instância de grama neste local.
-                    // A matriz 'model' inicial apenas posiciona a grama no ponto correto.
-                    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(worldX, height, worldZ));
-
-                    // 3. Utiliza um segundo ruído para variar a altura da grama.
-                    // Isso evita que todos os tufos tenham o mesmo tamanho, adicionando realismo.
-                    float heightNoise = db::perlin(worldX * heightNoiseFrequency, worldZ * heightNoiseFrequency);
-
-                    // Mapeia o valor do ruído (de [-1, 1]) para um intervalo de escala desejado (ex: [0.005, 0.01]).
-                    float minHeight = 0.000001f;
-                    float maxHeight = 0.02f;
-                    float height_scale = minHeight + (heightNoise + 1.0f) / 2.0f * (maxHeight - minHeight);
-
-                    // A variação da largura é feita com um valor aleatório simples para maior variedade.
-                    float width_scale = 0.009f + static_cast<float>(rand()) / RAND_MAX * 0.0005f;
-
-                    // Aplica a escala à matriz do modelo e a armazena.
-                    model = glm::scale(model, glm::vec3(width_scale, height_scale, width_scale));
-                    instanceMatrices.push_back(model);
-                    currentInstanceCount++;
-                }
-            }
+            bool replaced = std::any_of(desiredTiles.begin(), desiredTiles.end(), [&](const worldgen::GrassTileKey &key)
+                                        { return key.sameTile(slots[i].key); });
+            if (!replaced)
+                return static_cast<int>(i);
+            if (fallback < 0)
+                fallback = static_cast<int>(i);
         }
-        if (currentInstanceCount >= maxGrassInstances)
-            break;
     }
+    return fallback;
+}
 
-    //std::cout << "Numero de tufos de grama gerados: " << instanceMatrices.size() << std::endl;
+/**
+ * @brief Recalcula os anéis quando a câmera muda de ladrilho e pede os que faltam.
+ * Cada pedido reserva um slot; o ladrilho é gerado numa thread do loader e copiado para o
+ * slot na thread principal, em processUploads().
+ */
+void GrassField::update(const glm::vec3 &cameraPos)
+{
+    glm::ivec2 tile(static_cast<int>(std::floor(cameraPos.x / params.tileSize)), static_cast<int>(std::floor(cameraPos.z / params.tileSize)));
+    if (tile != cameraTile)
+    {
+        cameraTile = tile;
+        desiredTiles = worldgen::desiredGrassTiles(*heightfield, cameraPos, params);
+    }
 
-    // Se nenhuma instância foi gerada, não há necessidade de configurar os buffers.
-    if (instanceMatrices.empty())
+    bool acquired = false;
+    for (const worldgen::GrassTileKey &key : desiredTiles)
     {
-        return;
+        if (loadingTiles >= MAX_LOADING_TILES)
+            break;
+        bool present = std::any_of(slots.begin(), slots.end(), [&](const Slot &slot)
+                                   { return slot.state != Slot::Free && slot.key == key; });
+        if (present)
+            continue;
+        int slot = acquireSlot();
+        if (slot < 0)
+            break;
+
+        // O slot deixa de ser desenhado e testado até a cópia do novo ladrilho.
+        slots[slot].state = Slot::Loading;
+        slots[slot].key = key;
+        slots[slot].count = 0;
+        ++loadingTiles;
+        acquired = true;
+
+        std::shared_ptr<const worldgen::Heightfield> terrain = heightfield;
+        worldgen::GrassStreamingParams tileParams = params;
+        worldgen::Aabb modelBounds = grassModel->getBounds();
+        uint32_t layerCount = grassTextures->getLayerCount();
+        loader.submit([this, slot, terrain, key, tileParams, modelBounds, layerCount]()
+                      {
+            auto tile = std::make_shared<worldgen::GrassTile>(worldgen::placeGrassTile(*terrain, key, tileParams, modelBounds, layerCount));
+            return AssetLoader::Upload([this, slot, tile]()
+                                       { uploadTile(static_cast<size_t>(slot), *tile); }); });
     }
+    if (acquired)
+        updateCullRanges();
+}
 
-    // Configuração dos Buffers para Renderização Instanciada
-    //  Enviamos todas as matrizes de modelo para a GPU de uma só vez.
-    glGenBuffers(1, &instanceVBO);
+void GrassField::uploadTile(size_t slot, const worldgen::GrassTile &tile)
+{
+    --loadingTiles;
+    uint32_t count = static_cast<uint32_t>(tile.instances.size());
     glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, instanceMatrices.size() * sizeof(glm::mat4), &instanceMatrices[0], GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * params.tileCapacity() * sizeof(worldgen::InstanceData), count * sizeof(worldgen::InstanceData),
+                    tile.instances.data());
 
-    // Agora, configuramos os atributos de vértice no VAO do modelo da grama.
-    glBindVertexArray(grassModel.getVAO());
+    Slot &target = slots[slot];
+    target.state = Slot::Resident;
+    target.count = count;
+    target.bounds = tile.bounds;
 
-    // Uma matriz mat4 é, na verdade, composta por 4 vec4.
-    // Precisamos configurar um atributo de vértice para cada uma dessas colunas.
-    std::size_t vec4Size = sizeof(glm::vec4);
-    for (unsigned int i = 0; i < 4; i++)
+    // A versão anterior do mesmo ladrilho (com outra densidade) sai de cena agora.
+    for (size_t i = 0; i < slots.size(); ++i)
     {
-        // Habilita os atributos de vértice a partir da localização 3 (0, 1, 2 já são usados para posição, normais, etc.).
-        glEnableVertexAttribArray(3 + i);
-        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(i * vec4Size));
+        if (i != slot && slots[i].state == Slot::Resident && slots[i].key.sameTile(tile.key))
+            slots[i].state = Slot::Free;
+    }
+    updateCullRanges();
+}
 
-        // Informa ao OpenGL que este atributo deve ser atualizado por instância, não por vértice.
-        glVertexAttribDivisor(3 + i, 1);
+void GrassField::updateCullRanges()
+{
+    if (!culler)
+        return;
+    std::vector<worldgen::InstanceRange> ranges;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i].state != Slot::Resident || slots[i].count == 0)
+            continue;
+        uint32_t first = static_cast<uint32_t>(i * params.tileCapacity());
+        // Um slot cheio seguido do próximo: o intervalo anterior continua.
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == first)
+            ranges.back().count += slots[i].count;
+        else
+            ranges.push_back({first, slots[i].count});
     }
-    glBindVertexArray(0);
+    culler->setSourceRanges(std::move(ranges));
 }
 
 /**
- * @brief Desenha todas as instâncias de grama na tela.
+ * @brief Desenha as instâncias de grama visíveis na tela.
  * @param view A matriz de visão da câmera.
  * @param projection A matriz de projeção da câmera.
+ * @param clipPlane O plano de corte da passada (vec4(0) se não houver).
+ * @param stats Se não for nulo, acumula as instâncias enviadas e descartadas e o número de desenhos.
+ * @param maxDistance Distância máxima da passada.
  */
-void GrassField::Draw(const glm::mat4 &view, const glm::mat4 &projection)
+void GrassField::Draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec4 &clipPlane, worldgen::CullStats *stats, float maxDistance)
 {
-    // Não tenta desenhar se não houver grama para renderizar.
-    if (instanceMatrices.empty())
+    // Não tenta desenhar se ainda não houver nenhum ladrilho pronto.
+    if (std::none_of(slots.begin(), slots.end(), [](const Slot &slot)
+                     { return slot.state == Slot::Resident; }))
     {
         return;
     }
 
+    // Na GPU, o culling roda antes de o shader da grama ser ativado (o compute shader usa o seu próprio programa).
+    // Com um único LOD, a altura do alvo não muda a escolha.
+    if (culler)
+        culler->cull(view, projection, 1.0f, clipPlane, 1.0f, maxDistance);
+
     // Ativa e configura o shader da grama com as matrizes e texturas necessárias.
     shader.use();
-    shader.setMat4("view", view);
-    shader.setMat4("projection", projection);
-    shader.setInt("texture_diffuse1", 0);
+    uniforms.view.set(view);
+    uniforms.projection.set(projection);
+    uniforms.textureDiffuse.set(0);
+    grassModel->setPositionUniforms(uniforms.position);
 
-    // Ativa a unidade de textura e vincula a textura correta da grama.
+    // Ativa a unidade de textura e vincula a textura array com todas as variantes de grama.
     glActiveTexture(GL_TEXTURE0);
-    grassModel.bindTexture();
+    grassTextures->bind();
+
+    if (culler)
+    {
+        // As contagens ficam na GPU: um único desenho indireto, sem leitura de volta.
+        size_t draws = culler->draw(*grassModel);
+        if (stats)
+        {
+            stats->gpuTested += culler->testedCount();
+            stats->draws += draws;
+        }
+        return;
+    }
 
-    // Desenha todas as instâncias de grama com uma única chamada de renderização.
-    glBindVertexArray(grassModel.getVAO());
-    glDrawElementsInstanced(GL_TRIANGLES, grassModel.getIndicesCount(), GL_UNSIGNED_INT, 0, instanceMatrices.size());
-    glBindVertexArray(0);
+    // Apenas os ladrilhos prontos dentro do frustum, um desenho cada, com qualquer variante.
+    worldgen::Frustum frustum = worldgen::Frustum::fromMatrix(projection * view, clipPlane);
+    glm::vec3 cameraPos = glm::vec3(glm::inverse(view)[3]);
+    grassModel->bindInstanced(instanceVBO);
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        const Slot &slot = slots[i];
+        if (slot.state != Slot::Resident || slot.count == 0)
+            continue;
+        bool visible = frustum.intersects(slot.bounds) && slot.bounds.distanceTo(cameraPos) <= maxDistance;
+        if (visible)
+            grassModel->drawLodInstanced(0, slot.count, static_cast<unsigned int>(i * params.tileCapacity()));
+        if (stats)
+        {
+            stats->submitted += visible ? slot.count : 0;
+            stats->culled += visible ? 0 : slot.count;
+            stats->draws += visible ? 1 : 0;
+        }
+    }
 }
\ No newline at end of file
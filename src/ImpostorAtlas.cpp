@@ -0,0 +1,178 @@
+#include "ImpostorAtlas.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    /**
+     * @brief Direção (hemisfério superior, y >= 0) no centro de um ponto do atlas hemi-octaédrico.
+     * Mesma conversão de hemiOctDecode em shaders/impostor.vert.
+     */
+    glm::vec3 hemiOctDecode(glm::vec2 uv)
+    {
+        glm::vec2 e = uv * 2.0f - 1.0f;
+        float x = (e.x + e.y) * 0.5f;
+        float z = (e.x - e.y) * 0.5f;
+        return glm::normalize(glm::vec3(x, 1.0f - std::fabs(x) - std::fabs(z), z));
+    }
+
+    // Vetor "para cima" do quadro visto de 'direction', o mesmo usado no vertex shader do impostor.
+    glm::vec3 frameUp(const glm::vec3 &direction)
+    {
+        glm::vec3 reference = std::fabs(direction.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::vec3 right = glm::normalize(glm::cross(reference, direction));
+        return glm::cross(direction, right);
+    }
+
+    const unsigned int QUAD_INDICES[6] = {0, 1, 2, 0, 2, 3};
+    const float QUAD_VERTICES[12] = {-1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f};
+}
+
+ImpostorAtlas::ImpostorAtlas(Model &model, const TextureArray &textures, Shader &bakeShader, GeometryArena &geometry, int framesPerSide, int frameSize)
+    : m_geometry(geometry), m_framesPerSide(framesPerSide), m_frameSize(frameSize), m_layerCount(textures.getLayerCount())
+{
+    const worldgen::Aabb &bounds = model.getBounds();
+    if (!bounds.empty())
+    {
+        m_center = (bounds.min + bounds.max) * 0.5f;
+        m_radius = glm::length(bounds.max - bounds.min) * 0.5f;
+    }
+
+    m_quad = m_geometry.allocate(VertexFormat::Position, QUAD_VERTICES, 4, QUAD_INDICES, 6);
+    bake(model, textures, bakeShader);
+}
+
+ImpostorAtlas::~ImpostorAtlas()
+{
+    m_geometry.free(m_quad);
+    glDeleteTextures(1, &m_albedo);
+    glDeleteTextures(1, &m_normal);
+}
+
+/**
+ * @brief Renderiza o modelo de cada direção, com projeção ortográfica do tamanho da esfera envolvente,
+ * no quadro correspondente de cada camada, e gera os mipmaps do atlas.
+ */
+void ImpostorAtlas::bake(Model &model, const TextureArray &textures, Shader &bakeShader)
+{
+    int size = m_framesPerSide * m_frameSize;
+    int levels = 1 + static_cast<int>(std::floor(std::log2(static_cast<float>(size))));
+
+    for (unsigned int *texture : {&m_albedo, &m_normal})
+    {
+        glGenTextures(1, texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, *texture);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, size, size, m_layerCount);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    // Cada nível tem 1/4 do anterior: o total é cerca de 4/3 do nível 0.
+    m_byteSize = static_cast<size_t>(size) * size * 4 * m_layerCount * 2 * 4 / 3;
+
+    GLint previousFramebuffer;
+    GLint previousViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+    unsigned int framebuffer, depth;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    bakeShader.use();
+    bakeShader.setInt("texture_diffuse1", 0);
+    glActiveTexture(GL_TEXTURE0);
+    textures.bind();
+
+    // A câmera de cada quadro fica fora da esfera, olhando para o centro; a caixa ortográfica cobre o diâmetro.
+    glm::mat4 projection = glm::ortho(-m_radius, m_radius, -m_radius, m_radius, 0.0f, 4.0f * m_radius);
+    const GLfloat clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (unsigned int layer = 0; layer < m_layerCount; ++layer)
+    {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_albedo, 0, layer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_normal, 0, layer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cerr << "ERRO::IMPOSTOR:: framebuffer do atlas incompleto" << std::endl;
+            break;
+        }
+        glViewport(0, 0, size, size);
+        glClearBufferfv(GL_COLOR, 0, clearColor);
+        glClearBufferfv(GL_COLOR, 1, clearColor);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        bakeShader.setInt("layer", static_cast<int>(layer));
+
+        for (int y = 0; y < m_framesPerSide; ++y)
+        {
+            for (int x = 0; x < m_framesPerSide; ++x)
+            {
+                glm::vec3 direction = hemiOctDecode((glm::vec2(x, y) + 0.5f) / static_cast<float>(m_framesPerSide));
+                glm::mat4 view = glm::lookAt(m_center + direction * (2.0f * m_radius), m_center, frameUp(direction));
+                bakeShader.setMat4("viewProjection", projection * view);
+                glViewport(x * m_frameSize, y * m_frameSize, m_frameSize, m_frameSize);
+                model.Draw(bakeShader);
+            }
+        }
+    }
+
+    for (unsigned int texture : {m_albedo, m_normal})
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+ImpostorAtlas::Uniforms::Uniforms(const Shader &shader)
+    : albedo(shader.uniform<int>("impostorAlbedo")), normal(shader.uniform<int>("impostorNormal")),
+      frames(shader.uniform<float>("impostorFrames")), center(shader.uniform<glm::vec3>("impostorCenter")),
+      radius(shader.uniform<float>("impostorRadius"))
+{
+}
+
+void ImpostorAtlas::bind(const Uniforms &uniforms, int albedoUnit, int normalUnit) const
+{
+    glActiveTexture(GL_TEXTURE0 + albedoUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_albedo);
+    glActiveTexture(GL_TEXTURE0 + normalUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_normal);
+
+    uniforms.albedo.set(albedoUnit);
+    uniforms.normal.set(normalUnit);
+    uniforms.frames.set(static_cast<float>(m_framesPerSide));
+    uniforms.center.set(m_center);
+    uniforms.radius.set(m_radius);
+}
+
+void ImpostorAtlas::bindInstanced(unsigned int instanceVBO)
+{
+    m_geometry.bindInstanced(VertexFormat::Position, instanceVBO);
+}
+
+void ImpostorAtlas::drawInstanced(unsigned int instanceCount, unsigned int baseInstance) const
+{
+    m_geometry.drawInstanced(m_quad, 0, m_quad.indexCount, instanceCount, baseInstance);
+}
+
+DrawElementsIndirectCommand ImpostorAtlas::indirectCommand() const
+{
+    return {m_quad.indexCount, 0, m_quad.firstIndex, static_cast<int32_t>(m_quad.baseVertex), 0};
+}
+
+void ImpostorAtlas::drawIndirect(size_t byteOffset) const
+{
+    glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void *)byteOffset);
+}
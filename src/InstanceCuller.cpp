@@ -0,0 +1,168 @@
+#include "InstanceCuller.hpp"
+#include "worldgen/Culling.hpp"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    // Precisa ser igual a MAX_LODS e ao local_size_x de shaders/cull_instances.comp.
+    const size_t MAX_LODS = 8;
+    const GLuint WORKGROUP_SIZE = 64;
+    // Pontos de vínculo dos SSBOs no shader.
+    const GLuint SOURCE_BINDING = 0;
+    const GLuint VISIBLE_BINDING = 1;
+    const GLuint COMMAND_BINDING = 2;
+}
+
+bool InstanceCuller::isSupported()
+{
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+InstanceCuller::InstanceCuller(Shader &cullShader, unsigned int sourceBuffer, uint32_t instanceCount, const Model &model, size_t lodCount, float maxDistance,
+                               const ImpostorRange *impostor)
+    : m_shader(cullShader), m_sourceBuffer(sourceBuffer), m_instanceCount(instanceCount), m_maxDistance(maxDistance),
+      m_sourceRanges{{0, instanceCount}}, m_testedCount(instanceCount)
+{
+    // Esfera que contém a caixa do modelo; sem caixa, nenhuma instância é descartada pelo frustum.
+    const worldgen::Aabb &bounds = model.getBounds();
+    if (bounds.empty())
+    {
+        m_boundsRadius = 1e30f;
+    }
+    else
+    {
+        m_boundsCenter = (bounds.min + bounds.max) * 0.5f;
+        m_boundsRadius = glm::length(bounds.max - bounds.min) * 0.5f;
+    }
+
+    // Um comando por LOD; cada um tem a sua região do buffer compacto, a partir de baseInstance.
+    lodCount = std::min({lodCount, model.getLods().size(), MAX_LODS});
+    for (size_t lod = 0; lod < lodCount; ++lod)
+    {
+        DrawElementsIndirectCommand command = model.indirectCommand(lod);
+        command.baseInstance = static_cast<uint32_t>(lod) * instanceCount;
+        m_commands.push_back(command);
+        m_lodErrors.push_back(model.getLods()[lod].error);
+    }
+    if (impostor)
+    {
+        DrawElementsIndirectCommand command = impostor->command;
+        command.baseInstance = static_cast<uint32_t>(m_commands.size()) * instanceCount;
+        m_commands.push_back(command);
+        m_hasImpostor = true;
+        m_impostorFadeStart = impostor->fadeStart;
+        m_impostorFadeEnd = impostor->fadeEnd;
+    }
+
+    for (int p = 0; p < 7; ++p)
+        m_uniforms.planes[p] = m_shader.uniform<glm::vec4>("planes[" + std::to_string(p) + "]");
+    m_uniforms.planeCount = m_shader.uniform<int>("planeCount");
+    m_uniforms.firstInstance = m_shader.uniform<int>("firstInstance");
+    m_uniforms.instanceCount = m_shader.uniform<int>("instanceCount");
+    m_uniforms.boundsCenter = m_shader.uniform<glm::vec3>("boundsCenter");
+    m_uniforms.boundsRadius = m_shader.uniform<float>("boundsRadius");
+    m_uniforms.cameraPos = m_shader.uniform<glm::vec3>("cameraPos");
+    m_uniforms.maxDistance = m_shader.uniform<float>("maxDistance");
+    m_uniforms.lodCount = m_shader.uniform<int>("lodCount");
+    for (size_t lod = 0; lod < m_lodErrors.size(); ++lod)
+        m_uniforms.lodDistances.push_back(m_shader.uniform<float>("lodDistances[" + std::to_string(lod) + "]"));
+    m_uniforms.impostorCommand = m_shader.uniform<int>("impostorCommand");
+    m_uniforms.impostorFadeStart = m_shader.uniform<float>("impostorFadeStart");
+    m_uniforms.impostorFadeEnd = m_shader.uniform<float>("impostorFadeEnd");
+
+    glGenBuffers(1, &m_visibleBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_visibleBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_commands.size() * instanceCount * sizeof(worldgen::InstanceData), nullptr, GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &m_commandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commands.size() * sizeof(DrawElementsIndirectCommand), m_commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+InstanceCuller::~InstanceCuller()
+{
+    glDeleteBuffers(1, &m_visibleBuffer);
+    glDeleteBuffers(1, &m_commandBuffer);
+}
+
+void InstanceCuller::setSourceRanges(std::vector<worldgen::InstanceRange> ranges)
+{
+    m_sourceRanges = std::move(ranges);
+    m_testedCount = 0;
+    for (const worldgen::InstanceRange &range : m_sourceRanges)
+        m_testedCount += range.count;
+}
+
+void InstanceCuller::cull(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, const glm::vec4 &clipPlane, float maxPixelError,
+                          float maxDistance)
+{
+    if (m_instanceCount == 0)
+        return;
+
+    // 1. Zera as contagens dos comandos (as demais informações não mudam).
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(DrawElementsIndirectCommand), m_commands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    // 2. Planos normalizados, para que a distância ao plano seja comparável ao raio da esfera.
+    worldgen::Frustum frustum = worldgen::Frustum::fromMatrix(projection * view, clipPlane);
+    m_shader.use();
+    for (int p = 0; p < frustum.planeCount; ++p)
+    {
+        glm::vec4 plane = frustum.planes[p];
+        m_uniforms.planes[p].set(plane / glm::length(glm::vec3(plane)));
+    }
+    m_uniforms.planeCount.set(frustum.planeCount);
+    m_uniforms.boundsCenter.set(m_boundsCenter);
+    m_uniforms.boundsRadius.set(m_boundsRadius);
+    m_uniforms.cameraPos.set(glm::vec3(glm::inverse(view)[3]));
+    m_uniforms.maxDistance.set(std::min(m_maxDistance, maxDistance));
+
+    // 3. Distância, por unidade de escala da instância, a partir da qual cada LOD é aceitável (ver Vegetation).
+    float pixelsPerUnit = projection[1][1] * viewportHeight * 0.5f;
+    m_uniforms.lodCount.set(static_cast<int>(m_lodErrors.size()));
+    m_uniforms.impostorCommand.set(m_hasImpostor ? static_cast<int>(m_lodErrors.size()) : -1);
+    m_uniforms.impostorFadeStart.set(m_impostorFadeStart);
+    m_uniforms.impostorFadeEnd.set(m_impostorFadeEnd);
+    for (size_t lod = 0; lod < m_lodErrors.size(); ++lod)
+        m_uniforms.lodDistances[lod].set(m_lodErrors[lod] * pixelsPerUnit / maxPixelError);
+
+    // 4. Uma invocação por instância dos intervalos; os resultados só são lidos pela GPU, no desenho indireto.
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SOURCE_BINDING, m_sourceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, m_visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, m_commandBuffer);
+    for (const worldgen::InstanceRange &range : m_sourceRanges)
+    {
+        if (range.count == 0)
+            continue;
+        m_uniforms.firstInstance.set(static_cast<int>(range.first));
+        m_uniforms.instanceCount.set(static_cast<int>(range.count));
+        glDispatchCompute((range.count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+size_t InstanceCuller::draw(Model &model)
+{
+    if (m_instanceCount == 0)
+        return 0;
+
+    model.bindInstanced(m_visibleBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    model.drawIndirect(m_lodErrors.size());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    return m_lodErrors.size();
+}
+
+void InstanceCuller::drawImpostors(ImpostorAtlas &impostor)
+{
+    if (m_instanceCount == 0 || !m_hasImpostor)
+        return;
+
+    impostor.bindInstanced(m_visibleBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    impostor.drawIndirect(m_lodErrors.size() * sizeof(DrawElementsIndirectCommand));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
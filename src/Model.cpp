@@ -1,202 +1,255 @@
 #include "Model.hpp"
+#include <cstdint>
 #include <iostream>
-#include <unordered_map>
 
-// Inclui e implementa as bibliotecas de cabeçalho único diretamente aqui.
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+namespace
+{
+    // Pontos de vínculo dos VAOs de um .glb: 0-2 para os atributos (cada um pode vir de um bufferView
+    // diferente) e 3 para os dados de instância.
+    const GLuint GLB_INSTANCE_BINDING = 3;
+    // Alinhamento de cada bufferView dentro do buffer do modelo.
+    const size_t GLB_VIEW_ALIGNMENT = 16;
+
+    size_t indexSize(GLenum type)
+    {
+        return type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+    }
+}
 
 /**
  * @brief Construtor da classe Model.
- * Coordena o processo de carregamento do modelo e da textura, e a configuração dos buffers da GPU.
+ * Envia a malha para a arena no formato pedido e guarda a textura compartilhada.
  */
-Model::Model(const std::string &path, const std::string &texturePath)
+Model::Model(GeometryArena &geometry, const worldgen::MeshView &mesh, std::shared_ptr<Texture> texture, VertexFormat format)
+    : m_format(format), m_geometry(geometry), m_texture(std::move(texture))
 {
-    loadModel(path);
-    loadTexture(texturePath);
-    setupMesh();
+    setupMesh(mesh);
+}
+
+/**
+ * @brief Construtor para modelos .glb. O formato informado ao ResourceManager não se aplica:
+ * os atributos mantêm o formato (possivelmente quantizado) em que estão no arquivo.
+ */
+Model::Model(GeometryArena &geometry, const worldgen::GlbMesh &mesh, std::shared_ptr<Texture> texture)
+    : m_format(VertexFormat::Float), m_geometry(geometry), m_texture(std::move(texture))
+{
+    setupGlbMesh(mesh);
 }
 
 /**
  * @brief Destrutor da classe Model.
- * Garante que todos os recursos alocados na GPU (buffers e texturas) sejam liberados
- * quando o objeto Model é destruído, prevenindo vazamentos de memória de vídeo.
+ * Devolve o intervalo da malha à arena, que pode reaproveitá-lo, ou libera o buffer e os VAOs
+ * próprios de um modelo .glb. A textura é liberada pelo seu último dono.
  */
 Model::~Model()
 {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteTextures(1, &m_textureID);
+    if (m_glbVAO != 0)
+    {
+        // Desvincula antes de apagar, para que a arena não considere vinculado um nome que será reutilizado.
+        m_geometry.bindVertexArray(0);
+        glDeleteVertexArrays(1, &m_glbVAO);
+        glDeleteVertexArrays(1, &m_glbInstancedVAO);
+        glDeleteBuffers(1, &m_glbBuffer);
+        return;
+    }
+    m_geometry.free(m_range);
 }
 
 /**
- * @brief Carrega os dados de um arquivo .obj.
- * Utiliza a biblioteca tiny_obj_loader para analisar o arquivo. O principal desafio aqui é
- * combinar os diferentes atributos (posição, normal, texcoord) em uma única struct Vertex
- * e otimizar o resultado para remover vértices duplicados.
+ * @brief Envia os vértices e índices para os buffers compartilhados do formato.
+ * Os índices de todos os LODs vão em sequência; o LOD 0 (malha completa) vem primeiro.
+ * No formato Packed, os vértices são compactados antes do envio (ver uploadPackedVertices).
  */
-void Model::loadModel(const std::string &path)
+void Model::setupMesh(const worldgen::MeshView &mesh)
 {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+    m_lods.assign(mesh.lods, mesh.lods + mesh.lodCount);
+    m_indexCount = m_lods[0].indexCount;
+    for (size_t i = 0; i < mesh.vertexCount; ++i)
+        m_bounds.expand(mesh.vertices[i].Position);
 
-    // Chama a função da biblioteca para carregar o arquivo.
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
+    if (m_format == VertexFormat::Packed)
     {
-        throw std::runtime_error(warn + err);
+        uploadPackedVertices(mesh);
     }
-
-    vertices.clear();
-    indices.clear();
-
-    // 'uniqueVertices' é um mapa usado para rastrear vértices que já foram processados.
-    // Isso evita a duplicação de dados de vértices, otimizando o uso de memória da GPU.
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
-    // Itera sobre todas as "formas" (objetos) dentro do arquivo .obj.
-    for (const auto &shape : shapes)
+    else
     {
-        // Itera sobre todos os índices que compõem as faces (triângulos) da forma.
-        for (const auto &index : shape.mesh.indices)
-        {
-            Vertex vertex{}; // Cria uma nova struct Vertex para preencher.
-
-            // Preenche a posição do vértice.
-            vertex.Position = {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]};
-
-            // Verifica se o vértice possui coordenadas de textura.
-            if (index.texcoord_index >= 0)
-            {
-                vertex.TexCoords = {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1] // O Y é invertido, pois o formato .obj e o OpenGL têm origens diferentes.
-                };
-            }
-
-            // Verifica se o vértice possui uma normal.
-            if (index.normal_index >= 0)
-            {
-                vertex.Normal = {
-                    attrib.normals[3 * index.normal_index + 0],
-                    attrib.normals[3 * index.normal_index + 1],
-                    attrib.normals[3 * index.normal_index + 2]};
-            }
-
-            // Lógica de otimização: se este vértice combinado ainda não foi visto...
-            if (uniqueVertices.count(vertex) == 0)
-            {
-                // ... o adicionamos ao mapa com o índice atual...
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                // ... e o adicionamos à nossa lista de vértices.
-                vertices.push_back(vertex);
-            }
-            // Adicionamos o índice (seja novo ou reutilizado) à lista de índices para desenho.
-            indices.push_back(uniqueVertices[vertex]);
-        }
+        // Modelos sempre têm normal e UV: o formato Position (só posição) não se aplica a eles.
+        m_format = VertexFormat::Float;
+        m_range = m_geometry.allocate(VertexFormat::Float, mesh.vertices, mesh.vertexCount, mesh.indices, mesh.indexCount);
     }
+    m_byteSize = static_cast<size_t>(m_range.vertexCount) * GeometryArena::vertexStride(m_format) + m_range.indexCount * sizeof(unsigned int);
 }
 
 /**
- * @brief Configura os buffers OpenGL (VAO, VBO, EBO).
- * Esta função envia os dados de vértices e índices da CPU para a memória da GPU
- * e especifica como a GPU deve interpretar esses dados durante a renderização.
+ * @brief Compacta os vértices (worldgen::quantizeVertices) e os envia para a arena.
  */
-void Model::setupMesh()
-{
-    // 1. Gera e vincula o Vertex Array Object (VAO), que armazenará toda a configuração do estado deste modelo.
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    // 2. Envia os dados dos vértices para o Vertex Buffer Object (VBO).
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-    // 3. Envia os dados dos índices para o Element Buffer Object (EBO).
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // 4. Define como o pipeline gráfico deve interpretar os dados do VBO.
-    // Atributo de Posição (layout = 0)
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Position));
-    // Atributo de Normal (layout = 1)
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Normal));
-    // Atributo de Coordenadas de Textura (layout = 2)
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, TexCoords));
-
-    // Desvincula o VAO para evitar modificações acidentais.
-    glBindVertexArray(0);
+void Model::uploadPackedVertices(const worldgen::MeshView &mesh)
+{
+    worldgen::QuantizedMesh packed = worldgen::quantizeVertices(mesh.vertices, mesh.vertexCount);
+    m_positionScale = packed.positionScale;
+    m_positionOffset = packed.positionOffset;
+
+    std::cout << "  Vertices compactados: " << sizeof(Vertex) << " -> " << sizeof(worldgen::PackedVertex)
+              << " bytes; erro maximo: posicao " << packed.error.position << ", normal " << packed.error.normalDegrees
+              << " graus, UV " << packed.error.texCoord << std::endl;
+
+    m_range = m_geometry.allocate(VertexFormat::Packed, packed.vertices.data(), packed.vertices.size(), mesh.indices, mesh.indexCount);
 }
 
 /**
- * @brief Carrega uma textura de um arquivo de imagem.
- * Utiliza a biblioteca stb_image para carregar os dados da imagem e, em seguida,
- * configura uma textura 2D no OpenGL com esses dados.
+ * @brief Envia os bufferViews usados pelo .glb, sem conversão, para um buffer próprio e descreve
+ * cada atributo no VAO com o formato do seu accessor. A GPU faz a desquantização durante a leitura;
+ * a escala e a translação do nó chegam ao shader como positionScale/positionOffset.
  */
-void Model::loadTexture(const std::string &path)
+void Model::setupGlbMesh(const worldgen::GlbMesh &mesh)
 {
-    glGenTextures(1, &m_textureID);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
-
-    int width, height, nrChannels;
-    // Carrega a imagem do disco.
-    unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data)
+    // Um .glb tem um único LOD: a malha completa.
+    m_indexCount = mesh.indices.count;
+    m_lods.push_back({0, mesh.indices.count, 0.0f, 0});
+    m_positionScale = mesh.positionScale;
+    m_positionOffset = mesh.positionOffset;
+    m_bounds = mesh.bounds;
+
+    // 1. Posição de cada bufferView usado dentro do buffer do modelo (atributos 0-2, depois os índices).
+    const worldgen::GlbAccessor *accessors[] = {&mesh.position, &mesh.normal, &mesh.texCoord, &mesh.indices};
+    std::vector<size_t> viewOffsets(mesh.bufferViews.size(), SIZE_MAX);
+    size_t totalSize = 0;
+    for (const worldgen::GlbAccessor *accessor : accessors)
     {
-        // Determina o formato da imagem (RGB ou RGBA).
-        GLenum format = GL_RGB;
-        if (nrChannels == 4)
-            format = GL_RGBA;
-
-        // Envia os dados da imagem para a textura OpenGL vinculada.
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D); // Gera mipmaps para melhor qualidade de textura à distância.
-
-        // Define os parâmetros de wrapping e filtering da textura.
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        if (!accessor->present() || viewOffsets[accessor->bufferView] != SIZE_MAX)
+            continue;
+        viewOffsets[accessor->bufferView] = totalSize;
+        totalSize += mesh.bufferViews[accessor->bufferView].byteLength;
+        totalSize = (totalSize + GLB_VIEW_ALIGNMENT - 1) / GLB_VIEW_ALIGNMENT * GLB_VIEW_ALIGNMENT;
     }
-    else
+    // Depois deles, o valor constante de cada atributo ausente, lido com stride 0 por todos os vértices.
+    // Fica no VAO, ao contrário de glVertexAttrib*, que é estado do contexto. Sem normais, elas apontam para cima.
+    const glm::vec3 constants[3] = {glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f)};
+    size_t constantsOffset = totalSize;
+    totalSize += sizeof(constants);
+
+    // 2. Copia cada bufferView direto do arquivo mapeado para a GPU.
+    glGenBuffers(1, &m_glbBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_glbBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STATIC_DRAW);
+    for (size_t view = 0; view < mesh.bufferViews.size(); ++view)
+    {
+        if (viewOffsets[view] != SIZE_MAX)
+            glBufferSubData(GL_COPY_WRITE_BUFFER, viewOffsets[view], mesh.bufferViews[view].byteLength, mesh.binary + mesh.bufferViews[view].byteOffset);
+    }
+    glBufferSubData(GL_COPY_WRITE_BUFFER, constantsOffset, sizeof(constants), constants);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_byteSize = totalSize;
+
+    m_indexType = mesh.indices.componentType;
+    m_indexByteOffset = viewOffsets[mesh.indices.bufferView] + mesh.indices.byteOffset;
+
+    // 3. Dois VAOs, como na arena: um para desenho simples e um com os dados de instância.
+    for (unsigned int *vao : {&m_glbVAO, &m_glbInstancedVAO})
     {
-        std::cout << "Falha ao carregar a textura: " << path << std::endl;
+        glGenVertexArrays(1, vao);
+        m_geometry.bindVertexArray(*vao);
+        for (GLuint attribute = 0; attribute < 3; ++attribute)
+        {
+            const worldgen::GlbAccessor &accessor = *accessors[attribute];
+            glVertexAttribBinding(attribute, attribute);
+            glEnableVertexAttribArray(attribute);
+            if (!accessor.present())
+            {
+                glVertexAttribFormat(attribute, 3, GL_FLOAT, GL_FALSE, 0);
+                glBindVertexBuffer(attribute, m_glbBuffer, constantsOffset + attribute * sizeof(glm::vec3), 0);
+                continue;
+            }
+
+            const worldgen::GlbBufferView &view = mesh.bufferViews[accessor.bufferView];
+            GLsizei stride = view.byteStride != 0 ? view.byteStride : accessor.elementSize();
+            glVertexAttribFormat(attribute, accessor.componentCount, accessor.componentType, accessor.normalized ? GL_TRUE : GL_FALSE, 0);
+            glBindVertexBuffer(attribute, m_glbBuffer, viewOffsets[accessor.bufferView] + accessor.byteOffset, stride);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glbBuffer);
+        if (vao == &m_glbInstancedVAO)
+            GeometryArena::setupInstanceAttributes(GLB_INSTANCE_BINDING);
     }
-    // Libera a memória da imagem na CPU, pois os dados já estão na GPU.
-    stbi_image_free(data);
 }
 
 /**
  * @brief Renderiza o modelo.
  * Esta função é chamada no loop principal de renderização. Ela vincula a textura e o VAO
- * do modelo e emite uma chamada de desenho para a GPU.
+ * do formato do modelo (compartilhado com os outros modelos do mesmo formato) e desenha o LOD 0.
  */
 void Model::Draw(Shader &shader)
 {
+    setPositionUniforms(shader);
     bindTexture(); // Ativa a textura do modelo.
-    glBindVertexArray(VAO); // Ativa o VAO, restaurando todo o estado de renderização do modelo.
+    if (m_glbVAO != 0)
+    {
+        m_geometry.bindVertexArray(m_glbVAO);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), m_indexType, (void *)m_indexByteOffset);
+        return;
+    }
+    m_geometry.bind(m_format);
+    m_geometry.draw(m_range, m_lods[0].indexOffset, m_indexCount);
+}
+
+void Model::bindInstanced(unsigned int instanceVBO)
+{
+    if (m_glbVAO != 0)
+    {
+        m_geometry.bindVertexArray(m_glbInstancedVAO);
+        glBindVertexBuffer(GLB_INSTANCE_BINDING, instanceVBO, 0, GeometryArena::INSTANCE_STRIDE);
+        return;
+    }
+    m_geometry.bindInstanced(m_format, instanceVBO);
+}
+
+void Model::drawLodInstanced(size_t lod, unsigned int instanceCount, unsigned int baseInstance) const
+{
+    if (m_glbVAO != 0)
+    {
+        size_t offset = m_indexByteOffset + m_lods[lod].indexOffset * indexSize(m_indexType);
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(m_lods[lod].indexCount), m_indexType,
+                                            (void *)offset, instanceCount, baseInstance);
+        return;
+    }
+    m_geometry.drawInstanced(m_range, m_lods[lod].indexOffset, m_lods[lod].indexCount, instanceCount, baseInstance);
+}
 
-    // Comando para a GPU desenhar os triângulos usando os índices do EBO.
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+DrawElementsIndirectCommand Model::indirectCommand(size_t lod) const
+{
+    // No .glb, os índices começam em m_indexByteOffset (alinhado a GLB_VIEW_ALIGNMENT, múltiplo do tamanho do índice).
+    if (m_glbVAO != 0)
+        return {m_lods[lod].indexCount, 0, static_cast<uint32_t>(m_indexByteOffset / indexSize(m_indexType)) + m_lods[lod].indexOffset, 0, 0};
+    return {m_lods[lod].indexCount, 0, m_range.firstIndex + m_lods[lod].indexOffset, static_cast<int32_t>(m_range.baseVertex), 0};
+}
 
-    // Desvincula o VAO como boa prática.
-    glBindVertexArray(0);
+void Model::drawIndirect(size_t commandCount) const
+{
+    glMultiDrawElementsIndirect(GL_TRIANGLES, m_glbVAO != 0 ? m_indexType : GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commandCount), 0);
 }
 
 // Implementação dos métodos 'getter'.
-unsigned int Model::getVAO() { return VAO; }
-unsigned int Model::getIndicesCount() { return indices.size(); }
-void Model::bindTexture() { glBindTexture(GL_TEXTURE_2D, m_textureID); }
\ No newline at end of file
+unsigned int Model::getIndicesCount() { return m_indexCount; }
+const std::vector<worldgen::MeshLod> &Model::getLods() const { return m_lods; }
+size_t Model::getByteSize() const { return m_byteSize; }
+void Model::bindTexture()
+{
+    if (m_texture)
+        m_texture->bind();
+}
+
+Model::PositionUniforms::PositionUniforms(const Shader &shader)
+    : scale(shader.uniform<glm::vec3>("positionScale")), offset(shader.uniform<glm::vec3>("positionOffset"))
+{
+}
+
+void Model::setPositionUniforms(Shader &shader) const
+{
+    shader.setVec3("positionScale", m_positionScale);
+    shader.setVec3("positionOffset", m_positionOffset);
+}
+
+void Model::setPositionUniforms(const PositionUniforms &uniforms) const
+{
+    uniforms.scale.set(m_positionScale);
+    uniforms.offset.set(m_positionOffset);
+}
\ No newline at end of file
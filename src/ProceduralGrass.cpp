@@ -0,0 +1,91 @@
+#include "ProceduralGrass.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // Segmentos de cada lâmina: uma tira de 2 * BLADE_SEGMENTS + 1 vértices (deve ser o mesmo de grass_blades.vert).
+    const int BLADE_SEGMENTS = 4;
+}
+
+ProceduralGrass::Uniforms::Uniforms(const Shader &shader)
+    : view(shader.uniform<glm::mat4>("view")), projection(shader.uniform<glm::mat4>("projection")),
+      grassMap(shader.uniform<int>("grassMap")), terrainSize(shader.uniform<glm::vec2>("terrainSize")),
+      heightBand(shader.uniform<glm::vec2>("heightBand")), noiseThreshold(shader.uniform<float>("noiseThreshold")),
+      gridSide(shader.uniform<int>("gridSide")), gridOrigin(shader.uniform<glm::vec2>("gridOrigin")),
+      spacing(shader.uniform<float>("spacing")), fadeStart(shader.uniform<float>("fadeStart")), radius(shader.uniform<float>("radius"))
+{
+}
+
+ProceduralGrass::ProceduralGrass(Shader &shader, GeometryArena &geometry, int width, int depth, const std::vector<float> &grassMap, const worldgen::GrassCoverage &coverage)
+    : m_shader(shader), m_uniforms(shader), m_geometry(geometry), m_width(width), m_depth(depth), m_noiseThreshold(coverage.noiseThreshold)
+{
+    m_heightBand = glm::vec2(coverage.minHeight * 2.0f - 1.0f, coverage.maxHeight * 2.0f - 1.0f) * coverage.terrainAmplitude;
+
+    glGenTextures(1, &m_grassMap);
+    glBindTexture(GL_TEXTURE_2D, m_grassMap);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, width, depth);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, depth, GL_RG, GL_FLOAT, grassMap.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &m_vao);
+
+    size_t kilobytes = grassMap.size() * sizeof(float) / 1024;
+    std::cout << "Grama procedural: mapa do terreno de " << kilobytes << " KB, sem buffer de instancias" << std::endl;
+}
+
+ProceduralGrass::~ProceduralGrass()
+{
+    glDeleteTextures(1, &m_grassMap);
+    // Desvincula antes de apagar, para que a arena não considere vinculado um nome que será reutilizado.
+    m_geometry.bindVertexArray(0);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+/**
+ * @brief Desenha a grade de lâminas em volta da câmera num único glDrawArraysInstanced.
+ * A grade é alinhada ao mundo (a origem é a célula da câmera, arredondada), então cada lâmina fica no
+ * mesmo lugar enquanto a câmera anda; o espaçamento vem da densidade, aumentado se a grade passar do orçamento.
+ */
+void ProceduralGrass::Draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPos, worldgen::CullStats *stats,
+                           float lodBias, float maxDistance)
+{
+    float density = m_density * std::exp2(-lodBias);
+    float radius = std::min(m_radius, maxDistance);
+    if (density <= 0.0f || radius <= 0.0f || m_maxBlades == 0)
+        return;
+    float spacing = std::max(1.0f / std::sqrt(density), 2.0f * radius / std::sqrt(static_cast<float>(m_maxBlades)));
+    int gridSide = static_cast<int>(std::ceil(2.0f * radius / spacing));
+    glm::ivec2 gridOrigin(static_cast<int>(std::floor(cameraPos.x / spacing)) - gridSide / 2,
+                          static_cast<int>(std::floor(cameraPos.z / spacing)) - gridSide / 2);
+
+    m_shader.use();
+    m_uniforms.view.set(view);
+    m_uniforms.projection.set(projection);
+    m_uniforms.grassMap.set(0);
+    m_uniforms.terrainSize.set(glm::vec2(static_cast<float>(m_width), static_cast<float>(m_depth)));
+    m_uniforms.heightBand.set(m_heightBand);
+    m_uniforms.noiseThreshold.set(m_noiseThreshold);
+    m_uniforms.gridSide.set(gridSide);
+    m_uniforms.gridOrigin.set(glm::vec2(static_cast<float>(gridOrigin.x), static_cast<float>(gridOrigin.y)));
+    m_uniforms.spacing.set(spacing);
+    m_uniforms.fadeStart.set(std::min(m_fadeStart, 0.5f * radius));
+    m_uniforms.radius.set(radius);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_grassMap);
+    m_geometry.bindVertexArray(m_vao);
+    GLsizei blades = static_cast<GLsizei>(gridSide) * gridSide;
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 2 * BLADE_SEGMENTS + 1, blades);
+
+    if (stats)
+    {
+        stats->gpuTested += static_cast<uint64_t>(blades);
+        stats->draws += 1;
+    }
+}
@@ -0,0 +1,64 @@
+#include "RenderPass.hpp"
+
+PassTimer::PassTimer(size_t passCount)
+    : m_passes(passCount)
+{
+    for (Pass &pass : m_passes)
+        glGenQueries(static_cast<GLsizei>(LATENCY), pass.queries);
+}
+
+PassTimer::~PassTimer()
+{
+    for (Pass &pass : m_passes)
+        glDeleteQueries(static_cast<GLsizei>(LATENCY), pass.queries);
+}
+
+/**
+ * @brief Lê a consulta que ocupava este slot (de LATENCY frames atrás) e começa uma nova nele.
+ */
+void PassTimer::begin(size_t index)
+{
+    Pass &pass = m_passes[index];
+    size_t slot = pass.frame % LATENCY;
+    if (pass.pending[slot])
+    {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(pass.queries[slot], GL_QUERY_RESULT, &nanoseconds);
+        pass.gpuTotal += nanoseconds / 1.0e6;
+        ++pass.gpuSamples;
+        pass.pending[slot] = false;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, pass.queries[slot]);
+    pass.cpuStart = std::chrono::steady_clock::now();
+}
+
+void PassTimer::end(size_t index)
+{
+    Pass &pass = m_passes[index];
+    glEndQuery(GL_TIME_ELAPSED);
+    pass.cpuTotal += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pass.cpuStart).count();
+    ++pass.cpuSamples;
+    pass.pending[pass.frame % LATENCY] = true;
+    ++pass.frame;
+}
+
+double PassTimer::gpuMilliseconds(size_t index) const
+{
+    const Pass &pass = m_passes[index];
+    return pass.gpuSamples > 0 ? pass.gpuTotal / pass.gpuSamples : 0.0;
+}
+
+double PassTimer::cpuMilliseconds(size_t index) const
+{
+    const Pass &pass = m_passes[index];
+    return pass.cpuSamples > 0 ? pass.cpuTotal / pass.cpuSamples : 0.0;
+}
+
+void PassTimer::reset()
+{
+    for (Pass &pass : m_passes)
+    {
+        pass.gpuTotal = pass.cpuTotal = 0.0;
+        pass.gpuSamples = pass.cpuSamples = 0;
+    }
+}
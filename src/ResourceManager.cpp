@@ -0,0 +1,340 @@
+#include "ResourceManager.hpp"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    size_t cachedMeshByteSize(const worldgen::CachedMesh &cached)
+    {
+        worldgen::MeshView mesh = cached.view();
+        return mesh.vertexCount * sizeof(Vertex) + mesh.indexCount * sizeof(unsigned int);
+    }
+
+    size_t glbByteSize(const worldgen::GlbMesh &mesh)
+    {
+        return mesh.binarySize;
+    }
+
+    size_t imageByteSize(const worldgen::CompressedTexture &image)
+    {
+        return image.byteSize();
+    }
+
+    // Remove do mapa as entradas que só o próprio cache referencia.
+    template <typename Map>
+    size_t eraseUnused(Map &map)
+    {
+        size_t erased = 0;
+        for (auto it = map.begin(); it != map.end();)
+        {
+            if (it->second.use_count() == 1)
+            {
+                it = map.erase(it);
+                ++erased;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return erased;
+    }
+
+    template <typename Map>
+    size_t countInUse(const Map &map)
+    {
+        size_t count = 0;
+        for (const auto &entry : map)
+            count += entry.second.use_count() > 1;
+        return count;
+    }
+}
+
+/**
+ * @brief Destrutor. Libera os modelos antes das texturas que eles referenciam.
+ * Recursos ainda referenciados fora daqui só serão liberados pelo seu último dono,
+ * o que precisa acontecer antes de glfwTerminate().
+ */
+ResourceManager::~ResourceManager()
+{
+    size_t inUse = countInUse(m_models) + countInUse(m_textures) + countInUse(m_textureArrays);
+    if (inUse > 0)
+        std::cerr << "Aviso: " << inUse << " recurso(s) ainda em uso ao destruir o ResourceManager" << std::endl;
+
+    m_models.clear();
+    m_textures.clear();
+    m_textureArrays.clear();
+}
+
+std::string ResourceManager::normalizePath(const std::string &path)
+{
+    std::error_code error;
+    std::filesystem::path normalized = std::filesystem::weakly_canonical(path, error);
+    if (error)
+        normalized = std::filesystem::absolute(path, error).lexically_normal();
+    return normalized.generic_string();
+}
+
+/**
+ * @brief Busca 'key' no cache da CPU ou, na primeira vez, executa 'load' fora do mutex para preenchê-lo.
+ * Quem pedir a mesma chave durante a leitura espera pelo mesmo resultado; uma exceção em 'load'
+ * é repassada a todos eles.
+ */
+template <typename T, typename Load>
+std::shared_ptr<const T> ResourceManager::getOrLoad(CpuCache<T> &cache, CacheStats &stats, const std::string &key, size_t (*byteSize)(const T &), Load load)
+{
+    std::promise<std::shared_ptr<const T>> promise;
+    {
+        std::unique_lock<std::mutex> lock(m_cpuMutex);
+        auto it = cache.find(key);
+        if (it != cache.end())
+        {
+            std::shared_future<std::shared_ptr<const T>> future = it->second;
+            lock.unlock();
+            std::shared_ptr<const T> data = future.get();
+
+            lock.lock();
+            ++stats.hits;
+            stats.bytesSaved += byteSize(*data);
+            return data;
+        }
+        ++stats.misses;
+        cache.emplace(key, promise.get_future().share());
+    }
+
+    std::shared_ptr<const T> data;
+    try
+    {
+        data = load();
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    promise.set_value(data);
+    return data;
+}
+
+/**
+ * @brief Lê o .obj (ou o seu cache binário) uma única vez.
+ * A leitura e a remoção de vértices duplicados ficam na libworldgen, que não depende de OpenGL.
+ * Na primeira execução o .obj é analisado, otimizado e um cache binário é gravado ao lado dele;
+ * nas seguintes, o cache é mapeado na memória e entregue diretamente à GPU, sem cópias.
+ */
+std::shared_ptr<const worldgen::CachedMesh> ResourceManager::getMeshData(const std::string &key)
+{
+    return getOrLoad(m_meshData, m_meshDataStats, key, cachedMeshByteSize, [&key]()
+                     {
+        auto start = std::chrono::steady_clock::now();
+        auto mesh = std::make_shared<const worldgen::CachedMesh>(worldgen::loadMeshCached(key));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        // Monta a mensagem inteira antes de escrevê-la, para não intercalar com a de outras threads.
+        std::ostringstream message;
+        message << "Modelo " << key << (mesh->fromCache() ? " (cache)" : " (obj)")
+                << " carregado em " << elapsed.count() << " ms\n";
+
+        const worldgen::MeshOptimizationReport &report = mesh->report();
+        message << "  ACMR " << report.before.acmr << " -> " << report.after.acmr
+                << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << "\n";
+
+        worldgen::MeshView view = mesh->view();
+        message << "  LODs:";
+        for (size_t i = 0; i < view.lodCount; ++i)
+            message << " " << view.lods[i].indexCount / 3;
+        message << " triangulos\n";
+        std::cout << message.str() << std::flush;
+        return mesh; });
+}
+
+/**
+ * @brief Mapeia o .glb uma única vez. Só o JSON é analisado; os dados binários vão para a GPU como estão.
+ */
+std::shared_ptr<const worldgen::GlbMesh> ResourceManager::getGlbData(const std::string &key)
+{
+    return getOrLoad(m_glbData, m_meshDataStats, key, glbByteSize, [&key]()
+                     {
+        auto start = std::chrono::steady_clock::now();
+        auto mesh = std::make_shared<const worldgen::GlbMesh>(worldgen::loadGlb(key));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::ostringstream message;
+        message << "Modelo " << key << " (glb) carregado em " << elapsed.count() << " ms: "
+                << mesh->indices.count / 3 << " triangulos, " << mesh->position.count << " vertices\n";
+        std::cout << message.str() << std::flush;
+        return mesh; });
+}
+
+/**
+ * @brief Lê a imagem comprimida uma única vez por modo de compressão.
+ * Na primeira execução a imagem é decodificada, ganha os mipmaps, é comprimida e o cache é gravado
+ * ao lado dela; nas seguintes, o cache é mapeado na memória e os blocos vão direto para a GPU.
+ */
+std::shared_ptr<const worldgen::CompressedTexture> ResourceManager::getImageData(const std::string &path, worldgen::TextureCompression compression)
+{
+    std::string key = path + "|compression=" + std::to_string(static_cast<int>(compression));
+    return getOrLoad(m_imageData, m_imageDataStats, key, imageByteSize, [&path, compression]()
+                     {
+        // loadTextureCached não lança exceções: uma imagem inválida é guardada assim mesmo.
+        auto start = std::chrono::steady_clock::now();
+        auto image = std::make_shared<const worldgen::CompressedTexture>(worldgen::loadTextureCached(path, compression));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::ostringstream message;
+        if (!*image)
+            message << "Texture failed to load at path: " << path << "\n";
+        else
+            message << "Textura " << path << (image->fromCache() ? " (cache)" : " (comprimida)") << " carregada em "
+                    << elapsed.count() << " ms: " << worldgen::blockFormatName(image->format()) << ", "
+                    << image->levelCount() << " niveis, " << image->byteSize() / 1024 << " KB\n";
+        std::cout << message.str() << std::flush;
+        return image; });
+}
+
+bool ResourceManager::isGlb(const std::string &path)
+{
+    return std::filesystem::path(path).extension() == ".glb";
+}
+
+void ResourceManager::prefetchMesh(const std::string &path)
+{
+    std::string key = normalizePath(path);
+    if (isGlb(key))
+        getGlbData(key);
+    else
+        getMeshData(key);
+}
+
+void ResourceManager::prefetchImage(const std::string &path, worldgen::TextureCompression compression)
+{
+    getImageData(normalizePath(path), compression);
+}
+
+std::shared_ptr<Texture> ResourceManager::getTexture(const std::string &path, const TextureOptions &options)
+{
+    std::string imageKey = normalizePath(path);
+    std::string key = imageKey + optionsKey(options);
+
+    auto it = m_textures.find(key);
+    if (it != m_textures.end())
+    {
+        ++m_textureStats.hits;
+        m_textureStats.bytesSaved += it->second->getByteSize();
+        return it->second;
+    }
+    ++m_textureStats.misses;
+
+    auto texture = std::make_shared<Texture>(*getImageData(imageKey, options.compression), options);
+    m_textures.emplace(key, texture);
+    return texture;
+}
+
+std::string ResourceManager::optionsKey(const TextureOptions &options)
+{
+    return "|wrap=" + std::to_string(options.wrap) + "|mipmaps=" + std::to_string(options.mipmaps) +
+           "|compression=" + std::to_string(static_cast<int>(options.compression));
+}
+
+std::shared_ptr<TextureArray> ResourceManager::getTextureArray(const std::vector<std::string> &paths, const TextureOptions &options)
+{
+    std::vector<std::string> imageKeys;
+    std::string key;
+    for (const std::string &path : paths)
+    {
+        imageKeys.push_back(normalizePath(path));
+        key += imageKeys.back() + ";";
+    }
+    key += optionsKey(options);
+
+    auto it = m_textureArrays.find(key);
+    if (it != m_textureArrays.end())
+    {
+        ++m_textureStats.hits;
+        m_textureStats.bytesSaved += it->second->getByteSize();
+        return it->second;
+    }
+    ++m_textureStats.misses;
+
+    // As imagens só precisam existir durante o envio; o cache da CPU as mantém até releaseCpuData().
+    std::vector<std::shared_ptr<const worldgen::CompressedTexture>> images;
+    std::vector<const worldgen::CompressedTexture *> layers;
+    for (const std::string &imageKey : imageKeys)
+    {
+        images.push_back(getImageData(imageKey, options.compression));
+        layers.push_back(images.back().get());
+    }
+    auto textureArray = std::make_shared<TextureArray>(layers, options);
+    m_textureArrays.emplace(key, textureArray);
+    return textureArray;
+}
+
+std::shared_ptr<Model> ResourceManager::getModel(const std::string &path, const std::string &texturePath, VertexFormat format)
+{
+    std::string meshKey = normalizePath(path);
+    std::string textureKey = texturePath.empty() ? std::string() : normalizePath(texturePath);
+    std::string key = meshKey + "|" + textureKey + "|format=" + std::to_string(static_cast<int>(format));
+
+    auto it = m_models.find(key);
+    if (it != m_models.end())
+    {
+        ++m_modelStats.hits;
+        m_modelStats.bytesSaved += it->second->getByteSize();
+        return it->second;
+    }
+    ++m_modelStats.misses;
+
+    // A malha na CPU precisa existir só durante o envio à GPU; o cache a mantém até releaseCpuData().
+    std::shared_ptr<Texture> texture = texturePath.empty() ? nullptr : getTexture(texturePath);
+    std::shared_ptr<Model> model;
+    if (isGlb(meshKey))
+    {
+        std::shared_ptr<const worldgen::GlbMesh> mesh = getGlbData(meshKey);
+        model = std::make_shared<Model>(m_geometry, *mesh, texture);
+    }
+    else
+    {
+        std::shared_ptr<const worldgen::CachedMesh> mesh = getMeshData(meshKey);
+        model = std::make_shared<Model>(m_geometry, mesh->view(), texture, format);
+    }
+    m_models.emplace(key, model);
+    return model;
+}
+
+void ResourceManager::releaseCpuData()
+{
+    // Leituras ainda em andamento continuam válidas para quem as espera; só o cache as esquece.
+    std::lock_guard<std::mutex> lock(m_cpuMutex);
+    m_meshData.clear();
+    m_glbData.clear();
+    m_imageData.clear();
+}
+
+void ResourceManager::releaseUnused()
+{
+    // Modelos primeiro: eles podem ser os últimos donos de algumas texturas.
+    size_t erased = eraseUnused(m_models);
+    erased += eraseUnused(m_textures);
+    erased += eraseUnused(m_textureArrays);
+    if (erased > 0)
+        std::cout << "Recursos liberados: " << erased << std::endl;
+}
+
+void ResourceManager::printStats() const
+{
+    auto print = [](const char *name, const CacheStats &stats)
+    {
+        std::cout << "  " << name << ": " << stats.hits << " acertos, " << stats.misses << " faltas, "
+                  << stats.bytesSaved / 1024 << " KB economizados" << std::endl;
+    };
+    std::cout << "Cache de recursos:" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(m_cpuMutex);
+        print("malhas (CPU)", m_meshDataStats);
+        print("imagens (CPU)", m_imageDataStats);
+    }
+    print("texturas (GPU)", m_textureStats);
+    print("modelos (GPU)", m_modelStats);
+}
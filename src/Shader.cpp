@@ -1,8 +1,17 @@
 #include "Shader.hpp"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+namespace
+{
+    // Contadores de todos os programas: há um único contexto, e os uniforms só são enviados na sua thread.
+    uint64_t uniformCalls = 0;
+    uint64_t skippedUniforms = 0;
+}
+
 /**
  * @brief Construtor da classe Shader.
  * Realiza todo o processo de carregar, compilar e ligar os shaders.
@@ -62,12 +71,53 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM"); // Verifica se a ligação foi bem-sucedida.
+    cacheUniforms();
 
     // 4. Eliminar os objetos de shader individuais, pois já não são necessários após a ligação.
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 }
 
+/**
+ * @brief Construtor de um programa com apenas um compute shader.
+ */
+Shader::Shader(const char *computePath)
+{
+    // 1. Obter o código-fonte do shader.
+    std::string computeCode;
+    std::ifstream cShaderFile;
+    cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    try
+    {
+        cShaderFile.open(computePath);
+        std::stringstream cShaderStream;
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
+        computeCode = cShaderStream.str();
+    }
+    catch (std::ifstream::failure &e)
+    {
+        std::cerr << "ERRO::SHADER::ARQUIVO_NAO_LIDO_COM_SUCESSO" << std::endl;
+    }
+    const char *cShaderCode = computeCode.c_str();
+
+    // 2. Compilar o shader.
+    unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute, 1, &cShaderCode, NULL);
+    glCompileShader(compute);
+    checkCompileErrors(compute, "COMPUTE");
+
+    // 3. Criar e ligar o Programa de Shader.
+    ID = glCreateProgram();
+    glAttachShader(ID, compute);
+    glLinkProgram(ID);
+    checkCompileErrors(ID, "PROGRAM");
+    cacheUniforms();
+
+    // 4. Eliminar o objeto de shader, que já não é necessário após a ligação.
+    glDeleteShader(compute);
+}
+
 /**
  * @brief Ativa o programa de shader.
  */
@@ -76,43 +126,216 @@ void Shader::use()
     glUseProgram(ID);
 }
 
+/**
+ * @brief Registra cada uniform ativo pelo nome. Um array "nome[0]" de N elementos também fica
+ * acessível como "nome[i]", cada elemento com a sua localização, e "nome" é o mesmo slot de "nome[0]"
+ * (com o mesmo último valor). Uniforms de blocos (sem localização) são ignorados.
+ */
+void Shader::cacheUniforms()
+{
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer(std::max(maxLength, 1));
+
+    auto add = [this](const std::string &name, GLint location, GLenum type)
+    {
+        if (location < 0 || m_slotByName.count(name))
+            return;
+        m_slotByName[name] = static_cast<int>(m_slots.size());
+        UniformSlot slot;
+        slot.location = location;
+        slot.type = type;
+        m_slots.push_back(slot);
+    };
+
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()), nullptr, &size, &type, buffer.data());
+        std::string name(buffer.data());
+        GLint location = glGetUniformLocation(ID, name.c_str());
+
+        size_t bracket = name.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == name.size())
+        {
+            std::string base = name.substr(0, bracket);
+            for (GLint element = 0; element < size; ++element)
+            {
+                std::string elementName = base + "[" + std::to_string(element) + "]";
+                add(elementName, glGetUniformLocation(ID, elementName.c_str()), type);
+            }
+            auto first = m_slotByName.find(name);
+            if (first != m_slotByName.end() && !m_slotByName.count(base))
+                m_slotByName[base] = first->second;
+        }
+        else
+        {
+            add(name, location, type);
+        }
+    }
+}
+
+int Shader::slotOf(const std::string &name) const
+{
+    auto it = m_slotByName.find(name);
+    return it == m_slotByName.end() ? -1 : it->second;
+}
+
+bool Shader::accepts(GLenum type, const int *)
+{
+    // glUniform1i serve para int, bool e para os tipos opacos (samplers e images); os demais tipos
+    // básicos precisam da sua própria chamada.
+    switch (type)
+    {
+    case GL_FLOAT:
+    case GL_FLOAT_VEC2:
+    case GL_FLOAT_VEC3:
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC2:
+    case GL_INT_VEC3:
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC2:
+    case GL_BOOL_VEC3:
+    case GL_BOOL_VEC4:
+    case GL_UNSIGNED_INT:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_FLOAT_MAT2:
+    case GL_FLOAT_MAT3:
+    case GL_FLOAT_MAT4:
+    case GL_FLOAT_MAT2x3:
+    case GL_FLOAT_MAT2x4:
+    case GL_FLOAT_MAT3x2:
+    case GL_FLOAT_MAT3x4:
+    case GL_FLOAT_MAT4x2:
+    case GL_FLOAT_MAT4x3:
+    case GL_DOUBLE:
+    case GL_DOUBLE_VEC2:
+    case GL_DOUBLE_VEC3:
+    case GL_DOUBLE_VEC4:
+        return false;
+    default:
+        return true;
+    }
+}
+
+bool Shader::accepts(GLenum type, const float *) { return type == GL_FLOAT; }
+bool Shader::accepts(GLenum type, const glm::vec2 *) { return type == GL_FLOAT_VEC2; }
+bool Shader::accepts(GLenum type, const glm::vec3 *) { return type == GL_FLOAT_VEC3; }
+bool Shader::accepts(GLenum type, const glm::vec4 *) { return type == GL_FLOAT_VEC4; }
+bool Shader::accepts(GLenum type, const glm::mat4 *) { return type == GL_FLOAT_MAT4; }
+
+void Shader::reportTypeMismatch(const std::string &name)
+{
+    std::cerr << "ERRO::SHADER::TIPO_DO_UNIFORM_INCOMPATIVEL: " << name << std::endl;
+}
+
+bool Shader::changed(int slot, const void *value, size_t size) const
+{
+    UniformSlot &cached = m_slots[slot];
+    if (cached.known && std::memcmp(cached.value, value, size) == 0)
+    {
+        ++skippedUniforms;
+        return false;
+    }
+    std::memcpy(cached.value, value, size);
+    cached.known = true;
+    ++uniformCalls;
+    return true;
+}
+
+void Shader::upload(int slot, int value) const
+{
+    if (slot >= 0 && changed(slot, &value, sizeof(value)))
+        glUniform1i(m_slots[slot].location, value);
+}
+
+void Shader::upload(int slot, float value) const
+{
+    if (slot >= 0 && changed(slot, &value, sizeof(value)))
+        glUniform1f(m_slots[slot].location, value);
+}
+
+void Shader::upload(int slot, const glm::vec2 &value) const
+{
+    if (slot >= 0 && changed(slot, &value[0], sizeof(float) * 2))
+        glUniform2fv(m_slots[slot].location, 1, &value[0]);
+}
+
+void Shader::upload(int slot, const glm::vec3 &value) const
+{
+    if (slot >= 0 && changed(slot, &value[0], sizeof(float) * 3))
+        glUniform3fv(m_slots[slot].location, 1, &value[0]);
+}
+
+void Shader::upload(int slot, const glm::vec4 &value) const
+{
+    if (slot >= 0 && changed(slot, &value[0], sizeof(float) * 4))
+        glUniform4fv(m_slots[slot].location, 1, &value[0]);
+}
+
+void Shader::upload(int slot, const glm::mat4 &value) const
+{
+    if (slot >= 0 && changed(slot, &value[0][0], sizeof(float) * 16))
+        glUniformMatrix4fv(m_slots[slot].location, 1, GL_FALSE, &value[0][0]);
+}
+
 // Implementação das funções de definição de uniforms
-//  Cada função obtém a localização da variável uniform no programa de shader através do seu nome
-//  e, em seguida, define o seu valor usando a chamada apropriada do OpenGL (glUniform...).
+//  Cada função procura o uniform no cache construído na ligação e envia o valor com a chamada
+//  apropriada do OpenGL (glUniform...), se ele mudou desde o último envio.
 
 void Shader::setBool(const std::string &name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    upload(typedSlotOf<int>(name), static_cast<int>(value));
 }
 
 void Shader::setInt(const std::string &name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    upload(typedSlotOf<int>(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    upload(typedSlotOf<float>(name), value);
 }
 
 void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    upload(typedSlotOf<glm::vec2>(name), value);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    upload(typedSlotOf<glm::vec3>(name), value);
 }
 
 void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
 {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    upload(typedSlotOf<glm::vec4>(name), value);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    upload(typedSlotOf<glm::mat4>(name), mat);
+}
+
+uint64_t Shader::uniformCallCount()
+{
+    return uniformCalls;
+}
+
+uint64_t Shader::skippedUniformCount()
+{
+    return skippedUniforms;
+}
+
+void Shader::resetUniformCounters()
+{
+    uniformCalls = 0;
+    skippedUniforms = 0;
 }
 
 /**
@@ -6,7 +6,7 @@
 /**
  * @brief Construtor que inicializa o estado padrão do sol e gera sua malha.
  */
-Sun::Sun(Shader &shader) : m_shader(shader)
+Sun::Sun(Shader &shader, GeometryArena &geometry) : m_shader(shader), m_geometry(geometry)
 {
     // Inicializa os valores padrão para garantir um estado válido antes da primeira atualização.
     m_position = glm::vec3(0.0f);
@@ -19,13 +19,11 @@ Sun::Sun(Shader &shader) : m_shader(shader)
 }
 
 /**
- * @brief Destrutor que libera os buffers da GPU.
+ * @brief Destrutor que devolve a malha à arena.
  */
 Sun::~Sun()
 {
-    glDeleteVertexArrays(1, &m_vao);
-    glDeleteBuffers(1, &m_vbo);
-    glDeleteBuffers(1, &m_ebo);
+    m_geometry.free(m_range);
 }
 
 /**
@@ -100,21 +98,16 @@ void Sun::Draw(const glm::mat4 &view, const glm::mat4 &projection)
     m_shader.setMat4("model", model);
 
     // Desenha a malha da esfera.
-    glBindVertexArray(m_vao);
-    glDrawElements(GL_TRIANGLE_STRIP, m_indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    m_geometry.bind(VertexFormat::Position);
+    m_geometry.draw(m_range, GL_TRIANGLE_STRIP);
 }
 
 /**
  * @brief Gera proceduralmente a malha de uma esfera.
- * Cria os vértices e índices para uma esfera UV e os envia para a GPU.
+ * Cria os vértices e índices para uma esfera UV e os aloca na arena (formato Position).
  */
 void Sun::setupSphereMesh()
 {
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-    glGenBuffers(1, &m_ebo);
-
     std::vector<glm::vec3> positions;
     std::vector<unsigned int> indices;
 
@@ -157,17 +150,7 @@ void Sun::setupSphereMesh()
         }
         oddRow = !oddRow;
     }
-    m_indexCount = indices.size();
 
     // Envia os dados para a GPU.
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), &positions[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // Configura o atributo de vértice para a posição.
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
-    glBindVertexArray(0);
-}
\ No newline at end of file
+    m_range = m_geometry.allocate(VertexFormat::Position, positions.data(), positions.size(), indices.data(), indices.size());
+}
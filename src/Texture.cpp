@@ -0,0 +1,65 @@
+#include "Texture.hpp"
+
+// As constantes de S3TC (BC1/BC3) vêm de uma extensão que não está no glad gerado para o projeto.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+/**
+ * @brief Envia os níveis já comprimidos para uma nova textura OpenGL.
+ * Se a imagem não pôde ser carregada, a textura fica vazia (o carregamento já reportou o erro).
+ */
+Texture::Texture(const worldgen::CompressedTexture &image, const TextureOptions &options)
+{
+    glGenTextures(1, &m_id);
+    if (!image)
+        return;
+
+    // Sem mipmaps, só o nível 0 é enviado.
+    GLsizei levelCount = options.mipmaps ? static_cast<GLsizei>(image.levelCount()) : 1;
+    GLenum format = internalFormat(image.format());
+
+    glBindTexture(GL_TEXTURE_2D, m_id);
+    for (GLsizei i = 0; i < levelCount; ++i)
+    {
+        const worldgen::TextureLevel &level = image.level(i);
+        glCompressedTexImage2D(GL_TEXTURE_2D, i, format, level.width, level.height, 0,
+                               static_cast<GLsizei>(level.size), image.levelData(i));
+        m_byteSize += level.size;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+}
+
+Texture::~Texture()
+{
+    glDeleteTextures(1, &m_id);
+}
+
+void Texture::bind() const
+{
+    glBindTexture(GL_TEXTURE_2D, m_id);
+}
+
+GLenum Texture::internalFormat(worldgen::BlockFormat format)
+{
+    switch (format)
+    {
+    case worldgen::BlockFormat::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case worldgen::BlockFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case worldgen::BlockFormat::BC4:
+        return GL_COMPRESSED_RED_RGTC1;
+    case worldgen::BlockFormat::BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+    }
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
@@ -0,0 +1,54 @@
+#include "TextureArray.hpp"
+#include <stdexcept>
+
+/**
+ * @brief Reserva todas as camadas e níveis de uma vez (glTexStorage3D) e envia os blocos de cada
+ * imagem para a sua camada, nível a nível.
+ */
+TextureArray::TextureArray(const std::vector<const worldgen::CompressedTexture *> &layers, const TextureOptions &options)
+{
+    if (layers.empty() || !*layers[0])
+        throw std::runtime_error("TextureArray: a primeira camada não pôde ser carregada");
+
+    const worldgen::CompressedTexture &first = *layers[0];
+    for (const worldgen::CompressedTexture *layer : layers)
+    {
+        if (!*layer || layer->format() != first.format() || layer->levelCount() != first.levelCount() ||
+            layer->level(0).width != first.level(0).width || layer->level(0).height != first.level(0).height)
+            throw std::runtime_error("TextureArray: todas as camadas precisam ter o mesmo tamanho e formato");
+    }
+
+    m_layerCount = static_cast<unsigned int>(layers.size());
+    GLsizei levelCount = options.mipmaps ? static_cast<GLsizei>(first.levelCount()) : 1;
+
+    glGenTextures(1, &m_id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, Texture::internalFormat(first.format()),
+                   first.level(0).width, first.level(0).height, m_layerCount);
+    for (GLsizei level = 0; level < levelCount; ++level)
+    {
+        const worldgen::TextureLevel &size = first.level(level);
+        for (unsigned int layer = 0; layer < m_layerCount; ++layer)
+        {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, size.width, size.height, 1,
+                                      Texture::internalFormat(first.format()), static_cast<GLsizei>(size.size),
+                                      layers[layer]->levelData(level));
+            m_byteSize += size.size;
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, options.mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+}
+
+TextureArray::~TextureArray()
+{
+    glDeleteTextures(1, &m_id);
+}
+
+void TextureArray::bind() const
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+}
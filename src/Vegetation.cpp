@@ -1,70 +1,66 @@
 #include "Vegetation.hpp"
-#include <glm/gtc/matrix_transform.hpp>
-#include <cstdlib> // Para rand()
-#include <glm/gtc/quaternion.hpp>
-#include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace
+{
+    // Erro geométrico máximo tolerado ao trocar de LOD, em pixels na tela.
+    const float MAX_LOD_PIXEL_ERROR = 1.0f;
+    // Lado das células da grade de culling, em unidades do mundo.
+    const float GRID_CELL_SIZE = 32.0f;
+    // Faixa de distância em que a malha dá lugar ao impostor (ver ImpostorAtlas).
+    const float IMPOSTOR_FADE_START = 40.0f;
+    const float IMPOSTOR_FADE_END = 50.0f;
+    // Sem impostor, a faixa fica fora de alcance e a malha nunca some.
+    const float NO_IMPOSTOR_DISTANCE = 1e30f;
+}
 
 /**
- * @brief Construtor que gera as matrizes de transformação para cada instância.
+ * @brief Construtor que recebe as instâncias (matriz e variante), geradas pela libworldgen,
+ * e as envia para a GPU.
  */
-Vegetation::Vegetation(Terrain &terrain, Shader &shader, Model &model, int count, float minHeight, float maxHeight, float scale, glm::vec3 modelUp)
-    : m_shader(shader), m_model(model), m_count(count)
+Vegetation::Uniforms::Uniforms(const Shader &shader)
+    : projection(shader.uniform<glm::mat4>("projection")), view(shader.uniform<glm::mat4>("view")),
+      textureDiffuse(shader.uniform<int>("texture_diffuse1")), impostorFadeStart(shader.uniform<float>("impostorFadeStart")),
+      impostorFadeEnd(shader.uniform<float>("impostorFadeEnd")), position(shader), impostor(shader)
 {
-    m_modelMatrices.reserve(m_count); // Pré-aloca memória para evitar realocações.
-    int terrainWidth = terrain.getWidth();
-    int terrainDepth = terrain.getDepth();
-
-    // Loop para gerar a posição e rotação de cada instância.
-    for (int i = 0; i < m_count; ++i)
-    {
-        // Gera uma posição aleatória na grade do terreno.
-        int randX = rand() % terrainWidth;
-        int randZ = rand() % terrainDepth;
-        // Obtém a altura do terreno nessa posição.
-        float height = terrain.getHeight(randX, randZ);
-
-        // Coloca a vegetação apenas se estiver dentro da faixa de altura especificada.
-        if (height >= minHeight && height <= maxHeight)
-        {
-            // Converte as coordenadas da grade para coordenadas do mundo.
-            float worldX = static_cast<float>(randX) - terrainWidth / 2.0f;
-            float worldZ = static_cast<float>(randZ) - terrainDepth / 2.0f;
-
-            // LÓGICA DE ROTAÇÃO PARA ALINHAMENTO COM O TERRENO
-
-            // 1. Obtém a normal da superfície do terreno, que indica a sua inclinação.
-            glm::vec3 terrainNormal = terrain.getNormal(worldX, worldZ);
-
-            // 2. Calcula a rotação necessária para alinhar o vetor "para cima" do modelo com a normal do terreno.
-            // O uso de quaterniões (glm::quat) é mais robusto para cálculos de rotação 3D.
-            glm::quat rotationQuat = glm::rotation(modelUp, terrainNormal);
-            glm::mat4 rotationMatrix = glm::toMat4(rotationQuat);
-
-            // 3. Adiciona uma rotação aleatória em torno do eixo Y para variar a orientação.
-            float randomYaw = glm::radians((float)(rand() % 360));
-            rotationMatrix = glm::rotate(rotationMatrix, randomYaw, modelUp);
+}
 
-            // 4. Constrói a matriz de modelo final, aplicando translação, rotação e escala.
-            glm::mat4 modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::translate(modelMatrix, glm::vec3(worldX, height, worldZ)); // Posição
-            modelMatrix = modelMatrix * rotationMatrix;                                   // Rotação (alinhamento + aleatória)
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(scale));                      // Escala
+Vegetation::Vegetation(Shader &shader, std::shared_ptr<Model> model, std::shared_ptr<TextureArray> textures, std::vector<worldgen::InstanceData> instances,
+                       Shader *cullShader, std::shared_ptr<ImpostorAtlas> impostor, Shader *impostorShader)
+    : m_shader(shader), m_model(std::move(model)), m_textures(std::move(textures)), m_impostor(impostorShader ? std::move(impostor) : nullptr),
+      m_impostorShader(impostorShader), m_uniforms(shader), m_impostorUniforms(m_impostor ? Uniforms(*impostorShader) : Uniforms()),
+      m_count(static_cast<int>(instances.size())), m_instances(std::move(instances))
+{
+    // Agrupa as instâncias em células do terreno (reordenando-as) antes de tudo o mais.
+    m_grid = worldgen::InstanceGrid(m_instances, m_model->getBounds(), GRID_CELL_SIZE);
 
-            m_modelMatrices.push_back(modelMatrix);
-        }
-    }
-    // Atualiza a contagem para o número real de instâncias geradas.
-    m_count = m_modelMatrices.size();
+    // Na transição, uma instância entra tanto no grupo da malha quanto no do impostor.
+    m_lodInstances.resize(m_impostor ? 2 * m_count : m_count);
+    m_lodCounts.resize(m_model->getLods().size());
+    m_instanceLod.resize(m_count);
+    if (m_impostor)
+        m_impostorInstances.reserve(m_count);
 
     // Configura os buffers da GPU apenas se alguma instância foi criada.
     if (m_count > 0)
     {
         setupBuffers();
+        // Sem limite de distância: os LODs já reduzem o custo das instâncias distantes.
+        if (cullShader)
+        {
+            InstanceCuller::ImpostorRange range;
+            if (m_impostor)
+                range = {m_impostor->indirectCommand(), IMPOSTOR_FADE_START, IMPOSTOR_FADE_END};
+            m_culler = std::make_unique<InstanceCuller>(*cullShader, m_instanceVBO, static_cast<uint32_t>(m_count), *m_model, m_model->getLods().size(), 1e30f,
+                                                        m_impostor ? &range : nullptr);
+        }
     }
 }
 
 /**
- * @brief Destrutor que libera o VBO de instâncias.
+ * @brief Destrutor que libera o VBO de instâncias. O modelo é liberado pelo seu último dono.
  */
 Vegetation::~Vegetation()
 {
@@ -75,59 +71,187 @@ Vegetation::~Vegetation()
 }
 
 /**
- * @brief Envia as matrizes de modelo para a GPU e configura os atributos de vértice.
+ * @brief Envia as instâncias para a GPU.
+ * Os atributos de instância (3-6) ficam no VAO instanciado da GeometryArena, compartilhado por
+ * todos os modelos do mesmo formato; este VBO é ligado a ele a cada desenho.
  */
 void Vegetation::setupBuffers()
 {
-    // Gera e preenche o VBO com os dados de todas as matrizes de modelo.
     glGenBuffers(1, &m_instanceVBO);
     glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, m_count * sizeof(glm::mat4), m_modelMatrices.data(), GL_STATIC_DRAW);
-
-    // Vincula o VAO do modelo original para adicionar a configuração de instanciamento.
-    unsigned int VAO = m_model.getVAO();
-    glBindVertexArray(VAO);
-
-    // Configura os atributos de vértice para a matriz de instância.
-    // Uma mat4 é tratada como 4 atributos vec4 no shader.
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)0);
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(sizeof(glm::vec4)));
-    glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(2 * sizeof(glm::vec4)));
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(3 * sizeof(glm::vec4)));
-
-    // Informa ao OpenGL que estes atributos devem ser atualizados uma vez por instância, não por vértice.
-    glVertexAttribDivisor(3, 1);
-    glVertexAttribDivisor(4, 1);
-    glVertexAttribDivisor(5, 1);
-    glVertexAttribDivisor(6, 1);
-
-    glBindVertexArray(0);
+    // No culling pela CPU, o conteúdo é reordenado por LOD a cada desenho (com espaço para o grupo do impostor);
+    // na GPU, ele não muda.
+    glBufferData(GL_ARRAY_BUFFER, m_lodInstances.size() * sizeof(worldgen::InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_count * sizeof(worldgen::InstanceData), m_instances.data());
 }
 
 /**
- * @brief Desenha todas as instâncias do modelo.
+ * @brief Agrupa as instâncias das células visíveis (m_visibleRanges) por LOD (ordenação por contagem, estável).
+ * O erro de cada LOD, em unidades do modelo, vira pixels multiplicando pela escala da instância
+ * e pelo fator de projeção (pixels por unidade a uma distância de 1) e dividindo pela distância.
+ * Nas passadas de reflexão/refração, o alvo menor (viewportHeight) naturalmente escolhe LODs mais simples.
  */
-void Vegetation::Draw(const glm::mat4 &view, const glm::mat4 &projection)
+void Vegetation::bucketByLod(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, float maxPixelError, float maxDistance)
+{
+    const std::vector<worldgen::MeshLod> &lods = m_model->getLods();
+    glm::vec3 cameraPos = glm::vec3(glm::inverse(view)[3]);
+    float pixelsPerUnit = projection[1][1] * viewportHeight * 0.5f;
+
+    // Sem impostor, a faixa de transição fica fora de alcance e toda instância usa a malha.
+    float fadeStart = m_impostor ? IMPOSTOR_FADE_START : NO_IMPOSTOR_DISTANCE;
+    float fadeEnd = m_impostor ? IMPOSTOR_FADE_END : NO_IMPOSTOR_DISTANCE;
+
+    // UINT_MAX marca as instâncias que só usam o impostor. Só as das células visíveis são escritas e lidas.
+    m_impostorInstances.clear();
+    std::fill(m_lodCounts.begin(), m_lodCounts.end(), 0);
+    for (const worldgen::InstanceRange &range : m_visibleRanges)
+    {
+        for (uint32_t i = range.first; i < range.first + range.count; ++i)
+        {
+            float distance = glm::length(m_instances[i].position - cameraPos);
+            if (distance > maxDistance)
+            {
+                m_instanceLod[i] = UINT_MAX;
+                continue;
+            }
+            if (distance >= fadeStart)
+                m_impostorInstances.push_back(i);
+            if (distance >= fadeEnd)
+            {
+                m_instanceLod[i] = UINT_MAX;
+                continue;
+            }
+
+            // Distância a partir da qual o erro de um LOD fica abaixo do limite: erro * escala * fator / limite.
+            float errorScale = m_instances[i].maxScale() * pixelsPerUnit / maxPixelError;
+
+            unsigned int lod = 0;
+            while (lod + 1 < lods.size() && lods[lod + 1].error * errorScale <= distance)
+                ++lod;
+            m_instanceLod[i] = lod;
+            ++m_lodCounts[lod];
+        }
+    }
+
+    m_lodNext.assign(lods.size(), 0);
+    for (size_t lod = 1; lod < lods.size(); ++lod)
+        m_lodNext[lod] = m_lodNext[lod - 1] + m_lodCounts[lod - 1];
+    for (const worldgen::InstanceRange &range : m_visibleRanges)
+    {
+        for (uint32_t i = range.first; i < range.first + range.count; ++i)
+        {
+            if (m_instanceLod[i] != UINT_MAX)
+                m_lodInstances[m_lodNext[m_instanceLod[i]]++] = m_instances[i];
+        }
+    }
+
+    unsigned int meshCount = lods.empty() ? 0 : m_lodNext.back();
+    m_impostorCount = static_cast<unsigned int>(m_impostorInstances.size());
+    for (unsigned int k = 0; k < m_impostorCount; ++k)
+        m_lodInstances[meshCount + k] = m_instances[m_impostorInstances[k]];
+}
+
+void Vegetation::drawImpostors(const glm::mat4 &view, const glm::mat4 &projection, unsigned int baseInstance)
+{
+    m_impostorShader->use();
+    m_impostorUniforms.projection.set(projection);
+    m_impostorUniforms.view.set(view);
+    m_impostorUniforms.impostorFadeStart.set(IMPOSTOR_FADE_START);
+    m_impostorUniforms.impostorFadeEnd.set(IMPOSTOR_FADE_END);
+    m_impostor->bind(m_impostorUniforms.impostor, 0, 1);
+
+    if (m_culler)
+    {
+        m_culler->drawImpostors(*m_impostor);
+    }
+    else
+    {
+        m_impostor->bindInstanced(m_instanceVBO);
+        m_impostor->drawInstanced(m_impostorCount, baseInstance);
+    }
+}
+
+/**
+ * @brief Desenha as instâncias visíveis do modelo, com uma chamada instanciada por LOD.
+ */
+void Vegetation::Draw(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight, const glm::vec4 &clipPlane,
+                      worldgen::CullStats *stats, float lodBias, float maxDistance)
 {
     if (m_count == 0)
         return;
+    float maxPixelError = MAX_LOD_PIXEL_ERROR * std::exp2(lodBias);
+
+    // Descarta as instâncias fora do frustum: por instância na GPU (antes de ativar o shader da vegetação,
+    // pois o compute shader usa o seu próprio programa) ou por célula na CPU; se nada sobrar, não há o que enviar.
+    if (m_culler)
+    {
+        m_culler->cull(view, projection, viewportHeight, clipPlane, maxPixelError, maxDistance);
+    }
+    else
+    {
+        m_grid.cull(worldgen::Frustum::fromMatrix(projection * view, clipPlane), m_visibleRanges, stats);
+        if (m_visibleRanges.empty())
+            return;
+    }
 
     // Ativa e configura o shader com os uniformes necessários.
     m_shader.use();
-    m_shader.setMat4("projection", projection);
-    m_shader.setMat4("view", view);
-    m_shader.setInt("texture_diffuse1", 0);
+    m_uniforms.projection.set(projection);
+    m_uniforms.view.set(view);
+    m_uniforms.textureDiffuse.set(0);
+    m_uniforms.impostorFadeStart.set(m_impostor ? IMPOSTOR_FADE_START : NO_IMPOSTOR_DISTANCE);
+    m_uniforms.impostorFadeEnd.set(m_impostor ? IMPOSTOR_FADE_END : NO_IMPOSTOR_DISTANCE);
+    m_model->setPositionUniforms(m_uniforms.position);
 
-    // Ativa e vincula a textura do modelo.
+    // Ativa e vincula a textura array com as variantes do modelo.
     glActiveTexture(GL_TEXTURE0);
-    m_model.bindTexture();
+    m_textures->bind();
+
+    if (m_culler)
+    {
+        // Os LODs e as contagens ficam na GPU: um único desenho indireto, sem leitura de volta.
+        size_t draws = m_culler->draw(*m_model);
+        if (m_impostor)
+        {
+            drawImpostors(view, projection, 0);
+            ++draws;
+        }
+        if (stats)
+        {
+            stats->gpuTested += m_count;
+            stats->draws += draws;
+        }
+        return;
+    }
+
+    // Reordena as instâncias visíveis por LOD e envia apenas elas para a GPU.
+    bucketByLod(view, projection, viewportHeight, maxPixelError, maxDistance);
+    unsigned int visibleCount = 0;
+    for (unsigned int count : m_lodCounts)
+        visibleCount += count;
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_lodInstances.size() * sizeof(worldgen::InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (visibleCount + m_impostorCount) * sizeof(worldgen::InstanceData), m_lodInstances.data());
+
+    // Cada LOD é um intervalo dos índices do modelo; o baseInstance aponta para o seu grupo de instâncias.
+    m_model->bindInstanced(m_instanceVBO);
+    unsigned int baseInstance = 0;
+    for (size_t lod = 0; lod < m_lodCounts.size(); ++lod)
+    {
+        if (m_lodCounts[lod] > 0)
+        {
+            m_model->drawLodInstanced(lod, m_lodCounts[lod], baseInstance);
+            if (stats)
+                ++stats->draws;
+        }
+        baseInstance += m_lodCounts[lod];
+    }
 
-    // Vincula o VAO e faz a chamada de desenho instanciada.
-    glBindVertexArray(m_model.getVAO());
-    glDrawElementsInstanced(GL_TRIANGLES, m_model.getIndicesCount(), GL_UNSIGNED_INT, 0, m_count);
-    glBindVertexArray(0);
+    // As instâncias distantes vêm logo depois das da malha.
+    if (m_impostor && m_impostorCount > 0)
+    {
+        drawImpostors(view, projection, visibleCount);
+        if (stats)
+            ++stats->draws;
+    }
 }
\ No newline at end of file
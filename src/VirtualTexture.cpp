@@ -0,0 +1,227 @@
+#include "VirtualTexture.hpp"
+#include "Texture.hpp"
+#include <iostream>
+
+namespace
+{
+    // Páginas sendo compostas ao mesmo tempo. Limita a fila do loader, para que os pedidos
+    // acompanhem a câmera em vez de se acumularem.
+    const size_t MAX_PAGES_IN_FLIGHT = 8;
+}
+
+/**
+ * @brief Cria o atlas, a tabela de páginas e o framebuffer de feedback, e envia a página do último nível
+ * (a textura inteira em uma página), que fica fixada como reserva para qualquer página ausente.
+ */
+VirtualTexture::VirtualTexture(const worldgen::VirtualTextureLayout &layout, uint32_t slotsPerSide, AssetLoader &loader, PageSource source,
+                               int feedbackWidth, int feedbackHeight)
+    : m_layout(layout), m_cache(layout, slotsPerSide), m_loader(loader), m_source(std::make_shared<const PageSource>(std::move(source))),
+      m_feedbackWidth(feedbackWidth), m_feedbackHeight(feedbackHeight)
+{
+    GLsizei atlasSize = static_cast<GLsizei>(m_cache.slotsPerSide() * m_layout.slotSize());
+    glGenTextures(1, &m_atlas);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glTexStorage2D(GL_TEXTURE_2D, 1, Texture::internalFormat(worldgen::BlockFormat::BC1), atlasSize, atlasSize);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // A tabela é lida com texelFetch: sem filtragem, um mipmap por nível da textura virtual.
+    GLsizei levelCount = static_cast<GLsizei>(m_layout.levelCount());
+    glGenTextures(1, &m_pageTable);
+    glBindTexture(GL_TEXTURE_2D, m_pageTable);
+    glTexStorage2D(GL_TEXTURE_2D, levelCount, GL_RGBA8UI, m_layout.pagesPerSide, m_layout.pagesPerSide);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    // Feedback: um PageId (uint) por pixel, numa resolução bem menor que a da tela.
+    glGenFramebuffers(1, &m_feedbackFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFBO);
+    glGenTextures(1, &m_feedbackTexture);
+    glBindTexture(GL_TEXTURE_2D, m_feedbackTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, m_feedbackWidth, m_feedbackHeight);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_feedbackTexture, 0);
+    glGenRenderbuffers(1, &m_feedbackDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_feedbackDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_feedbackWidth, m_feedbackHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_feedbackDepth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERRO::FRAMEBUFFER:: O framebuffer de feedback da textura virtual não está completo!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenBuffers(1, &m_feedbackPBO);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPBO);
+    glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(m_feedbackWidth) * m_feedbackHeight * sizeof(uint32_t), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    worldgen::PageId root{m_layout.levelCount() - 1, 0, 0};
+    uint32_t slot;
+    m_cache.insert(root, m_frame, slot, true);
+    std::vector<uint8_t> blocks = worldgen::compressImage((*m_source)(root), worldgen::BlockFormat::BC1);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_cache.slotsPerSide()) * m_layout.slotSize(), (slot / m_cache.slotsPerSide()) * m_layout.slotSize(),
+                              m_layout.slotSize(), m_layout.slotSize(), Texture::internalFormat(worldgen::BlockFormat::BC1),
+                              static_cast<GLsizei>(blocks.size()), blocks.data());
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    if (m_feedbackFence)
+        glDeleteSync(m_feedbackFence);
+    glDeleteBuffers(1, &m_feedbackPBO);
+    glDeleteRenderbuffers(1, &m_feedbackDepth);
+    glDeleteTextures(1, &m_feedbackTexture);
+    glDeleteFramebuffers(1, &m_feedbackFBO);
+    glDeleteTextures(1, &m_pageTable);
+    glDeleteTextures(1, &m_atlas);
+}
+
+void VirtualTexture::update()
+{
+    ++m_frame;
+    if (!m_feedbackFence)
+        return;
+
+    // Sem espera: se a GPU ainda não terminou a leitura, tenta de novo no próximo frame.
+    GLenum status = glClientWaitSync(m_feedbackFence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return;
+    glDeleteSync(m_feedbackFence);
+    m_feedbackFence = nullptr;
+
+    size_t pixelCount = static_cast<size_t>(m_feedbackWidth) * m_feedbackHeight;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPBO);
+    const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pixelCount * sizeof(uint32_t), GL_MAP_READ_BIT);
+    if (data)
+    {
+        processFeedback(static_cast<const uint32_t *>(data), pixelCount);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/**
+ * @brief Renova as páginas vistas e pede, em ordem de prioridade, as que ainda não estão no atlas.
+ */
+void VirtualTexture::processFeedback(const uint32_t *feedback, size_t pixelCount)
+{
+    std::vector<worldgen::PageId> requests = worldgen::collectPageRequests(feedback, pixelCount, m_layout);
+    for (const worldgen::PageId &page : requests)
+        m_cache.touch(page, m_frame);
+
+    for (const worldgen::PageId &page : requests)
+    {
+        if (m_inFlight.size() >= MAX_PAGES_IN_FLIGHT)
+            break;
+        if (m_cache.isResident(page) || !m_inFlight.insert(page.pack()).second)
+            continue;
+
+        std::shared_ptr<const PageSource> source = m_source;
+        m_loader.submit([this, source, page]()
+                        {
+            try
+            {
+                auto blocks = std::make_shared<const std::vector<uint8_t>>(worldgen::compressImage((*source)(page), worldgen::BlockFormat::BC1));
+                return AssetLoader::Upload([this, page, blocks]()
+                                           { uploadPage(page, *blocks); });
+            }
+            catch (...)
+            {
+                // A página sai da lista de pedidos (para ser pedida de novo) e o erro segue para a thread principal.
+                return AssetLoader::Upload([this, page, error = std::current_exception()]()
+                                           {
+                    m_inFlight.erase(page.pack());
+                    std::rethrow_exception(error); });
+            } });
+    }
+}
+
+void VirtualTexture::uploadPage(worldgen::PageId page, const std::vector<uint8_t> &blocks)
+{
+    m_inFlight.erase(page.pack());
+
+    // Sem slot livre nem página antiga para despejar, a página é descartada e será pedida de novo.
+    uint32_t slot;
+    if (!m_cache.insert(page, m_frame, slot))
+        return;
+
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_cache.slotsPerSide()) * m_layout.slotSize(), (slot / m_cache.slotsPerSide()) * m_layout.slotSize(),
+                              m_layout.slotSize(), m_layout.slotSize(), Texture::internalFormat(worldgen::BlockFormat::BC1),
+                              static_cast<GLsizei>(blocks.size()), blocks.data());
+    m_pageTableDirty = true;
+}
+
+void VirtualTexture::uploadPageTable()
+{
+    m_cache.buildPageTable(m_pageTables);
+    glBindTexture(GL_TEXTURE_2D, m_pageTable);
+    for (size_t level = 0; level < m_pageTables.size(); ++level)
+    {
+        GLsizei pages = static_cast<GLsizei>(m_layout.pagesAt(static_cast<uint32_t>(level)));
+        glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, pages, pages, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, m_pageTables[level].data());
+    }
+    m_pageTableDirty = false;
+}
+
+VirtualTexture::Uniforms::Uniforms(const Shader &shader)
+    : atlas(shader.uniform<int>("vtAtlas")), pageTable(shader.uniform<int>("vtPageTable")),
+      pagesPerSide(shader.uniform<float>("vtPagesPerSide")), pageSize(shader.uniform<float>("vtPageSize")),
+      border(shader.uniform<float>("vtBorder")), atlasSize(shader.uniform<float>("vtAtlasSize")),
+      maxLevel(shader.uniform<int>("vtMaxLevel")), lodBias(shader.uniform<float>("vtLodBias"))
+{
+}
+
+void VirtualTexture::bind(const Uniforms &uniforms, int atlasUnit, int pageTableUnit, float lodBias)
+{
+    if (m_pageTableDirty)
+        uploadPageTable();
+
+    glActiveTexture(GL_TEXTURE0 + atlasUnit);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glActiveTexture(GL_TEXTURE0 + pageTableUnit);
+    glBindTexture(GL_TEXTURE_2D, m_pageTable);
+
+    uniforms.atlas.set(atlasUnit);
+    uniforms.pageTable.set(pageTableUnit);
+    uniforms.pagesPerSide.set(static_cast<float>(m_layout.pagesPerSide));
+    uniforms.pageSize.set(static_cast<float>(m_layout.pageSize));
+    uniforms.border.set(static_cast<float>(m_layout.border));
+    uniforms.atlasSize.set(static_cast<float>(m_cache.slotsPerSide() * m_layout.slotSize()));
+    uniforms.maxLevel.set(static_cast<int>(m_layout.levelCount()) - 1);
+    uniforms.lodBias.set(lodBias);
+}
+
+bool VirtualTexture::beginFeedback(Shader &shader, const Uniforms &uniforms, float lodBias)
+{
+    if (m_feedbackFence)
+        return false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFBO);
+    glViewport(0, 0, m_feedbackWidth, m_feedbackHeight);
+    const GLuint noPage[4] = {worldgen::NO_PAGE, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, noPage);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    shader.use();
+    uniforms.pagesPerSide.set(static_cast<float>(m_layout.pagesPerSide));
+    uniforms.pageSize.set(static_cast<float>(m_layout.pageSize));
+    uniforms.maxLevel.set(static_cast<int>(m_layout.levelCount()) - 1);
+    uniforms.lodBias.set(lodBias);
+    return true;
+}
+
+void VirtualTexture::endFeedback(int screenWidth, int screenHeight)
+{
+    // A cópia para o PBO é assíncrona; a fence avisa quando os dados podem ser lidos sem travar.
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPBO);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, m_feedbackWidth, m_feedbackHeight, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_feedbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
@@ -4,23 +4,21 @@
 /**
  * @brief O construtor apenas inicializa a malha da água.
  */
-Water::Water(float width, float depth, Shader &shader) : m_width(width), m_depth(depth)
+Water::Water(float width, float depth, Shader &shader, GeometryArena &geometry) : m_geometry(geometry), m_width(width), m_depth(depth)
 {
     setupMesh();
 }
 
 /**
- * @brief Destrutor que libera os buffers da GPU.
+ * @brief Destrutor que devolve a malha à arena.
  */
 Water::~Water()
 {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    m_geometry.free(m_range);
 }
 
 /**
- * @brief Cria e configura a geometria de um plano simples.
+ * @brief Cria a geometria de um plano simples e a aloca na arena (formato Position).
  * Esta malha servirá como a superfície sobre a qual os shaders desenharão os efeitos da água.
  */
 void Water::setupMesh()
@@ -40,24 +38,7 @@ void Water::setupMesh()
     // Índices para desenhar o plano usando dois triângulos.
     unsigned int indices[] = {0, 1, 2, 2, 3, 0};
 
-    // Configuração padrão dos buffers (VAO, VBO, EBO).
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // Configura o atributo de vértice para a posição (layout = 0).
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-
-    glBindVertexArray(0);
+    m_range = m_geometry.allocate(VertexFormat::Position, vertices, 4, indices, 6);
 }
 
 /**
@@ -71,7 +52,6 @@ void Water::Draw(const glm::mat4 &modelMatrix)
     // são responsabilidade do chamador (neste caso, o loop principal em main.cpp).
     // Isso mantém a classe Water focada apenas na sua geometria.
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0); // Desenha os 2 triângulos (6 vértices).
-    glBindVertexArray(0);
+    m_geometry.bind(VertexFormat::Position);
+    m_geometry.draw(m_range); // Desenha os 2 triângulos (6 índices).
 }
\ No newline at end of file
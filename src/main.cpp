@@ -4,6 +4,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 #include "Shader.hpp"
 #include "Camera.hpp"
@@ -11,27 +12,81 @@
 #include "Sun.hpp"
 #include "Water.hpp"
 #include "GrassField.hpp"
+#include "ProceduralGrass.hpp"
 #include "Vegetation.hpp"
 #include "WaterFrameBuffers.hpp" // Inclui a nova classe
-#include <stb_image.h>
+#include "GeometryArena.hpp"
+#include "ResourceManager.hpp"
+#include "AssetLoader.hpp"
+#include "InstanceCuller.hpp"
+#include "RenderPass.hpp"
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/Culling.hpp"
+#include "worldgen/Placement.hpp"
+#include "worldgen/TerrainSurface.hpp"
+
+// Um programa desenhado em cada passada e os uniformes comuns a todas, resolvidos uma única vez.
+// Programas que não declaram algum deles (o sol só usa 'plane') recebem um handle inválido, que é ignorado.
+struct PassShader
+{
+    explicit PassShader(Shader &shader)
+        : shader(shader), viewPos(shader.uniform<glm::vec3>("viewPos")), lightDir(shader.uniform<glm::vec3>("lightDir")),
+          lightColor(shader.uniform<glm::vec3>("lightColor")), plane(shader.uniform<glm::vec4>("plane"))
+    {
+    }
+
+    // Ativa o programa e envia os uniformes da passada.
+    void apply(const glm::vec3 &eye, const glm::vec3 &light, const glm::vec3 &color, const glm::vec4 &clipPlane) const
+    {
+        shader.use();
+        viewPos.set(eye);
+        lightDir.set(light);
+        lightColor.set(color);
+        plane.set(clipPlane);
+    }
+
+    Shader &shader;
+    Uniform<glm::vec3> viewPos;
+    Uniform<glm::vec3> lightDir;
+    Uniform<glm::vec3> lightColor;
+    Uniform<glm::vec4> plane;
+};
 
 // Protótipos das callbacks e funções auxiliares
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
-unsigned int loadTexture(const char *path);
-void renderScene(const glm::vec4 &clipPlane, const glm::mat4 &view, const glm::mat4 &projection,
-                 Terrain &terrain, Sun &sun, GrassField &grass,
-                 std::vector<std::reference_wrapper<Vegetation>> &vegetation, // <-- MUDANÇA AQUI
-                 Shader &terrainShader, Shader &sunShader, Shader &grassShader, Shader &vegetationShader);
+void renderScene(const PassSettings &pass, const glm::vec4 &clipPlane, const glm::mat4 &view, const glm::mat4 &projection,
+                 Terrain *terrain, Sun &sun, GrassField *grass, ProceduralGrass *grassBlades,
+                 std::vector<std::unique_ptr<Vegetation>> &vegetation,
+                 const PassShader &terrainShader, const PassShader &sunShader, const PassShader &grassShader,
+                 const PassShader &grassBladesShader, const PassShader &vegetationShader, const PassShader &impostorShader,
+                 worldgen::CullStats &stats);
 
 glm::vec3 getPathPosition(float t, bool &finished);
 
+// Um tipo de vegetação da cena: modelo, texturas das variantes (uma camada da textura array cada)
+// e parâmetros de distribuição.
+struct VegetationSpec
+{
+    std::string modelPath;
+    std::vector<std::string> texturePaths;
+    worldgen::VegetationParams params;
+};
+
+void submitVegetation(AssetLoader &loader, ResourceManager &resources, std::vector<glm::mat4> transforms,
+                      const VegetationSpec &spec, Shader &shader, Shader *cullShader,
+                      GeometryArena &geometry, Shader &impostorBakeShader, Shader &impostorShader,
+                      std::vector<std::unique_ptr<Vegetation>> &vegetation);
+
 // Configurações da Janela e do Mundo
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
 const float WATER_HEIGHT = -13.0f; // Coordenada Y da superfície da água
+const int TERRAIN_SIZE = 512;      // Largura e profundidade da grade do terreno
+const double UPLOAD_BUDGET_MS = 4.0; // Tempo máximo por frame gasto enviando recursos carregados à GPU
+const double CULL_STATS_INTERVAL = 5.0; // Segundos entre dois relatórios do culling
 
 // Estado da Câmara
 Camera camera(glm::vec3(0.0f, 30.0f, 100.0f)); // Objeto da câmera principal
@@ -58,6 +113,9 @@ float pathSpeed = 10.0f;              // Velocidade da câmara cinemática
 float y_offset = 30.0f;               // Elevação adicional para os pontos de controlo
 std::vector<glm::vec3> controlPoints; // Pontos que definem o caminho da câmara
 
+// Grama: tufos em ladrilhos (GrassField) ou lâminas geradas no vertex shader (ProceduralGrass), alternados com a tecla G
+bool proceduralGrass = false;
+
 int main()
 {
     // Inicialização
@@ -90,46 +148,173 @@ int main()
     // esse escopo aqui tá aberto por que o glfwterminate tava finalizando tudo antes dos destrutores serem chamados,
     // causando falha de segmentação, isso aqui garante que isso não ocorra.
     {
+        // Buffers de geometria compartilhados por todas as malhas, e o gerenciador de recursos:
+        // criados antes de todos os objetos que os usam, são destruídos por último, ainda dentro deste escopo.
+        GeometryArena geometry;
+        ResourceManager resources(geometry);
+
         // Shaders e Objetos
         Shader terrainShader("shaders/terrain.vert", "shaders/terrain.frag");
+        Shader terrainFeedbackShader("shaders/terrain.vert", "shaders/terrain_feedback.frag");
         Shader sunShader("shaders/sun.vert", "shaders/sun.frag");
         Shader waterShader("shaders/water.vert", "shaders/water.frag");
         Shader grassShader("shaders/grass.vert", "shaders/grass.frag");
+        Shader grassBladesShader("shaders/grass_blades.vert", "shaders/grass_blades.frag");
         Shader vegetationShader("shaders/vegetation.vert", "shaders/vegetation.frag");
-
-        // Modelos e Texturas
-        Model flowerModel("models/anemona.obj", "textures/anemona.jpg");
-        Model flowerModel1("models/flor1.obj", "textures/flor1.jpg");
-        unsigned int dudvTexture = loadTexture("textures/waterDUDV.png");
-        unsigned int normalMapTexture = loadTexture("textures/waterNormalMap.png");
-
-        // Instâncias dos objetos
-        Terrain terrain(512, 512, terrainShader, "textures/mar.png", "textures/grass8.png", "textures/rock1.png");
-        Sun sun(sunShader);
-        Water water(terrain.getWidth(), terrain.getDepth(), waterShader);
-        GrassField grass(terrain, grassShader, "models/Grass1.obj", "textures/Grass/Grass08.png");
-        Vegetation flowers(terrain, vegetationShader, flowerModel, 500, -5.0f, 4.0f, 0.3f, glm::vec3(0.0f, 0.0f, 1.0f));
-        Vegetation flowers1(terrain, vegetationShader, flowerModel1, 500, -5.0f, 4.0f, 0.7f, glm::vec3(0.0f, 0.0f, 1.0f));
-
-        std::vector<std::reference_wrapper<Vegetation>> allVegetation;
-        allVegetation.push_back(flowers);
-        allVegetation.push_back(flowers1);
-
+        Shader impostorShader("shaders/impostor.vert", "shaders/impostor.frag");
+        Shader impostorBakeShader("shaders/impostor_bake.vert", "shaders/impostor_bake.frag");
+        const PassShader terrainPass(terrainShader), sunPass(sunShader), grassPass(grassShader), grassBladesPass(grassBladesShader),
+            vegetationPass(vegetationShader), impostorPass(impostorShader);
+        // Culling das instâncias na GPU, quando há suporte a compute shaders; senão, a grade na CPU.
+        std::unique_ptr<Shader> cullShader;
+        if (InstanceCuller::isSupported())
+            cullShader = std::make_unique<Shader>("shaders/cull_instances.comp");
+        else
+            std::cout << "OpenGL 4.3 indisponivel: culling das instancias na CPU" << std::endl;
+
+        Sun sun(sunShader, geometry);
         WaterFrameBuffers fbos;
 
-        // Define os pontos de controle para a câmera cinemática
-        glm::vec3 startPoint = glm::vec3(0, terrain.getHeight(256, 256) + y_offset, 150);
-        controlPoints.push_back(startPoint);
-        controlPoints.push_back(startPoint);
-        controlPoints.push_back(glm::vec3(100, terrain.getHeight(256 + 100, 256 + 50) + y_offset, 50));
-        controlPoints.push_back(glm::vec3(200, terrain.getHeight(256 + 200, 256 - 100) + 40.0f, -100));
-        controlPoints.push_back(glm::vec3(50, terrain.getHeight(256 + 50, 256 - 200) + y_offset, -200));
-        controlPoints.push_back(glm::vec3(-150, terrain.getHeight(256 - 150, 256 - 150) + y_offset, -150));
-        controlPoints.push_back(glm::vec3(-200, terrain.getHeight(256 - 200, 256 + 50) + 35.0f, 50));
-        controlPoints.push_back(glm::vec3(-100, terrain.getHeight(256 - 100, 256 + 180) + y_offset, 180));
-        glm::vec3 endPoint = glm::vec3(0, terrain.getHeight(256, 256 + 150) + y_offset, 150);
-        controlPoints.push_back(endPoint);
-        controlPoints.push_back(endPoint);
+        // Objetos da cena, criados à medida que o carregamento assíncrono termina.
+        // Enquanto não existem, simplesmente não são desenhados.
+        std::unique_ptr<Terrain> terrain;
+        std::unique_ptr<Water> water;
+        std::unique_ptr<GrassField> grass;
+        std::unique_ptr<ProceduralGrass> grassBlades;
+        std::vector<std::unique_ptr<Vegetation>> allVegetation;
+        std::shared_ptr<Texture> dudvTexture;
+        std::shared_ptr<Texture> normalMapTexture;
+        // Os mapas da água só usam R e G (o shader reconstrói o Z da normal): comprimidos em BC5.
+        const std::vector<std::string> waterMapPaths = {"textures/waterDUDV.png", "textures/waterNormalMap.png"};
+        TextureOptions waterMapOptions;
+        waterMapOptions.compression = worldgen::TextureCompression::RG;
+
+        const std::string grassModelPath = "models/Grass1.obj";
+        // As 17 variantes de textures/Grass entram numa única textura array; cada tufo sorteia a sua.
+        std::vector<std::string> grassTexturePaths;
+        for (int i = 1; i <= 17; ++i)
+            grassTexturePaths.push_back("textures/Grass/Grass" + std::string(i < 10 ? "0" : "") + std::to_string(i) + ".png");
+        const std::vector<VegetationSpec> vegetationSpecs = {
+            {"models/anemona.obj", {"textures/anemona.jpg"}, {500, -5.0f, 4.0f, 0.3f, glm::vec3(0.0f, 0.0f, 1.0f), 1}},
+            {"models/flor1.obj", {"textures/flor1.jpg"}, {500, -5.0f, 4.0f, 0.7f, glm::vec3(0.0f, 0.0f, 1.0f), 2}},
+        };
+
+        // Carregamento assíncrono: leitura de arquivos e geração procedural nas threads do loader,
+        // envios à GPU na thread principal, a cada frame. Declarado depois dos objetos da cena
+        // e do gerenciador de recursos, é destruído antes deles (as tarefas os referenciam).
+        AssetLoader loader;
+
+        // Modelos e imagens são lidos em paralelo desde já; quem precisar deles depois espera pela mesma leitura.
+        std::vector<std::string> meshPaths = {grassModelPath};
+        std::vector<std::string> imagePaths = grassTexturePaths;
+        for (const VegetationSpec &spec : vegetationSpecs)
+        {
+            meshPaths.push_back(spec.modelPath);
+            imagePaths.insert(imagePaths.end(), spec.texturePaths.begin(), spec.texturePaths.end());
+        }
+        for (const std::string &path : meshPaths)
+            loader.submit([&resources, path]()
+                          { resources.prefetchMesh(path); return AssetLoader::Upload(); });
+        for (const std::string &path : imagePaths)
+            loader.submit([&resources, path]()
+                          { resources.prefetchImage(path); return AssetLoader::Upload(); });
+        for (const std::string &path : waterMapPaths)
+            loader.submit([&resources, path]()
+                          { resources.prefetchImage(path, worldgen::TextureCompression::RG); return AssetLoader::Upload(); });
+
+        // Terreno: gerado numa thread; a cena aparece assim que ele chega à GPU.
+        loader.submit([&]()
+                      {
+            auto heightfield = std::make_shared<const worldgen::Heightfield>(worldgen::generateHeightfield(TERRAIN_SIZE, TERRAIN_SIZE));
+            auto mesh = std::make_shared<const worldgen::TerrainMesh>(worldgen::buildTerrainMesh(*heightfield));
+            // As texturas de detalhe da superfície, decodificadas aqui e compostas em páginas sob demanda.
+            auto surface = std::make_shared<const worldgen::TerrainSurface>(
+                heightfield, worldgen::TerrainSurfaceParams{"textures/mar.png", "textures/grass8.png", "textures/rock1.png"});
+            // Os pontos do terreno por faixa de altura, inclinação e bioma, para a distribuição da vegetação.
+            auto placementIndex = std::make_shared<const worldgen::PlacementIndex>(*heightfield);
+
+            // As vegetações são distribuídas juntas, para que umas respeitem o espaço das outras; cada uma
+            // é preparada e enviada à GPU separadamente. A grama é gerada por ladrilhos, em volta da
+            // câmera, a partir do primeiro frame em que existir.
+            loader.submit([&, heightfield, placementIndex]()
+                          {
+                std::vector<worldgen::VegetationParams> layers;
+                for (const VegetationSpec &spec : vegetationSpecs)
+                    layers.push_back(spec.params);
+                std::vector<worldgen::VegetationPlacement> placed = worldgen::placeVegetationLayers(*heightfield, *placementIndex, layers);
+                for (size_t i = 0; i < vegetationSpecs.size(); ++i)
+                {
+                    const VegetationSpec &spec = vegetationSpecs[i];
+                    if (placed[i].transforms.size() < static_cast<size_t>(spec.params.count))
+                        std::cerr << "Vegetacao " << spec.modelPath << ": " << placed[i].transforms.size() << " de " << spec.params.count
+                                  << " instancias (o espaco livre comporta " << placed[i].capacity << ")" << std::endl;
+                    submitVegetation(loader, resources, std::move(placed[i].transforms), spec, vegetationShader, cullShader.get(), geometry,
+                                     impostorBakeShader, impostorShader, allVegetation);
+                }
+                return AssetLoader::Upload(); });
+            loader.submit([&, heightfield]()
+                          {
+                resources.prefetchMesh(grassModelPath);
+                for (const std::string &path : grassTexturePaths)
+                    resources.prefetchImage(path);
+                // O mapa da grama procedural: a altura do terreno e o ruído de cobertura, sem nenhuma instância.
+                worldgen::GrassCoverage coverage;
+                auto grassMap = std::make_shared<std::vector<float>>(worldgen::buildGrassMap(*heightfield, coverage));
+                return AssetLoader::Upload([&, heightfield, grassMap, coverage]()
+                                           {
+                    grass = std::make_unique<GrassField>(grassShader, resources, grassModelPath, grassTexturePaths, heightfield, loader, cullShader.get());
+                    grassBlades = std::make_unique<ProceduralGrass>(grassBladesShader, geometry, heightfield->width, heightfield->depth, *grassMap, coverage); }); });
+
+            return AssetLoader::Upload([&, heightfield, mesh, surface]()
+                                       {
+                terrain = std::make_unique<Terrain>(*heightfield, *mesh, terrainShader, geometry, loader, surface);
+                water = std::make_unique<Water>(terrain->getWidth(), terrain->getDepth(), waterShader, geometry);
+                dudvTexture = resources.getTexture(waterMapPaths[0], waterMapOptions);
+                normalMapTexture = resources.getTexture(waterMapPaths[1], waterMapOptions);
+
+                // Define os pontos de controle para a câmera cinemática
+                glm::vec3 startPoint = glm::vec3(0, terrain->getHeight(256, 256) + y_offset, 150);
+                controlPoints.push_back(startPoint);
+                controlPoints.push_back(startPoint);
+                controlPoints.push_back(glm::vec3(100, terrain->getHeight(256 + 100, 256 + 50) + y_offset, 50));
+                controlPoints.push_back(glm::vec3(200, terrain->getHeight(256 + 200, 256 - 100) + 40.0f, -100));
+                controlPoints.push_back(glm::vec3(50, terrain->getHeight(256 + 50, 256 - 200) + y_offset, -200));
+                controlPoints.push_back(glm::vec3(-150, terrain->getHeight(256 - 150, 256 - 150) + y_offset, -150));
+                controlPoints.push_back(glm::vec3(-200, terrain->getHeight(256 - 200, 256 + 50) + 35.0f, 50));
+                controlPoints.push_back(glm::vec3(-100, terrain->getHeight(256 - 100, 256 + 180) + y_offset, 180));
+                glm::vec3 endPoint = glm::vec3(0, terrain->getHeight(256, 256 + 150) + y_offset, 150);
+                controlPoints.push_back(endPoint);
+                controlPoints.push_back(endPoint); }); });
+
+        // Marcos do carregamento, medidos desde glfwInit().
+        bool firstFrameReported = false;
+        bool loadingCompleteReported = false;
+
+        // O que cada passada desenha. A reflexão vai para um FBO pequeno e dispensa a grama e o detalhe
+        // distante; a refração vê o fundo através da água, que distorce a imagem, e nunca vê o sol.
+        PassSettings passes[3];
+        passes[0].name = "reflexao";
+        passes[0].viewportHeight = WaterFrameBuffers::getReflectionHeight();
+        passes[0][SceneLayer::Terrain].lodBias = 1.0f;
+        passes[0][SceneLayer::Grass].visible = false;
+        passes[0][SceneLayer::Vegetation].lodBias = 1.0f;
+        passes[0][SceneLayer::Vegetation].maxDistance = 80.0f;
+        passes[1].name = "refracao";
+        passes[1].viewportHeight = WaterFrameBuffers::getRefractionHeight();
+        passes[1][SceneLayer::Terrain].lodBias = 1.0f;
+        passes[1][SceneLayer::Sun].visible = false;
+        passes[1][SceneLayer::Grass].lodBias = 1.0f;
+        passes[1][SceneLayer::Grass].maxDistance = 30.0f;
+        passes[1][SceneLayer::Vegetation].lodBias = 1.0f;
+        passes[1][SceneLayer::Vegetation].maxDistance = 60.0f;
+        passes[2].name = "principal";
+        passes[2].viewportHeight = SCR_HEIGHT;
+
+        // Instâncias enviadas e descartadas pelo culling em cada passada, e o tempo de cada uma, entre dois relatórios.
+        worldgen::CullStats passStats[3];
+        PassTimer passTimer(3);
+        int statsFrames = 0;
+        double lastStatsTime = glfwGetTime();
 
         // Loop de Renderização
         while (!glfwWindowShouldClose(window))
@@ -139,6 +324,17 @@ int main()
             deltaTime = currentFrame - lastFrame;
             lastFrame = currentFrame;
 
+            // Envia à GPU o que as threads do loader já prepararam, dentro do orçamento do frame.
+            // Um recurso que falhou é reportado e fica fora da cena, sem interromper o programa.
+            try
+            {
+                loader.processUploads(UPLOAD_BUDGET_MS);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Falha ao carregar recurso: " << e.what() << std::endl;
+            }
+
             // Input
             processInput(window);
 
@@ -166,6 +362,12 @@ int main()
                 }
             }
 
+            // Pede os ladrilhos de grama que faltam em volta da posição atual da câmera.
+            if (grass && !proceduralGrass)
+                grass->update(camera.Position);
+            GrassField *activeGrass = proceduralGrass ? nullptr : grass.get();
+            ProceduralGrass *activeGrassBlades = proceduralGrass ? grassBlades.get() : nullptr;
+
             // Matrizes de Projeção e Visão
             glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 2000.0f);
             glm::mat4 view = camera.GetViewMatrix();
@@ -179,51 +381,101 @@ int main()
             camera.InvertPitch();
             glm::mat4 reflectionView = camera.GetViewMatrix();
 
-            renderScene(glm::vec4(0, 1, 0, -WATER_HEIGHT + 0.1f), reflectionView, projection, terrain, sun, grass, allVegetation, terrainShader, sunShader, grassShader, vegetationShader);
+            passTimer.begin(0);
+            renderScene(passes[0], glm::vec4(0, 1, 0, -WATER_HEIGHT + 0.1f), reflectionView, projection, terrain.get(), sun, activeGrass, activeGrassBlades, allVegetation, terrainPass, sunPass, grassPass, grassBladesPass, vegetationPass, impostorPass, passStats[0]);
+            passTimer.end(0);
 
             camera.Position.y += distance;
             camera.InvertPitch();
 
             // 2. PASSAGEM DE REFRAÇÃO (desenhar para o FBO de refração)
             fbos.bindRefractionFrameBuffer();
-            renderScene(glm::vec4(0, -1, 0, WATER_HEIGHT), view, projection, terrain, sun, grass, allVegetation, terrainShader, sunShader, grassShader, vegetationShader);
+            passTimer.begin(1);
+            renderScene(passes[1], glm::vec4(0, -1, 0, WATER_HEIGHT), view, projection, terrain.get(), sun, activeGrass, activeGrassBlades, allVegetation, terrainPass, sunPass, grassPass, grassBladesPass, vegetationPass, impostorPass, passStats[1]);
+            passTimer.end(1);
 
             // 3. PASSAGEM PRINCIPAL (desenhar para o ecrã)
             fbos.unbindCurrentFrameBuffer(SCR_WIDTH, SCR_HEIGHT);
-            renderScene(glm::vec4(0, 0, 0, 0), view, projection, terrain, sun, grass, allVegetation, terrainShader, sunShader, grassShader, vegetationShader);
+            passTimer.begin(2);
+            renderScene(passes[2], glm::vec4(0, 0, 0, 0), view, projection, terrain.get(), sun, activeGrass, activeGrassBlades, allVegetation, terrainPass, sunPass, grassPass, grassBladesPass, vegetationPass, impostorPass, passStats[2]);
+            passTimer.end(2);
 
             // FINALMENTE, DESENHAR A ÁGUA
-            waterShader.use();
-            waterShader.setMat4("projection", projection);
-            waterShader.setMat4("view", view);
-            waterShader.setVec3("cameraPos", camera.Position);
-            waterShader.setVec3("lightDir", sun.GetLightDirection());
-            waterShader.setVec3("lightColor", sun.GetLightColor());
-            waterShader.setFloat("moveFactor", waterMoveFactor);
-
-            glm::mat4 waterModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0, WATER_HEIGHT, 0));
-            waterShader.setMat4("model", waterModelMatrix);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, fbos.getReflectionTexture());
-            waterShader.setInt("reflectionTexture", 0);
+            if (water)
+            {
+                waterShader.use();
+                waterShader.setMat4("projection", projection);
+                waterShader.setMat4("view", view);
+                waterShader.setVec3("cameraPos", camera.Position);
+                waterShader.setVec3("lightDir", sun.GetLightDirection());
+                waterShader.setVec3("lightColor", sun.GetLightColor());
+                waterShader.setFloat("moveFactor", waterMoveFactor);
+
+                glm::mat4 waterModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0, WATER_HEIGHT, 0));
+                waterShader.setMat4("model", waterModelMatrix);
+
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, fbos.getReflectionTexture());
+                waterShader.setInt("reflectionTexture", 0);
+
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, fbos.getRefractionTexture());
+                waterShader.setInt("refractionTexture", 1);
+
+                glActiveTexture(GL_TEXTURE2);
+                dudvTexture->bind();
+                waterShader.setInt("dudvMap", 2);
+
+                glActiveTexture(GL_TEXTURE3);
+                normalMapTexture->bind();
+                waterShader.setInt("normalMap", 3);
+
+                water->Draw(glm::translate(glm::mat4(1.0f), glm::vec3(0, WATER_HEIGHT, 0)));
+            }
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, fbos.getRefractionTexture());
-            waterShader.setInt("refractionTexture", 1);
+            // Páginas da superfície do terreno que esta vista usa; lidas de volta nos próximos frames.
+            if (terrain)
+                terrain->DrawFeedback(view, projection, terrainFeedbackShader, SCR_WIDTH, SCR_HEIGHT);
 
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, dudvTexture);
-            waterShader.setInt("dudvMap", 2);
+            glfwSwapBuffers(window);
+            glfwPollEvents();
 
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, normalMapTexture);
-            waterShader.setInt("normalMap", 3);
+            // Médias por frame do culling e do tempo de cada passada, a cada CULL_STATS_INTERVAL segundos.
+            ++statsFrames;
+            if (glfwGetTime() - lastStatsTime >= CULL_STATS_INTERVAL)
+            {
+                for (int pass = 0; pass < 3; ++pass)
+                {
+                    std::cout << "Culling (" << passes[pass].name << "): " << passStats[pass].submitted / statsFrames << " instancias enviadas, "
+                              << passStats[pass].culled / statsFrames << " descartadas, "
+                              << passStats[pass].gpuTested / statsFrames << " testadas na GPU, " << passStats[pass].draws / statsFrames << " desenhos por frame" << std::endl;
+                    passStats[pass] = worldgen::CullStats();
+                    std::cout << "Tempo (" << passes[pass].name << "): " << passTimer.gpuMilliseconds(pass) << " ms na GPU, "
+                              << passTimer.cpuMilliseconds(pass) << " ms na CPU por frame" << std::endl;
+                }
+                std::cout << "Uniformes: " << Shader::uniformCallCount() / statsFrames << " chamadas glUniform por frame, "
+                          << Shader::skippedUniformCount() / statsFrames << " evitadas (valor repetido)" << std::endl;
+                Shader::resetUniformCounters();
+                passTimer.reset();
+                statsFrames = 0;
+                lastStatsTime = glfwGetTime();
+            }
 
-            water.Draw(glm::translate(glm::mat4(1.0f), glm::vec3(0, WATER_HEIGHT, 0)));
+            if (terrain && !firstFrameReported)
+            {
+                std::cout << "Primeiro frame com o terreno: " << glfwGetTime() * 1000.0 << " ms" << std::endl;
+                firstFrameReported = true;
+            }
+            if (loader.isIdle() && !loadingCompleteReported)
+            {
+                std::cout << "Cena completa: " << glfwGetTime() * 1000.0 << " ms" << std::endl;
+                loadingCompleteReported = true;
 
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+                // Toda a cena já está na GPU: os dados decodificados na CPU não são mais necessários.
+                resources.releaseCpuData();
+                resources.printStats();
+                geometry.printStats();
+            }
         }
     }
 
@@ -232,57 +484,90 @@ int main()
 }
 
 // Função auxiliar para desenhar a cena inteira
-void renderScene(const glm::vec4 &clipPlane, const glm::mat4 &view, const glm::mat4 &projection,
-                 Terrain &terrain, Sun &sun, GrassField &grass, std::vector<std::reference_wrapper<Vegetation>> &vegetation,
-                 Shader &terrainShader, Shader &sunShader, Shader &grassShader, Shader &vegetationShader)
+// Objetos ainda não carregados (nulos) e camadas omitidas por 'pass' são ignorados.
+void renderScene(const PassSettings &pass, const glm::vec4 &clipPlane, const glm::mat4 &view, const glm::mat4 &projection,
+                 Terrain *terrain, Sun &sun, GrassField *grass, ProceduralGrass *grassBlades, std::vector<std::unique_ptr<Vegetation>> &vegetation,
+                 const PassShader &terrainShader, const PassShader &sunShader, const PassShader &grassShader,
+                 const PassShader &grassBladesShader, const PassShader &vegetationShader, const PassShader &impostorShader,
+                 worldgen::CullStats &stats)
 {
     glm::vec3 skyColor = sun.GetSkyColor();
     glm::vec3 lightDir = sun.GetLightDirection();
     glm::vec3 lightColor = sun.GetLightColor();
+    const LayerSettings &terrainLayer = pass[SceneLayer::Terrain];
+    const LayerSettings &grassLayer = pass[SceneLayer::Grass];
+    const LayerSettings &vegetationLayer = pass[SceneLayer::Vegetation];
 
     glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // 1. Terreno
-    terrainShader.use();
-    terrainShader.setMat4("view", view);
-    terrainShader.setMat4("projection", projection);
-    terrainShader.setVec3("viewPos", camera.Position);
-    terrainShader.setVec3("lightDir", lightDir);
-    terrainShader.setVec3("lightColor", lightColor);
-    terrainShader.setFloat("terrainAmplitude", 50.0f);
-    terrainShader.setVec4("plane", clipPlane);
-    terrain.Draw(view, projection);
+    if (terrain && terrainLayer.visible)
+    {
+        // view e projection são enviadas pelo próprio Draw de cada objeto; aqui ficam os uniformes da passada.
+        terrainShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+        terrain->Draw(view, projection, terrainLayer.lodBias);
+    }
 
     // 2. Sol
-    sunShader.use();
-    sunShader.setVec4("plane", clipPlane);
-    sun.Draw(view, projection);
+    if (pass[SceneLayer::Sun].visible)
+    {
+        sunShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+        sun.Draw(view, projection);
+    }
 
     // 3. Grama
-    grassShader.use();
-    grassShader.setMat4("view", view);
-    grassShader.setMat4("projection", projection);
-    grassShader.setVec3("viewPos", camera.Position);
-    grassShader.setVec3("lightDir", lightDir);
-    grassShader.setVec3("lightColor", lightColor);
-    grassShader.setVec4("plane", clipPlane);
-    grass.Draw(view, projection);
+    if (grass && grassLayer.visible)
+    {
+        grassShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+        grass->Draw(view, projection, clipPlane, &stats, grassLayer.maxDistance);
+    }
+    if (grassBlades && grassLayer.visible)
+    {
+        grassBladesShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+        grassBlades->Draw(view, projection, camera.Position, &stats, grassLayer.lodBias, grassLayer.maxDistance);
+    }
 
     // 4. Vegetação
-    vegetationShader.use();
-    vegetationShader.setMat4("view", view);
-    vegetationShader.setMat4("projection", projection);
-    vegetationShader.setVec3("viewPos", camera.Position);
-    vegetationShader.setVec3("lightDir", lightDir);
-    vegetationShader.setVec3("lightColor", lightColor);
-    vegetationShader.setVec4("plane", clipPlane);
-    for (Vegetation &veg : vegetation)
+    if (!vegetationLayer.visible)
+        return;
+    vegetationShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+    // O shader do impostor é ativado por cada Vegetation depois da malha; aqui ficam os uniformes da passada.
+    impostorShader.apply(camera.Position, lightDir, lightColor, clipPlane);
+    for (std::unique_ptr<Vegetation> &veg : vegetation)
     {
-        veg.Draw(view, projection);
+        veg->Draw(view, projection, static_cast<float>(pass.viewportHeight), clipPlane, &stats, vegetationLayer.lodBias, vegetationLayer.maxDistance);
     }
 }
 
+/**
+ * @brief Prepara as instâncias da vegetação 'spec' (já distribuídas, ver worldgen::placeVegetationLayers)
+ * numa thread do loader. Cada vegetação entra na cena assim que fica pronta, sem esperar pelas outras.
+ */
+void submitVegetation(AssetLoader &loader, ResourceManager &resources, std::vector<glm::mat4> transforms,
+                      const VegetationSpec &spec, Shader &shader, Shader *cullShader,
+                      GeometryArena &geometry, Shader &impostorBakeShader, Shader &impostorShader,
+                      std::vector<std::unique_ptr<Vegetation>> &vegetation)
+{
+    auto placed = std::make_shared<std::vector<glm::mat4>>(std::move(transforms));
+    loader.submit([&resources, placed, &spec, &shader, cullShader, &geometry, &impostorBakeShader, &impostorShader, &vegetation]()
+                  {
+        const std::vector<glm::mat4> &transforms = *placed;
+        auto instances = std::make_shared<std::vector<worldgen::InstanceData>>(
+            worldgen::assignVariants(transforms, static_cast<uint32_t>(spec.texturePaths.size())));
+        resources.prefetchMesh(spec.modelPath);
+        for (const std::string &path : spec.texturePaths)
+            resources.prefetchImage(path);
+        return AssetLoader::Upload([&resources, &spec, instances, &shader, cullShader, &geometry, &impostorBakeShader, &impostorShader, &vegetation]()
+                                   {
+            std::shared_ptr<Model> model = resources.getModel(spec.modelPath, "", VertexFormat::Packed);
+            std::shared_ptr<TextureArray> textures = resources.getTextureArray(spec.texturePaths);
+            // O atlas do impostor é renderizado aqui, na thread do contexto, a partir do modelo já enviado.
+            auto impostor = std::make_shared<ImpostorAtlas>(*model, *textures, impostorBakeShader, geometry);
+            vegetation.push_back(std::make_unique<Vegetation>(shader, model, textures, std::move(*instances), cullShader,
+                                                              impostor, &impostorShader)); }); });
+}
+
 void processInput(GLFWwindow *window)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -297,6 +582,15 @@ void processInput(GLFWwindow *window)
     }
     c_key_pressed = (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS);
 
+    // Alterna entre os tufos em ladrilhos e as lâminas procedurais com a tecla G
+    static bool g_key_pressed = false;
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS && !g_key_pressed)
+    {
+        proceduralGrass = !proceduralGrass;
+        std::cout << "Grama: " << (proceduralGrass ? "laminas procedurais" : "tufos em ladrilhos") << std::endl;
+    }
+    g_key_pressed = (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS);
+
     // Só processa o input do teclado se não estiver no modo cinemático
     if (!cinematicMode)
     {
@@ -347,41 +641,6 @@ void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
     camera.ProcessMouseScroll(static_cast<float>(yoffset));
 }
 
-unsigned int loadTexture(const char *path)
-{
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
-
-    return textureID;
-}
-
 glm::vec3 catmullRom(float t, const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2, const glm::vec3 &p3)
 {
     float t2 = t * t;
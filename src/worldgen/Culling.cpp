@@ -0,0 +1,240 @@
+#include "worldgen/Culling.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define WORLDGEN_CULLING_SSE 1
+#endif
+
+namespace worldgen
+{
+    void Aabb::expand(const glm::vec3 &point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Aabb::expand(const Aabb &other)
+    {
+        if (other.empty())
+            return;
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    float Aabb::distanceTo(const glm::vec3 &point) const
+    {
+        if (empty())
+            return 0.0f;
+        glm::vec3 outside = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+        return glm::length(outside);
+    }
+
+    Aabb Aabb::transformed(const glm::mat4 &matrix) const
+    {
+        if (empty())
+            return *this;
+
+        // Centro transformado e, para a meia-extensão, a soma dos valores absolutos de cada linha (Arvo).
+        glm::vec3 center = (min + max) * 0.5f;
+        glm::vec3 extent = (max - min) * 0.5f;
+        glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+        glm::vec3 newExtent(0.0f);
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+                newExtent[row] += std::fabs(matrix[column][row]) * extent[column];
+        }
+
+        Aabb result;
+        result.min = newCenter - newExtent;
+        result.max = newCenter + newExtent;
+        return result;
+    }
+
+    Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection, const glm::vec4 &clipPlane)
+    {
+        // Gribb-Hartmann: cada plano é a soma ou a diferença entre a linha W e uma das linhas X, Y e Z.
+        const glm::mat4 &m = viewProjection;
+        glm::vec4 rowX(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 rowY(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 rowZ(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 rowW(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum frustum;
+        frustum.planes[0] = rowW + rowX;
+        frustum.planes[1] = rowW - rowX;
+        frustum.planes[2] = rowW + rowY;
+        frustum.planes[3] = rowW - rowY;
+        frustum.planes[4] = rowW + rowZ;
+        frustum.planes[5] = rowW - rowZ;
+        frustum.planeCount = 6;
+        if (clipPlane != glm::vec4(0.0f))
+            frustum.planes[frustum.planeCount++] = clipPlane;
+        return frustum;
+    }
+
+    bool Frustum::intersects(const Aabb &box) const
+    {
+        if (box.empty())
+            return true;
+        for (int p = 0; p < planeCount; ++p)
+        {
+            // O canto da caixa mais à frente na direção da normal do plano.
+            const glm::vec4 &plane = planes[p];
+            glm::vec3 corner(plane.x >= 0.0f ? box.max.x : box.min.x, plane.y >= 0.0f ? box.max.y : box.min.y, plane.z >= 0.0f ? box.max.z : box.min.z);
+            if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    InstanceGrid::InstanceGrid(std::vector<InstanceData> &instances, const Aabb &modelBounds, float cellSize)
+        : m_instanceCount(static_cast<uint32_t>(instances.size())), m_unbounded(modelBounds.empty())
+    {
+        if (instances.empty())
+            return;
+
+        // 1. Grade que cobre as posições de todas as instâncias.
+        float originX = instances[0].position.x, originZ = instances[0].position.z;
+        float endX = originX, endZ = originZ;
+        for (const InstanceData &instance : instances)
+        {
+            originX = std::min(originX, instance.position.x);
+            originZ = std::min(originZ, instance.position.z);
+            endX = std::max(endX, instance.position.x);
+            endZ = std::max(endZ, instance.position.z);
+        }
+        uint32_t columns = static_cast<uint32_t>((endX - originX) / cellSize) + 1;
+        uint32_t rows = static_cast<uint32_t>((endZ - originZ) / cellSize) + 1;
+
+        // 2. Ordenação por contagem, estável, pela célula (em ordem de linha).
+        std::vector<uint32_t> instanceCell(instances.size());
+        std::vector<uint32_t> counts(static_cast<size_t>(columns) * rows, 0);
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            uint32_t column = std::min(static_cast<uint32_t>((instances[i].position.x - originX) / cellSize), columns - 1);
+            uint32_t row = std::min(static_cast<uint32_t>((instances[i].position.z - originZ) / cellSize), rows - 1);
+            instanceCell[i] = row * columns + column;
+            ++counts[instanceCell[i]];
+        }
+
+        std::vector<uint32_t> next(counts.size());
+        std::vector<uint32_t> compactIndex(counts.size());
+        uint32_t first = 0;
+        for (size_t cell = 0; cell < counts.size(); ++cell)
+        {
+            next[cell] = first;
+            if (counts[cell] > 0)
+            {
+                compactIndex[cell] = static_cast<uint32_t>(m_cellFirst.size());
+                m_cellFirst.push_back(first);
+                m_cellCount.push_back(counts[cell]);
+            }
+            first += counts[cell];
+        }
+
+        std::vector<InstanceData> sorted(instances.size());
+        std::vector<Aabb> cellBounds(m_cellFirst.size());
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            sorted[next[instanceCell[i]]++] = instances[i];
+            cellBounds[compactIndex[instanceCell[i]]].expand(modelBounds.transformed(instances[i].matrix()));
+        }
+        instances.swap(sorted);
+
+        // 3. Caixas em SoA, preenchidas até um múltiplo de 4 para o teste em lote.
+        size_t padded = (cellBounds.size() + 3) / 4 * 4;
+        for (std::vector<float> *array : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+            array->assign(padded, 0.0f);
+        for (size_t cell = 0; cell < cellBounds.size(); ++cell)
+        {
+            m_minX[cell] = cellBounds[cell].min.x;
+            m_minY[cell] = cellBounds[cell].min.y;
+            m_minZ[cell] = cellBounds[cell].min.z;
+            m_maxX[cell] = cellBounds[cell].max.x;
+            m_maxY[cell] = cellBounds[cell].max.y;
+            m_maxZ[cell] = cellBounds[cell].max.z;
+        }
+    }
+
+    void InstanceGrid::cull(const Frustum &frustum, std::vector<InstanceRange> &visible, CullStats *stats) const
+    {
+        visible.clear();
+        if (m_instanceCount == 0)
+            return;
+        if (m_unbounded)
+        {
+            visible.push_back({0, m_instanceCount});
+            if (stats)
+                stats->submitted += m_instanceCount;
+            return;
+        }
+
+        // Para cada plano, o vértice da caixa mais à frente da normal (vértice "p") decide: se ele
+        // estiver atrás do plano, a caixa inteira está fora. A escolha entre min e max depende só do
+        // sinal da normal, então é a mesma para todas as células do lote.
+        const float *px[7], *py[7], *pz[7];
+        for (int p = 0; p < frustum.planeCount; ++p)
+        {
+            const glm::vec4 &plane = frustum.planes[p];
+            px[p] = plane.x >= 0.0f ? m_maxX.data() : m_minX.data();
+            py[p] = plane.y >= 0.0f ? m_maxY.data() : m_minY.data();
+            pz[p] = plane.z >= 0.0f ? m_maxZ.data() : m_minZ.data();
+        }
+
+        uint32_t visibleInstances = 0;
+        size_t cellCount = m_cellFirst.size();
+        for (size_t base = 0; base < cellCount; base += 4)
+        {
+            int outsideMask = 0;
+#ifdef WORLDGEN_CULLING_SSE
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < frustum.planeCount; ++p)
+            {
+                const glm::vec4 &plane = frustum.planes[p];
+                __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(px[p] + base), _mm_set1_ps(plane.x)),
+                                             _mm_mul_ps(_mm_loadu_ps(py[p] + base), _mm_set1_ps(plane.y)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(pz[p] + base), _mm_set1_ps(plane.z)));
+                distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+            }
+            outsideMask = _mm_movemask_ps(outside);
+#else
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                for (int p = 0; p < frustum.planeCount; ++p)
+                {
+                    const glm::vec4 &plane = frustum.planes[p];
+                    size_t i = base + lane;
+                    if (px[p][i] * plane.x + py[p][i] * plane.y + pz[p][i] * plane.z + plane.w < 0.0f)
+                    {
+                        outsideMask |= 1 << lane;
+                        break;
+                    }
+                }
+            }
+#endif
+
+            // As células visíveis consecutivas são contíguas nas instâncias: viram um único intervalo.
+            for (size_t lane = 0; lane < 4 && base + lane < cellCount; ++lane)
+            {
+                if (outsideMask & (1 << lane))
+                    continue;
+                size_t cell = base + lane;
+                if (!visible.empty() && visible.back().first + visible.back().count == m_cellFirst[cell])
+                    visible.back().count += m_cellCount[cell];
+                else
+                    visible.push_back({m_cellFirst[cell], m_cellCount[cell]});
+                visibleInstances += m_cellCount[cell];
+            }
+        }
+
+        if (stats)
+        {
+            stats->submitted += visibleInstances;
+            stats->culled += m_instanceCount - visibleInstances;
+        }
+    }
+}
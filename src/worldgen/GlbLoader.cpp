@@ -0,0 +1,300 @@
+#include "worldgen/GlbLoader.hpp"
+#include "worldgen/Json.hpp"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace worldgen
+{
+    namespace
+    {
+        const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+        const uint32_t GLB_VERSION = 2;
+        const uint32_t CHUNK_JSON = 0x4E4F534A;     // "JSON"
+        const uint32_t CHUNK_BIN = 0x004E4942;      // "BIN\0"
+        const int MODE_TRIANGLES = 4;
+
+        // componentType do glTF (iguais aos enums do OpenGL).
+        const uint32_t TYPE_BYTE = 5120;
+        const uint32_t TYPE_UNSIGNED_BYTE = 5121;
+        const uint32_t TYPE_SHORT = 5122;
+        const uint32_t TYPE_UNSIGNED_SHORT = 5123;
+        const uint32_t TYPE_UNSIGNED_INT = 5125;
+        const uint32_t TYPE_FLOAT = 5126;
+
+        uint32_t readU32(const unsigned char *p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value; // O formato é little-endian, como as plataformas suportadas.
+        }
+
+        uint32_t componentSize(uint32_t componentType)
+        {
+            switch (componentType)
+            {
+            case TYPE_BYTE:
+            case TYPE_UNSIGNED_BYTE:
+                return 1;
+            case TYPE_SHORT:
+            case TYPE_UNSIGNED_SHORT:
+                return 2;
+            case TYPE_UNSIGNED_INT:
+            case TYPE_FLOAT:
+                return 4;
+            default:
+                return 0;
+            }
+        }
+
+        uint32_t componentCount(const std::string &type)
+        {
+            if (type == "SCALAR")
+                return 1;
+            if (type == "VEC2")
+                return 2;
+            if (type == "VEC3")
+                return 3;
+            if (type == "VEC4")
+                return 4;
+            return 0; // Matrizes não são usadas como atributos de vértice aqui.
+        }
+
+        [[noreturn]] void fail(const std::string &path, const std::string &message)
+        {
+            throw std::runtime_error("Erro ao carregar " + path + ": " + message);
+        }
+
+        /**
+         * @brief Lê o accessor 'index' e confere se ele cabe no seu bufferView.
+         */
+        GlbAccessor readAccessor(const std::string &path, const JsonValue &json, const std::vector<GlbBufferView> &views, int index)
+        {
+            const JsonValue &node = json["accessors"][static_cast<size_t>(index)];
+            if (!node.isObject())
+                fail(path, "accessor " + std::to_string(index) + " inexistente");
+            if (node.has("sparse"))
+                fail(path, "accessors esparsos nao sao suportados");
+            if (!node.has("bufferView"))
+                fail(path, "accessor sem bufferView nao e suportado");
+
+            GlbAccessor accessor;
+            accessor.bufferView = static_cast<int>(node["bufferView"].asNumber(-1));
+            accessor.byteOffset = static_cast<uint32_t>(node["byteOffset"].asNumber(0));
+            accessor.componentType = static_cast<uint32_t>(node["componentType"].asNumber(0));
+            accessor.componentCount = componentCount(node["type"].asString());
+            accessor.normalized = node["normalized"].asBool(false);
+            accessor.count = static_cast<uint32_t>(node["count"].asNumber(0));
+
+            if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= views.size())
+                fail(path, "bufferView invalido no accessor " + std::to_string(index));
+            if (componentSize(accessor.componentType) == 0 || accessor.componentCount == 0 || accessor.count == 0)
+                fail(path, "formato invalido no accessor " + std::to_string(index));
+
+            const GlbBufferView &view = views[accessor.bufferView];
+            uint64_t stride = view.byteStride != 0 ? view.byteStride : accessor.elementSize();
+            uint64_t end = accessor.byteOffset + stride * (accessor.count - 1) + accessor.elementSize();
+            if (end > view.byteLength)
+                fail(path, "accessor " + std::to_string(index) + " ultrapassa o seu bufferView");
+            return accessor;
+        }
+
+        /**
+         * @brief Escala e translação do primeiro nó que usa a malha 0.
+         * Nós pais e rotações não são considerados: modelos exportados para a cena ficam na origem,
+         * e a transformação do nó serve, na prática, para desfazer a quantização das posições.
+         */
+        void readNodeTransform(const std::string &path, const JsonValue &json, GlbMesh &mesh)
+        {
+            const JsonValue &nodes = json["nodes"];
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const JsonValue &node = nodes[i];
+                if (node["mesh"].asNumber(-1) != 0)
+                    continue;
+
+                if (node.has("matrix"))
+                {
+                    const JsonValue &m = node["matrix"];
+                    // Coluna principal: os termos fora da diagonal da parte 3x3 devem ser nulos.
+                    const int offDiagonal[] = {1, 2, 4, 6, 8, 9};
+                    for (int k : offDiagonal)
+                    {
+                        if (std::fabs(m[k].asNumber()) > 1e-6)
+                            std::cerr << "Aviso: " << path << ": rotacao do no ignorada" << std::endl;
+                    }
+                    mesh.positionScale = glm::vec3(m[0].asNumber(1), m[5].asNumber(1), m[10].asNumber(1));
+                    mesh.positionOffset = glm::vec3(m[12].asNumber(), m[13].asNumber(), m[14].asNumber());
+                    return;
+                }
+
+                const JsonValue &rotation = node["rotation"];
+                if (rotation.isArray() && std::fabs(rotation[3].asNumber(1) - 1.0) > 1e-6)
+                    std::cerr << "Aviso: " << path << ": rotacao do no ignorada" << std::endl;
+
+                const JsonValue &scale = node["scale"];
+                if (scale.isArray())
+                    mesh.positionScale = glm::vec3(scale[0].asNumber(1), scale[1].asNumber(1), scale[2].asNumber(1));
+                const JsonValue &translation = node["translation"];
+                if (translation.isArray())
+                    mesh.positionOffset = glm::vec3(translation[0].asNumber(), translation[1].asNumber(), translation[2].asNumber());
+                return;
+            }
+        }
+
+        /**
+         * @brief Caixa das posições a partir do min/max do accessor (obrigatórios em POSITION no glTF),
+         * desfazendo a normalização do tipo e aplicando a transformação do nó.
+         */
+        void readPositionBounds(const std::string &path, const JsonValue &accessor, GlbMesh &mesh)
+        {
+            const JsonValue &min = accessor["min"];
+            const JsonValue &max = accessor["max"];
+            if (min.size() != 3 || max.size() != 3)
+            {
+                std::cerr << "Aviso: " << path << ": POSITION sem min/max; as instancias nao serao descartadas" << std::endl;
+                return;
+            }
+
+            float normalization = 1.0f;
+            if (mesh.position.normalized)
+            {
+                switch (mesh.position.componentType)
+                {
+                case TYPE_BYTE:
+                    normalization = 1.0f / 127.0f;
+                    break;
+                case TYPE_UNSIGNED_BYTE:
+                    normalization = 1.0f / 255.0f;
+                    break;
+                case TYPE_SHORT:
+                    normalization = 1.0f / 32767.0f;
+                    break;
+                case TYPE_UNSIGNED_SHORT:
+                    normalization = 1.0f / 65535.0f;
+                    break;
+                }
+            }
+            for (const JsonValue *corner : {&min, &max})
+            {
+                glm::vec3 value((*corner)[0].asNumber(), (*corner)[1].asNumber(), (*corner)[2].asNumber());
+                mesh.bounds.expand(value * normalization * mesh.positionScale + mesh.positionOffset);
+            }
+        }
+    }
+
+    uint32_t GlbAccessor::elementSize() const
+    {
+        return componentSize(componentType) * componentCount;
+    }
+
+    const unsigned char *GlbMesh::data(const GlbAccessor &accessor) const
+    {
+        return binary + bufferViews[accessor.bufferView].byteOffset + accessor.byteOffset;
+    }
+
+    GlbMesh loadGlb(const std::string &path)
+    {
+        GlbMesh mesh;
+        mesh.file = MappedFile(path);
+        if (!mesh.file.isOpen())
+            fail(path, "arquivo nao encontrado");
+
+        // Cabeçalho (12 bytes) e primeiro chunk, que deve ser o JSON.
+        const unsigned char *data = mesh.file.data();
+        size_t size = mesh.file.size();
+        if (size < 20 || readU32(data) != GLB_MAGIC || readU32(data + 4) != GLB_VERSION || readU32(data + 8) > size)
+            fail(path, "cabecalho glTF binario invalido");
+        size = readU32(data + 8);
+
+        uint32_t jsonLength = readU32(data + 12);
+        if (readU32(data + 16) != CHUNK_JSON || 20 + static_cast<uint64_t>(jsonLength) > size)
+            fail(path, "chunk JSON invalido");
+        const char *jsonText = reinterpret_cast<const char *>(data + 20);
+        JsonValue json = parseJson(jsonText, jsonText + jsonLength);
+
+        // Chunk binário opcional, logo em seguida.
+        size_t binOffset = 20 + jsonLength;
+        if (binOffset + 8 <= size && readU32(data + binOffset + 4) == CHUNK_BIN)
+        {
+            uint32_t binLength = readU32(data + binOffset);
+            if (binOffset + 8 + static_cast<uint64_t>(binLength) > size)
+                fail(path, "chunk BIN invalido");
+            mesh.binary = data + binOffset + 8;
+            mesh.binarySize = binLength;
+        }
+
+        const JsonValue &required = json["extensionsRequired"];
+        for (size_t i = 0; i < required.size(); ++i)
+        {
+            if (required[i].asString() != "KHR_mesh_quantization")
+                fail(path, "extensao obrigatoria nao suportada: " + required[i].asString());
+        }
+
+        // Apenas o buffer 0, armazenado no próprio .glb, é suportado.
+        const JsonValue &buffers = json["buffers"];
+        if (buffers.size() != 1 || buffers[0].has("uri") || !mesh.binary)
+            fail(path, "apenas o buffer interno do .glb e suportado");
+
+        const JsonValue &views = json["bufferViews"];
+        for (size_t i = 0; i < views.size(); ++i)
+        {
+            GlbBufferView view;
+            view.byteOffset = static_cast<uint32_t>(views[i]["byteOffset"].asNumber(0));
+            view.byteLength = static_cast<uint32_t>(views[i]["byteLength"].asNumber(0));
+            view.byteStride = static_cast<uint32_t>(views[i]["byteStride"].asNumber(0));
+            if (views[i]["buffer"].asNumber(-1) != 0 || static_cast<uint64_t>(view.byteOffset) + view.byteLength > mesh.binarySize)
+                fail(path, "bufferView " + std::to_string(i) + " invalido");
+            mesh.bufferViews.push_back(view);
+        }
+
+        const JsonValue &meshes = json["meshes"];
+        const JsonValue &primitives = meshes[0]["primitives"];
+        if (primitives.size() == 0)
+            fail(path, "nenhuma malha encontrada");
+        if (meshes.size() > 1 || primitives.size() > 1)
+            std::cerr << "Aviso: " << path << ": apenas a primeira primitiva da primeira malha e usada" << std::endl;
+
+        const JsonValue &primitive = primitives[0];
+        if (primitive["mode"].asNumber(MODE_TRIANGLES) != MODE_TRIANGLES)
+            fail(path, "apenas primitivas de triangulos sao suportadas");
+        if (!primitive.has("indices"))
+            fail(path, "primitivas sem indices nao sao suportadas");
+
+        const JsonValue &attributes = primitive["attributes"];
+        if (!attributes.has("POSITION"))
+            fail(path, "primitiva sem POSITION");
+        mesh.position = readAccessor(path, json, mesh.bufferViews, static_cast<int>(attributes["POSITION"].asNumber()));
+        if (attributes.has("NORMAL"))
+            mesh.normal = readAccessor(path, json, mesh.bufferViews, static_cast<int>(attributes["NORMAL"].asNumber()));
+        if (attributes.has("TEXCOORD_0"))
+            mesh.texCoord = readAccessor(path, json, mesh.bufferViews, static_cast<int>(attributes["TEXCOORD_0"].asNumber()));
+        mesh.indices = readAccessor(path, json, mesh.bufferViews, static_cast<int>(primitive["indices"].asNumber()));
+
+        // Formatos aceitos: os da especificação mais os da extensão KHR_mesh_quantization.
+        uint32_t vertexCount = mesh.position.count;
+        if (mesh.position.componentCount != 3 || mesh.position.componentType == TYPE_UNSIGNED_INT)
+            fail(path, "formato de POSITION nao suportado");
+        if (mesh.normal.present() && (mesh.normal.componentCount != 3 || mesh.normal.count != vertexCount ||
+                                      (mesh.normal.componentType != TYPE_FLOAT && !mesh.normal.normalized)))
+            fail(path, "formato de NORMAL nao suportado");
+        if (mesh.texCoord.present() && (mesh.texCoord.componentCount != 2 || mesh.texCoord.count != vertexCount ||
+                                        mesh.texCoord.componentType == TYPE_UNSIGNED_INT))
+            fail(path, "formato de TEXCOORD_0 nao suportado");
+        if (mesh.indices.componentCount != 1 || mesh.indices.count % 3 != 0 ||
+            (mesh.indices.componentType != TYPE_UNSIGNED_BYTE && mesh.indices.componentType != TYPE_UNSIGNED_SHORT &&
+             mesh.indices.componentType != TYPE_UNSIGNED_INT) ||
+            mesh.bufferViews[mesh.indices.bufferView].byteStride != 0)
+            fail(path, "formato dos indices nao suportado");
+
+        // Os índices não são percorridos; se o arquivo informar o máximo, ele é conferido.
+        const JsonValue &indexMax = json["accessors"][static_cast<size_t>(primitive["indices"].asNumber())]["max"];
+        if (indexMax.isArray() && indexMax[0].asNumber() >= vertexCount)
+            fail(path, "indices fora do intervalo de vertices");
+
+        readNodeTransform(path, json, mesh);
+        readPositionBounds(path, json["accessors"][static_cast<size_t>(attributes["POSITION"].asNumber())], mesh);
+        return mesh;
+    }
+}
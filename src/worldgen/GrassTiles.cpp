@@ -0,0 +1,127 @@
+#include "worldgen/GrassTiles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace worldgen
+{
+    float GrassCoverage::noise(float worldX, float worldZ) const
+    {
+        return perlinNoise(worldX * noiseFrequency, worldZ * noiseFrequency);
+    }
+
+    bool GrassCoverage::inHeightBand(float height) const
+    {
+        float heightNormalized = (height / terrainAmplitude + 1.0f) / 2.0f;
+        return heightNormalized >= minHeight && heightNormalized < maxHeight;
+    }
+
+    int GrassStreamingParams::densityLevel(int ring) const
+    {
+        if (ring < fullDensityRings)
+            return 0;
+        return 1 + (ring - fullDensityRings) / std::max(falloffRings, 1);
+    }
+
+    std::vector<GrassTileKey> desiredGrassTiles(const Heightfield &hf, const glm::vec3 &cameraPos, const GrassStreamingParams &params)
+    {
+        int cameraX = static_cast<int>(std::floor(cameraPos.x / params.tileSize));
+        int cameraZ = static_cast<int>(std::floor(cameraPos.z / params.tileSize));
+        float halfWidth = hf.width / 2.0f;
+        float halfDepth = hf.depth / 2.0f;
+
+        std::vector<std::pair<float, GrassTileKey>> tiles;
+        for (int dz = -params.radius; dz <= params.radius; ++dz)
+        {
+            for (int dx = -params.radius; dx <= params.radius; ++dx)
+            {
+                GrassTileKey key;
+                key.x = cameraX + dx;
+                key.z = cameraZ + dz;
+                float minX = key.x * params.tileSize, minZ = key.z * params.tileSize;
+                if (minX + params.tileSize <= -halfWidth || minX >= halfWidth || minZ + params.tileSize <= -halfDepth || minZ >= halfDepth)
+                    continue;
+
+                key.level = params.densityLevel(std::max(std::abs(dx), std::abs(dz)));
+                glm::vec2 toCenter = glm::vec2(minX, minZ) + 0.5f * params.tileSize - glm::vec2(cameraPos.x, cameraPos.z);
+                tiles.push_back({glm::dot(toCenter, toCenter), key});
+            }
+        }
+        std::stable_sort(tiles.begin(), tiles.end(), [](const std::pair<float, GrassTileKey> &a, const std::pair<float, GrassTileKey> &b)
+                         { return a.first < b.first; });
+
+        std::vector<GrassTileKey> keys;
+        keys.reserve(tiles.size());
+        for (const std::pair<float, GrassTileKey> &tile : tiles)
+            keys.push_back(tile.second);
+        return keys;
+    }
+
+    GrassTile placeGrassTile(const Heightfield &hf, const GrassTileKey &key, const GrassStreamingParams &params,
+                             const Aabb &modelBounds, uint32_t layerCount)
+    {
+        const float heightNoiseFrequency = 10.0f;
+        // Fração das posições possíveis que sobrevivem no nível de densidade do ladrilho.
+        const float keepFraction = std::ldexp(1.0f, -key.level);
+
+        int side = params.candidatesPerSide();
+        std::vector<glm::mat4> transforms;
+        for (int j = 0; j < side; ++j)
+        {
+            for (int i = 0; i < side; ++i)
+            {
+                // Um número para cada deslocamento, um para a densidade e um para a largura.
+                RandomBlock random = counterRandom(params.seed, params.stream, key.x, key.z, static_cast<uint32_t>(j * side + i));
+                if (random.uniform(2) >= keepFraction)
+                    continue;
+
+                float worldX = (key.x * side + i + random.uniform(0)) * params.spacing;
+                float worldZ = (key.z * side + j + random.uniform(1)) * params.spacing;
+                float gridX = worldX + hf.width / 2.0f;
+                float gridZ = worldZ + hf.depth / 2.0f;
+                if (gridX < 0.0f || gridZ < 0.0f || gridX > hf.width - 1 || gridZ > hf.depth - 1)
+                    continue;
+
+                float height = hf.getInterpolatedHeight(gridX, gridZ);
+                if (!params.coverage.inHeightBand(height) || params.coverage.noise(worldX, worldZ) <= params.coverage.noiseThreshold)
+                    continue;
+
+                // Um segundo ruído varia a altura da grama, mapeado de [-1, 1] para [minHeight, maxHeight].
+                float heightNoise = perlinNoise(worldX * heightNoiseFrequency, worldZ * heightNoiseFrequency);
+                float minHeight = 0.000001f;
+                float maxHeight = 0.02f;
+                float height_scale = minHeight + (heightNoise + 1.0f) / 2.0f * (maxHeight - minHeight);
+                float width_scale = 0.009f + random.uniform(3) * 0.0005f;
+
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(worldX, height, worldZ));
+                transforms.push_back(glm::scale(model, glm::vec3(width_scale, height_scale, width_scale)));
+            }
+        }
+
+        GrassTile tile;
+        tile.key = key;
+        tile.instances = assignVariants(transforms, layerCount);
+        // Sem a caixa do modelo, a do ladrilho também fica vazia (desconhecida), e ele nunca é descartado.
+        if (!modelBounds.empty())
+        {
+            for (const glm::mat4 &transform : transforms)
+                tile.bounds.expand(modelBounds.transformed(transform));
+        }
+        return tile;
+    }
+
+    std::vector<float> buildGrassMap(const Heightfield &hf, const GrassCoverage &coverage)
+    {
+        std::vector<float> map(static_cast<size_t>(hf.width) * hf.depth * 2);
+        for (int z = 0; z < hf.depth; ++z)
+        {
+            for (int x = 0; x < hf.width; ++x)
+            {
+                size_t i = (static_cast<size_t>(z) * hf.width + x) * 2;
+                map[i] = hf.getHeight(x, z);
+                map[i + 1] = coverage.noise(x - hf.width / 2.0f, z - hf.depth / 2.0f);
+            }
+        }
+        return map;
+    }
+}
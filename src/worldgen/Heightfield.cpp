@@ -0,0 +1,153 @@
+#include "worldgen/Heightfield.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Define e implementa a biblioteca de ruído de cabeçalho único.
+#define DB_PERLIN_IMPL
+#include "db_perlin.hpp"
+
+namespace worldgen
+{
+    float Heightfield::getHeight(int x, int z) const
+    {
+        x = std::max(0, std::min(width - 1, x));
+        z = std::max(0, std::min(depth - 1, z));
+        return heights[z * width + x];
+    }
+
+    glm::vec3 Heightfield::getNormal(int x, int z) const
+    {
+        x = std::max(0, std::min(width - 1, x));
+        z = std::max(0, std::min(depth - 1, z));
+        return normals[z * width + x];
+    }
+
+    float Heightfield::getInterpolatedHeight(float x, float z) const
+    {
+        int x0 = static_cast<int>(std::floor(x));
+        int z0 = static_cast<int>(std::floor(z));
+        float fx = x - x0;
+        float fz = z - z0;
+        float top = getHeight(x0, z0) * (1.0f - fx) + getHeight(x0 + 1, z0) * fx;
+        float bottom = getHeight(x0, z0 + 1) * (1.0f - fx) + getHeight(x0 + 1, z0 + 1) * fx;
+        return top * (1.0f - fz) + bottom * fz;
+    }
+
+    float perlinNoise(float x, float z)
+    {
+        return db::perlin(x, z);
+    }
+
+    /**
+     * @brief A combinação de várias camadas de ruído cria uma aparência mais natural e detalhada.
+     */
+    float sampleHeight(float x, float z)
+    {
+        float amplitude = 70.0f;   // Altura máxima inicial das "montanhas".
+        float frequency = 0.005f;  // "Zoom" do ruído. Valores menores criam montanhas mais largas.
+        int octaves = 6;           // Número de camadas de detalhe.
+        float lacunarity = 4.0f;   // Aumenta a frequência a cada oitava (mais detalhes).
+        float persistence = 0.15f; // Reduz a amplitude a cada oitava (detalhes menores).
+
+        float total = 0.0f;
+        for (int i = 0; i < octaves; ++i)
+        {
+            total += db::perlin(x * frequency, z * frequency) * amplitude;
+            amplitude *= persistence;
+            frequency *= lacunarity;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Gera as alturas e, a partir delas, as normais da grade.
+     * A normal é calculada com base na diferença de altura dos pontos vizinhos. Dentro da grade
+     * reaproveitamos as alturas já calculadas; só nas bordas o ruído é avaliado fora dela.
+     */
+    Heightfield generateHeightfield(int width, int depth)
+    {
+        Heightfield hf;
+        hf.width = width;
+        hf.depth = depth;
+        hf.heights.resize(width * depth);
+        hf.normals.resize(width * depth);
+
+        for (int z = 0; z < depth; ++z)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                hf.heights[z * width + x] = sampleHeight(x, z);
+            }
+        }
+
+        // Altura de um vizinho: lida do cache se estiver na grade, senão recalculada.
+        auto heightAt = [&](int x, int z)
+        {
+            if (x < 0 || x >= width || z < 0 || z >= depth)
+                return sampleHeight(x, z);
+            return hf.heights[z * width + x];
+        };
+
+        for (int z = 0; z < depth; ++z)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                float heightL = heightAt(x - 1, z); // Esquerda
+                float heightR = heightAt(x + 1, z); // Direita
+                float heightD = heightAt(x, z - 1); // Abaixo
+                float heightU = heightAt(x, z + 1); // Acima
+
+                // O vetor normal é perpendicular ao plano da superfície.
+                hf.normals[z * width + x] = glm::normalize(glm::vec3(heightL - heightR, 2.0f, heightD - heightU));
+            }
+        }
+        return hf;
+    }
+
+    TerrainMesh buildTerrainMesh(const Heightfield &hf)
+    {
+        TerrainMesh mesh;
+        mesh.vertices.reserve(hf.width * hf.depth * 8);
+        mesh.indices.reserve((hf.width - 1) * (hf.depth - 1) * 6);
+
+        // Itera sobre cada ponto da grade para gerar os vértices.
+        for (int z = 0; z < hf.depth; ++z)
+        {
+            for (int x = 0; x < hf.width; ++x)
+            {
+                const glm::vec3 &normal = hf.normals[z * hf.width + x];
+                // Posição
+                mesh.vertices.push_back((float)x);
+                mesh.vertices.push_back(hf.heights[z * hf.width + x]);
+                mesh.vertices.push_back((float)z);
+                // Normal (essencial para a iluminação).
+                mesh.vertices.push_back(normal.x);
+                mesh.vertices.push_back(normal.y);
+                mesh.vertices.push_back(normal.z);
+                // Coordenadas de Textura.
+                mesh.vertices.push_back((float)x / (float)hf.width);
+                mesh.vertices.push_back((float)z / (float)hf.depth);
+            }
+        }
+
+        // Gera os índices para conectar os vértices e formar triângulos.
+        for (int z = 0; z < hf.depth - 1; ++z)
+        {
+            for (int x = 0; x < hf.width - 1; ++x)
+            {
+                int topLeft = (z * hf.width) + x;
+                int topRight = topLeft + 1;
+                int bottomLeft = ((z + 1) * hf.width) + x;
+                int bottomRight = bottomLeft + 1;
+                // Cada quadrado da grade é formado por dois triângulos.
+                mesh.indices.push_back(topLeft);
+                mesh.indices.push_back(bottomLeft);
+                mesh.indices.push_back(topRight);
+                mesh.indices.push_back(topRight);
+                mesh.indices.push_back(bottomLeft);
+                mesh.indices.push_back(bottomRight);
+            }
+        }
+        return mesh;
+    }
+}
@@ -0,0 +1,20 @@
+#include "worldgen/ImageData.hpp"
+
+// Inclui e implementa a biblioteca de cabeçalho único diretamente aqui.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace worldgen
+{
+    void ImageDeleter::operator()(unsigned char *data) const
+    {
+        stbi_image_free(data);
+    }
+
+    ImageData loadImage(const std::string &path)
+    {
+        ImageData image;
+        image.pixels.reset(stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0));
+        return image;
+    }
+}
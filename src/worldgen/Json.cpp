@@ -0,0 +1,302 @@
+#include "worldgen/Json.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace worldgen
+{
+    namespace
+    {
+        const JsonValue NULL_VALUE;
+
+        // Limite de aninhamento, para que um arquivo malformado não estoure a pilha.
+        const int MAX_DEPTH = 128;
+    }
+
+    const JsonValue &JsonValue::operator[](size_t index) const
+    {
+        return m_type == Type::Array && index < m_items.size() ? m_items[index] : NULL_VALUE;
+    }
+
+    const JsonValue &JsonValue::operator[](const std::string &key) const
+    {
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            if (m_keys[i] == key)
+                return m_items[i];
+        }
+        return NULL_VALUE;
+    }
+
+    bool JsonValue::has(const std::string &key) const
+    {
+        return !(*this)[key].isNull();
+    }
+
+    /**
+     * @class JsonParser
+     * @brief Analisador recursivo descendente; preenche os membros privados de JsonValue.
+     */
+    class JsonParser
+    {
+    public:
+        JsonParser(const char *begin, const char *end) : m_begin(begin), m_cursor(begin), m_end(end) {}
+
+        JsonValue parseDocument()
+        {
+            JsonValue value = parseValue(0);
+            skipWhitespace();
+            if (m_cursor != m_end)
+                fail("conteudo apos o fim do documento");
+            return value;
+        }
+
+    private:
+        [[noreturn]] void fail(const char *message) const
+        {
+            throw std::runtime_error(std::string("JSON invalido na posicao ") + std::to_string(m_cursor - m_begin) + ": " + message);
+        }
+
+        void skipWhitespace()
+        {
+            while (m_cursor < m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r'))
+                ++m_cursor;
+        }
+
+        void expect(char c)
+        {
+            skipWhitespace();
+            if (m_cursor >= m_end || *m_cursor != c)
+                fail("caractere inesperado");
+            ++m_cursor;
+        }
+
+        bool consumeLiteral(const char *literal)
+        {
+            size_t length = std::strlen(literal);
+            if (static_cast<size_t>(m_end - m_cursor) < length || std::strncmp(m_cursor, literal, length) != 0)
+                return false;
+            m_cursor += length;
+            return true;
+        }
+
+        JsonValue parseValue(int depth)
+        {
+            if (depth > MAX_DEPTH)
+                fail("aninhamento profundo demais");
+
+            skipWhitespace();
+            if (m_cursor >= m_end)
+                fail("fim inesperado");
+
+            JsonValue value;
+            switch (*m_cursor)
+            {
+            case '{':
+                value.m_type = JsonValue::Type::Object;
+                ++m_cursor;
+                skipWhitespace();
+                if (m_cursor < m_end && *m_cursor == '}')
+                {
+                    ++m_cursor;
+                    break;
+                }
+                for (;;)
+                {
+                    skipWhitespace();
+                    value.m_keys.push_back(parseString());
+                    expect(':');
+                    value.m_items.push_back(parseValue(depth + 1));
+                    skipWhitespace();
+                    if (m_cursor < m_end && *m_cursor == ',')
+                    {
+                        ++m_cursor;
+                        continue;
+                    }
+                    expect('}');
+                    break;
+                }
+                break;
+            case '[':
+                value.m_type = JsonValue::Type::Array;
+                ++m_cursor;
+                skipWhitespace();
+                if (m_cursor < m_end && *m_cursor == ']')
+                {
+                    ++m_cursor;
+                    break;
+                }
+                for (;;)
+                {
+                    value.m_items.push_back(parseValue(depth + 1));
+                    skipWhitespace();
+                    if (m_cursor < m_end && *m_cursor == ',')
+                    {
+                        ++m_cursor;
+                        continue;
+                    }
+                    expect(']');
+                    break;
+                }
+                break;
+            case '"':
+                value.m_type = JsonValue::Type::String;
+                value.m_string = parseString();
+                break;
+            case 't':
+            case 'f':
+                value.m_type = JsonValue::Type::Bool;
+                value.m_bool = *m_cursor == 't';
+                if (!consumeLiteral(value.m_bool ? "true" : "false"))
+                    fail("literal invalido");
+                break;
+            case 'n':
+                if (!consumeLiteral("null"))
+                    fail("literal invalido");
+                break;
+            default:
+                value.m_type = JsonValue::Type::Number;
+                value.m_number = parseNumber();
+                break;
+            }
+            return value;
+        }
+
+        double parseNumber()
+        {
+            // strtod precisa de uma string terminada em zero: copia apenas os caracteres do número.
+            const char *start = m_cursor;
+            while (m_cursor < m_end && (std::strchr("+-0123456789.eE", *m_cursor) != nullptr))
+                ++m_cursor;
+            std::string text(start, m_cursor);
+            if (text.empty())
+                fail("valor invalido");
+
+            char *parsedEnd = nullptr;
+            double number = std::strtod(text.c_str(), &parsedEnd);
+            if (parsedEnd != text.c_str() + text.size())
+                fail("numero invalido");
+            return number;
+        }
+
+        unsigned int parseHex4()
+        {
+            if (m_end - m_cursor < 4)
+                fail("escape \\u incompleto");
+            unsigned int code = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = *m_cursor++;
+                code <<= 4;
+                if (c >= '0' && c <= '9')
+                    code |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    code |= c - 'A' + 10;
+                else
+                    fail("escape \\u invalido");
+            }
+            return code;
+        }
+
+        static void appendUtf8(std::string &out, unsigned int code)
+        {
+            if (code < 0x80)
+            {
+                out += static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        std::string parseString()
+        {
+            if (m_cursor >= m_end || *m_cursor != '"')
+                fail("string esperada");
+            ++m_cursor;
+
+            std::string out;
+            for (;;)
+            {
+                if (m_cursor >= m_end)
+                    fail("string sem fim");
+                char c = *m_cursor++;
+                if (c == '"')
+                    return out;
+                if (c != '\\')
+                {
+                    out += c;
+                    continue;
+                }
+
+                if (m_cursor >= m_end)
+                    fail("escape incompleto");
+                char escaped = *m_cursor++;
+                switch (escaped)
+                {
+                case '"':
+                case '\\':
+                case '/':
+                    out += escaped;
+                    break;
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'n':
+                    out += '\n';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'u':
+                {
+                    unsigned int code = parseHex4();
+                    // Par substituto (surrogate pair) UTF-16 para caracteres fora do plano básico.
+                    if (code >= 0xD800 && code <= 0xDBFF && m_end - m_cursor >= 6 && m_cursor[0] == '\\' && m_cursor[1] == 'u')
+                    {
+                        m_cursor += 2;
+                        unsigned int low = parseHex4();
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail("escape invalido");
+                }
+            }
+        }
+
+        const char *m_begin;
+        const char *m_cursor;
+        const char *m_end;
+    };
+
+    JsonValue parseJson(const char *begin, const char *end)
+    {
+        return JsonParser(begin, end).parseDocument();
+    }
+}
@@ -0,0 +1,86 @@
+#include "worldgen/MappedFile.hpp"
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace worldgen
+{
+    MappedFile::MappedFile(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                m_data = static_cast<const unsigned char *>(ptr);
+                m_size = st.st_size;
+            }
+        }
+        // O mapeamento continua válido depois de fechar o descritor.
+        ::close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : m_data(other.m_data), m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+            munmap(const_cast<unsigned char *>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    FileStamp statFile(const std::string &path)
+    {
+        FileStamp stamp;
+        struct stat st;
+        if (::stat(path.c_str(), &st) == 0)
+        {
+            stamp.exists = true;
+            stamp.size = st.st_size;
+            stamp.mtimeNs = uint64_t(st.st_mtim.tv_sec) * 1000000000ull + st.st_mtim.tv_nsec;
+        }
+        return stamp;
+    }
+
+    bool overwriteFileBytes(const std::string &path, uint64_t offset, const void *data, size_t size)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+            return false;
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        file.flush();
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,177 @@
+#include "worldgen/MeshCache.hpp"
+#include "worldgen/Hash.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace worldgen
+{
+    namespace
+    {
+        const char MESH_CACHE_MAGIC[4] = {'W', 'G', 'M', 'C'};
+        const uint32_t MESH_CACHE_VERSION = 4; // 4: erro dos LODs medido em unidades do modelo.
+
+        // Cabeçalho do arquivo de cache. Logo depois vêm a tabela de LODs, os vértices e, em seguida,
+        // os índices de todos os LODs.
+        struct MeshCacheHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t vertexStride;
+            uint32_t lodCount;
+            uint64_t sourceSize;    // Tamanho do .obj de origem.
+            uint64_t sourceMtimeNs; // Data de modificação do .obj de origem.
+            uint64_t sourceHash;    // Hash do conteúdo do .obj de origem.
+            uint64_t vertexCount;
+            uint64_t indexCount;
+            uint64_t payloadHash;   // Hash dos LODs, vértices e índices, para detectar arquivos corrompidos.
+            MeshOptimizationReport report; // ACMR/ATVR medidos quando a malha foi otimizada.
+        };
+        static_assert(sizeof(MeshCacheHeader) == 80, "O cabeçalho do cache deve ter 80 bytes");
+        static_assert(sizeof(Vertex) == 32, "O cache assume uma struct Vertex compacta de 32 bytes");
+        static_assert(sizeof(MeshLod) == 16, "O cache assume uma struct MeshLod compacta de 16 bytes");
+
+        uint64_t hashFile(const std::string &path)
+        {
+            MappedFile file(path);
+            return file.isOpen() ? hashBytes(file.data(), file.size()) : 0;
+        }
+
+        // Verifica o cabeçalho e os tamanhos; devolve o cabeçalho através de 'out'.
+        bool validateCache(const MappedFile &cache, const std::string &objPath, const FileStamp &source, MeshCacheHeader &out)
+        {
+            if (!cache.isOpen() || cache.size() < sizeof(MeshCacheHeader))
+                return false;
+
+            std::memcpy(&out, cache.data(), sizeof(MeshCacheHeader));
+            if (std::memcmp(out.magic, MESH_CACHE_MAGIC, 4) != 0 || out.version != MESH_CACHE_VERSION ||
+                out.vertexStride != sizeof(Vertex) || out.sourceSize != source.size)
+                return false;
+
+            size_t payloadSize = out.lodCount * sizeof(MeshLod) + out.vertexCount * sizeof(Vertex) + out.indexCount * sizeof(unsigned int);
+            if (cache.size() != sizeof(MeshCacheHeader) + payloadSize)
+                return false;
+
+            // Data de modificação diferente (ex: após um 'git checkout') não invalida o cache
+            // se o conteúdo for idêntico.
+            if (out.sourceMtimeNs != source.mtimeNs && out.sourceHash != hashFile(objPath))
+                return false;
+
+            if (hashBytes(cache.data() + sizeof(MeshCacheHeader), payloadSize) != out.payloadHash)
+                return false;
+
+            // Todo cache tem ao menos o LOD 0, e nenhum LOD pode apontar para fora dos índices.
+            if (out.lodCount == 0)
+                return false;
+            const MeshLod *lods = reinterpret_cast<const MeshLod *>(cache.data() + sizeof(MeshCacheHeader));
+            for (uint32_t i = 0; i < out.lodCount; ++i)
+            {
+                if (static_cast<uint64_t>(lods[i].indexOffset) + lods[i].indexCount > out.indexCount)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    MeshView CachedMesh::view() const
+    {
+        if (fromCache())
+            return m_view;
+
+        MeshView view;
+        view.vertices = m_mesh.vertices.data();
+        view.vertexCount = m_mesh.vertices.size();
+        view.indices = m_mesh.indices.data();
+        view.indexCount = m_mesh.indices.size();
+        view.lods = m_lods.data();
+        view.lodCount = m_lods.size();
+        return view;
+    }
+
+    std::string meshCachePath(const std::string &objPath)
+    {
+        return objPath + ".meshbin";
+    }
+
+    bool saveMeshCache(const std::string &cachePath, const MeshData &mesh, const std::vector<MeshLod> &lods,
+                       const FileStamp &source, uint64_t sourceHash, const MeshOptimizationReport &report)
+    {
+        size_t lodBytes = lods.size() * sizeof(MeshLod);
+        size_t vertexBytes = mesh.vertices.size() * sizeof(Vertex);
+        size_t indexBytes = mesh.indices.size() * sizeof(unsigned int);
+
+        MeshCacheHeader header{};
+        std::memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+        header.version = MESH_CACHE_VERSION;
+        header.vertexStride = sizeof(Vertex);
+        header.lodCount = static_cast<uint32_t>(lods.size());
+        header.sourceSize = source.size;
+        header.sourceMtimeNs = source.mtimeNs;
+        header.sourceHash = sourceHash;
+        header.vertexCount = mesh.vertices.size();
+        header.indexCount = mesh.indices.size();
+        header.report = report;
+        // Como lodBytes e vertexBytes são múltiplos de 8, encadear os hashes equivale a calcular o hash
+        // do bloco contínuo que será lido do arquivo.
+        uint64_t hash = hashBytes(lods.data(), lodBytes);
+        hash = hashBytes(mesh.vertices.data(), vertexBytes, hash);
+        header.payloadHash = hashBytes(mesh.indices.data(), indexBytes, hash);
+
+        // Grava em um arquivo temporário e renomeia, para que um processo interrompido
+        // nunca deixe um cache pela metade.
+        std::string tmpPath = cachePath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(lods.data()), lodBytes);
+            out.write(reinterpret_cast<const char *>(mesh.vertices.data()), vertexBytes);
+            out.write(reinterpret_cast<const char *>(mesh.indices.data()), indexBytes);
+            if (!out)
+                return false;
+        }
+        return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+    }
+
+    CachedMesh loadMeshCached(const std::string &objPath)
+    {
+        CachedMesh result;
+        FileStamp source = statFile(objPath);
+        std::string cachePath = meshCachePath(objPath);
+
+        if (source.exists)
+        {
+            MappedFile cache(cachePath);
+            MeshCacheHeader header;
+            if (validateCache(cache, objPath, source, header))
+            {
+                const unsigned char *payload = cache.data() + sizeof(MeshCacheHeader);
+                result.m_view.lods = reinterpret_cast<const MeshLod *>(payload);
+                result.m_view.lodCount = header.lodCount;
+                payload += header.lodCount * sizeof(MeshLod);
+                result.m_view.vertices = reinterpret_cast<const Vertex *>(payload);
+                result.m_view.vertexCount = header.vertexCount;
+                result.m_view.indices = reinterpret_cast<const unsigned int *>(payload + header.vertexCount * sizeof(Vertex));
+                result.m_view.indexCount = header.indexCount;
+                result.m_report = header.report;
+                result.m_file = std::move(cache);
+                // Guarda a nova data de modificação, evitando recalcular o hash do .obj nas próximas
+                // execuções. Se a escrita falhar (ex: diretório somente leitura), o cache continua
+                // válido e o hash só volta a ser calculado na próxima vez.
+                if (header.sourceMtimeNs != source.mtimeNs)
+                    overwriteFileBytes(cachePath, offsetof(MeshCacheHeader, sourceMtimeNs), &source.mtimeNs, sizeof(source.mtimeNs));
+                return result;
+            }
+        }
+
+        // Cache ausente ou desatualizado: analisa e otimiza o .obj, gera os LODs e regrava o cache
+        // para a próxima execução. Esse custo só é pago uma vez por versão do arquivo.
+        result.m_mesh = loadObj(objPath);
+        result.m_report = optimizeMesh(result.m_mesh);
+        result.m_lods = buildLodChain(result.m_mesh);
+        saveMeshCache(cachePath, result.m_mesh, result.m_lods, source, hashFile(objPath), result.m_report);
+        return result;
+    }
+}
@@ -0,0 +1,175 @@
+#include "worldgen/MeshData.hpp"
+#include "worldgen/ObjParser.hpp"
+#include <stdexcept>
+
+// Inclui e implementa a biblioteca de cabeçalho único diretamente aqui.
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+namespace worldgen
+{
+    namespace
+    {
+        /**
+         * @brief Tabela hash de endereçamento aberto (sondagem linear) que associa cada trinca
+         * de índices do .obj (posição, normal, texcoord) ao vértice único correspondente.
+         *
+         * Cada posição da tabela guarda apenas o índice do vértice (4 bytes); as trincas ficam
+         * num vetor paralelo, na ordem em que os vértices foram criados. Como o número de vértices
+         * únicos nunca passa do número de índices, a tabela é dimensionada uma única vez e nunca
+         * precisa crescer.
+         */
+        class IndexTripletTable
+        {
+        public:
+            explicit IndexTripletTable(size_t indexCount)
+            {
+                size_t capacity = 16;
+                while (capacity < indexCount + indexCount / 4) // Fator de carga máximo de 0.8.
+                    capacity *= 2;
+                m_mask = capacity - 1;
+                m_slots.assign(capacity, EMPTY);
+                m_keys.reserve(indexCount / 4);
+            }
+
+            /**
+             * @brief Procura a trinca; se ela ainda não existir, a insere com o próximo índice livre.
+             * @param inserted Recebe true se a trinca era nova.
+             * @return O índice do vértice único.
+             */
+            uint32_t findOrInsert(const ObjIndex &key, bool &inserted)
+            {
+                size_t slot = hash(key) & m_mask;
+                while (m_slots[slot] != EMPTY)
+                {
+                    const ObjIndex &other = m_keys[m_slots[slot]];
+                    if (other.vertex == key.vertex && other.normal == key.normal && other.texcoord == key.texcoord)
+                    {
+                        inserted = false;
+                        return m_slots[slot];
+                    }
+                    slot = (slot + 1) & m_mask;
+                }
+
+                uint32_t index = static_cast<uint32_t>(m_keys.size());
+                m_slots[slot] = index;
+                m_keys.push_back(key);
+                inserted = true;
+                return index;
+            }
+
+        private:
+            static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+            static size_t hash(const ObjIndex &key)
+            {
+                // Combina os três índices com multiplicadores ímpares grandes e espalha os bits altos.
+                uint64_t h = uint64_t(uint32_t(key.vertex)) * 0x9E3779B97F4A7C15ull;
+                h ^= uint64_t(uint32_t(key.normal)) * 0xC2B2AE3D27D4EB4Full;
+                h ^= uint64_t(uint32_t(key.texcoord)) * 0x165667B19E3779F9ull;
+                return static_cast<size_t>(h ^ (h >> 29));
+            }
+
+            size_t m_mask;
+            std::vector<uint32_t> m_slots;        // Índice do vértice em cada posição, ou EMPTY.
+            std::vector<ObjIndex> m_keys;   // Trinca de cada vértice único.
+        };
+
+        /**
+         * @brief Caminho sequencial de leitura, usado quando o leitor paralelo recusa o arquivo.
+         * Utiliza a biblioteca tiny_obj_loader e converte o resultado para ObjGeometry.
+         */
+        ObjGeometry parseObjTinyobj(const std::string &path)
+        {
+            tinyobj::attrib_t attrib;
+            std::vector<tinyobj::shape_t> shapes;
+            std::vector<tinyobj::material_t> materials;
+            std::string warn, err;
+
+            // Chama a função da biblioteca para carregar o arquivo.
+            if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
+            {
+                throw std::runtime_error(warn + err);
+            }
+
+            ObjGeometry geometry;
+            geometry.positions = std::move(attrib.vertices);
+            geometry.normals = std::move(attrib.normals);
+            geometry.texcoords = std::move(attrib.texcoords);
+            // Itera sobre todas as "formas" (objetos) dentro do arquivo .obj.
+            for (const auto &shape : shapes)
+            {
+                // O tinyobj usa -1 para atributo ausente.
+                for (const auto &index : shape.mesh.indices)
+                    geometry.indices.push_back({index.vertex_index,
+                                                index.normal_index == -1 ? OBJ_INDEX_ABSENT : index.normal_index,
+                                                index.texcoord_index == -1 ? OBJ_INDEX_ABSENT : index.texcoord_index});
+            }
+            return geometry;
+        }
+    }
+
+    /**
+     * @brief O arquivo é lido pelo leitor paralelo (ou pelo tinyobj, como alternativa). O principal
+     * desafio aqui é combinar os diferentes atributos (posição, normal, texcoord) em uma única
+     * struct Vertex e otimizar o resultado para remover vértices duplicados.
+     */
+    MeshData loadObj(const std::string &path)
+    {
+        ObjGeometry geometry;
+        if (!parseObjParallel(path, geometry))
+        {
+            // O tinyobj só avisa sobre índices fora do intervalo; a verificação é a mesma do leitor paralelo.
+            geometry = parseObjTinyobj(path);
+            validateObjIndices(geometry, path);
+        }
+
+        MeshData mesh;
+        size_t indexCount = geometry.indices.size();
+        mesh.indices.reserve(indexCount);
+
+        // Vértices iguais no .obj compartilham a mesma trinca de índices, então basta deduplicar
+        // as trincas: não é preciso montar nem comparar a struct Vertex inteira.
+        IndexTripletTable uniqueVertices(indexCount);
+        mesh.vertices.reserve(indexCount / 4);
+
+        // Itera sobre todos os cantos dos triângulos, na ordem do arquivo.
+        for (const ObjIndex &index : geometry.indices)
+        {
+            bool inserted;
+            uint32_t vertexIndex = uniqueVertices.findOrInsert(index, inserted);
+            mesh.indices.push_back(vertexIndex);
+            if (!inserted)
+                continue;
+
+            Vertex vertex{}; // Cria uma nova struct Vertex para preencher.
+
+            // Preenche a posição do vértice.
+            vertex.Position = {
+                geometry.positions[3 * index.vertex + 0],
+                geometry.positions[3 * index.vertex + 1],
+                geometry.positions[3 * index.vertex + 2]};
+
+            // Verifica se o vértice possui coordenadas de textura.
+            if (index.texcoord != OBJ_INDEX_ABSENT)
+            {
+                vertex.TexCoords = {
+                    geometry.texcoords[2 * index.texcoord + 0],
+                    1.0f - geometry.texcoords[2 * index.texcoord + 1] // O Y é invertido, pois o formato .obj e o OpenGL têm origens diferentes.
+                };
+            }
+
+            // Verifica se o vértice possui uma normal.
+            if (index.normal != OBJ_INDEX_ABSENT)
+            {
+                vertex.Normal = {
+                    geometry.normals[3 * index.normal + 0],
+                    geometry.normals[3 * index.normal + 1],
+                    geometry.normals[3 * index.normal + 2]};
+            }
+
+            mesh.vertices.push_back(vertex);
+        }
+        return mesh;
+    }
+}
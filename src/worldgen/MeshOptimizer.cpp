@@ -0,0 +1,306 @@
+#include "worldgen/MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Parâmetros do algoritmo de Forsyth.
+        const int FORSYTH_CACHE_SIZE = 32;
+        const float CACHE_DECAY_POWER = 1.5f;
+        const float LAST_TRI_SCORE = 0.75f;
+        const float VALENCE_BOOST_SCALE = 2.0f;
+        const float VALENCE_BOOST_POWER = 0.5f;
+
+        // Tamanho do cache FIFO usado para medir ACMR e delimitar os grupos do overdraw.
+        const unsigned int FIFO_CACHE_SIZE = 16;
+
+        /**
+         * @brief Pontuação de um vértice: alta se foi usado recentemente (está no topo do cache)
+         * e se restam poucos triângulos usando-o (para "fechar" regiões e não deixá-las para depois).
+         */
+        float vertexScore(int cachePosition, unsigned int remainingValence)
+        {
+            if (remainingValence == 0)
+                return -1.0f; // Vértice sem triângulos restantes.
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                {
+                    // Vértices do último triângulo têm pontuação fixa, para não favorecer fitas.
+                    score = LAST_TRI_SCORE;
+                }
+                else
+                {
+                    float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+                }
+            }
+            score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -VALENCE_BOOST_POWER);
+            return score;
+        }
+    }
+
+    VertexCacheStats analyzeVertexCache(const unsigned int *indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+    {
+        VertexCacheStats stats;
+        if (indexCount == 0)
+            return stats;
+
+        // Em um FIFO, um vértice está no cache se entrou há menos de 'cacheSize' faltas.
+        std::vector<size_t> insertedAt(vertexCount, 0);
+        std::vector<bool> used(vertexCount, false);
+        size_t misses = 0;
+        size_t uniqueVertices = 0;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            unsigned int v = indices[i];
+            if (!used[v])
+            {
+                used[v] = true;
+                ++uniqueVertices;
+            }
+            else if (misses - insertedAt[v] < cacheSize)
+            {
+                continue; // Acerto.
+            }
+            insertedAt[v] = misses;
+            ++misses;
+        }
+
+        stats.acmr = static_cast<float>(misses) / (indexCount / 3);
+        stats.atvr = static_cast<float>(misses) / uniqueVertices;
+        return stats;
+    }
+
+    void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        // Lista de adjacência vértice -> triângulos (formato compacto: deslocamentos + lista).
+        std::vector<unsigned int> valence(vertexCount, 0);
+        for (unsigned int v : indices)
+            ++valence[v];
+        std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+            adjacencyOffset[v + 1] = adjacencyOffset[v] + valence[v];
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+
+        // 'valence' passa a contar apenas os triângulos ainda não emitidos; a lista de cada vértice
+        // mantém os triângulos ativos nas primeiras 'valence[v]' posições.
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+            vertexScores[v] = vertexScore(-1, valence[v]);
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        for (size_t t = 0; t < triangleCount; ++t)
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+        std::vector<unsigned int> result;
+        result.reserve(indices.size());
+        std::vector<unsigned int> cache, newCache;
+        cache.reserve(FORSYTH_CACHE_SIZE + 3);
+        newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+        size_t scanCursor = 0; // Usado quando nenhum triângulo no cache está disponível.
+        long best = static_cast<long>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+        while (best >= 0)
+        {
+            // 1. Emite o melhor triângulo e o remove das listas dos seus vértices.
+            emitted[best] = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v = indices[best * 3 + k];
+                result.push_back(v);
+
+                unsigned int *list = &adjacency[adjacencyOffset[v]];
+                for (unsigned int i = 0; i < valence[v]; ++i)
+                {
+                    if (list[i] == static_cast<unsigned int>(best))
+                    {
+                        list[i] = list[valence[v] - 1];
+                        break;
+                    }
+                }
+                --valence[v];
+            }
+
+            // 2. Atualiza o cache LRU simulado: os vértices do triângulo vão para o topo.
+            newCache.clear();
+            for (int k = 0; k < 3; ++k)
+                newCache.push_back(indices[best * 3 + k]);
+            for (unsigned int v : cache)
+            {
+                if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+                    newCache.push_back(v);
+            }
+            for (size_t i = FORSYTH_CACHE_SIZE; i < newCache.size(); ++i)
+                cachePosition[newCache[i]] = -1; // Saiu do cache.
+            if (newCache.size() > static_cast<size_t>(FORSYTH_CACHE_SIZE))
+                newCache.resize(FORSYTH_CACHE_SIZE);
+            cache.swap(newCache);
+
+            // 3. Recalcula as pontuações dos vértices no cache e dos seus triângulos restantes,
+            // escolhendo o melhor entre eles como próximo candidato.
+            for (size_t i = 0; i < cache.size(); ++i)
+            {
+                cachePosition[cache[i]] = static_cast<int>(i);
+                vertexScores[cache[i]] = vertexScore(static_cast<int>(i), valence[cache[i]]);
+            }
+            best = -1;
+            float bestScore = -1.0f;
+            for (unsigned int v : cache)
+            {
+                const unsigned int *list = &adjacency[adjacencyOffset[v]];
+                for (unsigned int i = 0; i < valence[v]; ++i)
+                {
+                    unsigned int t = list[i];
+                    float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+                    triangleScores[t] = score;
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+
+            // 4. Nenhum triângulo vizinho: continua pelo próximo triângulo ainda não emitido.
+            if (best < 0)
+            {
+                while (scanCursor < triangleCount && emitted[scanCursor])
+                    ++scanCursor;
+                if (scanCursor < triangleCount)
+                    best = static_cast<long>(scanCursor);
+            }
+        }
+        indices.swap(result);
+    }
+
+    void optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        // 1. Delimita os grupos: um novo grupo começa sempre que um triângulo perde os três
+        // vértices no cache FIFO, pois ali a ordem pode mudar sem custo extra de cache.
+        std::vector<size_t> clusterStart;
+        std::vector<size_t> insertedAt(vertices.size(), 0);
+        std::vector<bool> seen(vertices.size(), false);
+        size_t misses = 0;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            int triangleMisses = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v = indices[t * 3 + k];
+                if (seen[v] && misses - insertedAt[v] < FIFO_CACHE_SIZE)
+                    continue;
+                seen[v] = true;
+                insertedAt[v] = misses++;
+                ++triangleMisses;
+            }
+            if (t == 0 || triangleMisses == 3)
+                clusterStart.push_back(t);
+        }
+        clusterStart.push_back(triangleCount);
+        size_t clusterCount = clusterStart.size() - 1;
+
+        // 2. Centroide da malha e, para cada grupo, centroide e normal ponderados pela área.
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+        std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            float clusterArea = 0.0f;
+            for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t)
+            {
+                const glm::vec3 &p0 = vertices[indices[t * 3]].Position;
+                const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].Position;
+                const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].Position;
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0); // Comprimento = 2x a área.
+                float area = glm::length(normal);
+                glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+                clusterCentroid[c] += centroid * area;
+                clusterNormal[c] += normal;
+                clusterArea += area;
+            }
+            meshCentroid += clusterCentroid[c];
+            meshArea += clusterArea;
+            clusterCentroid[c] = clusterArea > 0.0f ? clusterCentroid[c] / clusterArea
+                                                    : vertices[indices[clusterStart[c] * 3]].Position;
+        }
+        if (meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        // 3. Grupos mais "para fora" da malha, na direção da sua normal, são desenhados primeiro:
+        // eles tendem a ocultar os grupos internos, que então falham no teste de profundidade.
+        std::vector<float> sortKey(clusterCount, 0.0f);
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            float length = glm::length(clusterNormal[c]);
+            if (length > 0.0f)
+                sortKey[c] = glm::dot(clusterCentroid[c] - meshCentroid, clusterNormal[c] / length);
+        }
+        std::vector<size_t> order(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+            order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return sortKey[a] > sortKey[b]; });
+
+        std::vector<unsigned int> result;
+        result.reserve(indices.size());
+        for (size_t c : order)
+            result.insert(result.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+        indices.swap(result);
+    }
+
+    void optimizeVertexFetch(MeshData &mesh)
+    {
+        const unsigned int UNUSED = 0xFFFFFFFFu;
+        std::vector<unsigned int> remap(mesh.vertices.size(), UNUSED);
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+
+        for (unsigned int &index : mesh.indices)
+        {
+            if (remap[index] == UNUSED)
+            {
+                remap[index] = static_cast<unsigned int>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+        mesh.vertices.swap(vertices);
+    }
+
+    MeshOptimizationReport optimizeMesh(MeshData &mesh)
+    {
+        MeshOptimizationReport report;
+        report.before = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+        optimizeVertexCache(mesh.indices, mesh.vertices.size());
+        optimizeOverdraw(mesh.indices, mesh.vertices);
+        optimizeVertexFetch(mesh);
+
+        report.after = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+        return report;
+    }
+}
@@ -0,0 +1,666 @@
+#include "worldgen/MeshSimplifier.hpp"
+#include "worldgen/MeshOptimizer.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Parâmetros da cadeia de LODs.
+        const int MAX_LOD_COUNT = 5;              // Inclui o nível 0 (malha completa).
+        const float LOD_REDUCTION = 0.5f;         // Fração de índices mantida a cada nível.
+        const float MAX_LOD_ERROR = 0.05f;        // Erro máximo, relativo ao tamanho da malha.
+        const float MIN_LOD_GAIN = 0.8f;          // Um nível com mais de 80% dos índices do anterior não compensa.
+        const size_t MIN_LOD_INDEX_COUNT = 3 * 64; // Abaixo disso, simplificar não economiza nada.
+
+        // Pesos das quádricas de aresta, que seguram o contorno de bordas e costuras.
+        const double BORDER_EDGE_WEIGHT = 10.0;
+        const double SEAM_EDGE_WEIGHT = 1.0;
+
+        const unsigned int NONE = 0xFFFFFFFFu;
+        const unsigned int MULTIPLE = 0xFFFFFFFEu;
+
+        /**
+         * @brief Classificação de um vértice, que decide para onde ele pode colapsar.
+         */
+        enum class VertexKind
+        {
+            Manifold, // Interior de uma superfície, sem costura: colapsa para qualquer vizinho.
+            Border,   // Sobre uma borda aberta: colapsa apenas ao longo da borda.
+            Seam,     // Sobre uma costura (duas cópias na mesma posição): colapsa ao longo da costura, com a cópia.
+            Locked    // Cantos e casos complexos: nunca se move.
+        };
+
+        /**
+         * @struct Quadric
+         * @brief Matriz simétrica 4x4 da soma ponderada de distâncias ao quadrado a um conjunto de planos,
+         * com a soma dos pesos, que faz do erro uma distância média (e não área vezes distância²).
+         */
+        struct Quadric
+        {
+            double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0;
+            double w = 0;
+
+            // Acrescenta o plano n·p + d = 0 (n unitário) com peso w.
+            void addPlane(double nx, double ny, double nz, double d, double w)
+            {
+                a00 += w * nx * nx;
+                a11 += w * ny * ny;
+                a22 += w * nz * nz;
+                a01 += w * nx * ny;
+                a02 += w * nx * nz;
+                a12 += w * ny * nz;
+                b0 += w * nx * d;
+                b1 += w * ny * d;
+                b2 += w * nz * d;
+                c += w * d * d;
+                this->w += w;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                a00 += o.a00, a11 += o.a11, a22 += o.a22, a01 += o.a01, a02 += o.a02, a12 += o.a12;
+                b0 += o.b0, b1 += o.b1, b2 += o.b2, c += o.c;
+                w += o.w;
+                return *this;
+            }
+
+            // Média ponderada das distâncias ao quadrado do ponto p aos planos.
+            double evaluate(const glm::vec3 &p) const
+            {
+                if (w == 0.0)
+                    return 0.0;
+                double x = p.x, y = p.y, z = p.z;
+                double result = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                                2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return std::fabs(result) / w;
+            }
+        };
+
+        // Distância do ponto p ao triângulo abc (Ericson, "Real-Time Collision Detection", 5.1.5).
+        float pointTriangleDistance(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+        {
+            glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+            float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+            if (d1 <= 0.0f && d2 <= 0.0f)
+                return glm::length(p - a);
+            glm::vec3 bp = p - b;
+            float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+            if (d3 >= 0.0f && d4 <= d3)
+                return glm::length(p - b);
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+                return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+            glm::vec3 cp = p - c;
+            float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+            if (d6 >= 0.0f && d5 <= d6)
+                return glm::length(p - c);
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+                return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+                return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+            float denominator = 1.0f / (va + vb + vc);
+            return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+        }
+
+        struct Collapse
+        {
+            unsigned int from;
+            unsigned int to;
+            double error;
+        };
+
+        /**
+         * @class Simplifier
+         * @brief Estado do colapso de arestas. As posições são normalizadas para a caixa unitária,
+         * para que os erros independam da escala do modelo.
+         */
+        class Simplifier
+        {
+        public:
+            Simplifier(const std::vector<Vertex> &vertices, const unsigned int *indices, size_t indexCount)
+                : m_indices(indices, indices + indexCount)
+            {
+                size_t vertexCount = vertices.size();
+
+                // Normaliza as posições.
+                glm::vec3 minP(FLT_MAX), maxP(-FLT_MAX);
+                for (const Vertex &v : vertices)
+                {
+                    minP = glm::min(minP, v.Position);
+                    maxP = glm::max(maxP, v.Position);
+                }
+                glm::vec3 size = maxP - minP;
+                m_extent = std::max(size.x, std::max(size.y, size.z));
+                float invExtent = m_extent > 0.0f ? 1.0f / m_extent : 0.0f;
+                m_positions.resize(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i)
+                    m_positions[i] = (vertices[i].Position - minP) * invExtent;
+
+                m_target.resize(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i)
+                    m_target[i] = static_cast<unsigned int>(i);
+                m_used.assign(vertexCount, 0);
+                for (unsigned int v : m_indices)
+                    m_used[v] = 1;
+
+                buildPositionGroups();
+                buildAdjacency();
+                classify();
+                buildQuadrics();
+            }
+
+            float extent() const { return m_extent; }
+            std::vector<unsigned int> &indices() { return m_indices; }
+
+            /**
+             * @brief Executa passadas de colapsos até atingir o número de índices ou o erro desejado.
+             * O erro das quádricas ordena e limita os colapsos; o valor devolvido é medido no resultado.
+             * @return O maior desvio (distância relativa) entre um vértice da malha de entrada e a malha simplificada.
+             */
+            float simplify(size_t targetIndexCount, float targetError)
+            {
+                double maxError = static_cast<double>(targetError) * targetError;
+                double resultError = 0.0;
+
+                while (m_indices.size() > targetIndexCount)
+                {
+                    std::vector<Collapse> collapses = pickCollapses();
+                    if (collapses.empty())
+                        break;
+                    std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b)
+                              { return a.error < b.error; });
+
+                    // Cada colapso remove cerca de dois triângulos. Limitar a passada a ~1.5x o erro do
+                    // colapso que atingiria a meta evita gastar colapsos caros enquanto outros mais
+                    // baratos ainda podem surgir na próxima passada.
+                    size_t triangleGoal = (m_indices.size() - targetIndexCount) / 3;
+                    size_t edgeGoal = std::max<size_t>(1, triangleGoal / 2);
+                    double passLimit = edgeGoal < collapses.size() ? collapses[edgeGoal].error * 1.5 : DBL_MAX;
+
+                    size_t removed = performCollapses(collapses, triangleGoal, std::min(maxError, passLimit), resultError);
+                    if (removed == 0 && passLimit < maxError)
+                        removed = performCollapses(collapses, triangleGoal, maxError, resultError);
+                    if (removed == 0)
+                        break;
+
+                    applyCollapses();
+                    buildAdjacency();
+                    classify();
+                }
+                return measureDeviation();
+            }
+
+        private:
+            std::vector<unsigned int> m_indices;
+            std::vector<glm::vec3> m_positions;
+            float m_extent = 0.0f;
+
+            // Vértices agrupados por posição idêntica (cópias de uma costura ficam no mesmo grupo).
+            std::vector<unsigned int> m_group;
+            std::vector<unsigned int> m_groupOffset;
+            std::vector<unsigned int> m_groupMembers;
+
+            // Triângulos que usam cada vértice (formato compacto: deslocamentos + lista).
+            std::vector<unsigned int> m_adjacencyOffset;
+            std::vector<unsigned int> m_adjacency;
+
+            // Arestas abertas (sem a aresta oposta) que saem de/chegam em cada vértice.
+            std::vector<unsigned int> m_openOut;
+            std::vector<unsigned int> m_openIn;
+            std::vector<VertexKind> m_kind;
+
+            std::vector<Quadric> m_quadrics; // Uma por grupo de posição.
+            std::vector<unsigned int> m_remap;
+            std::vector<unsigned int> m_target; // Vértice para onde cada vértice da entrada colapsou, somando todas as passadas.
+            std::vector<char> m_used;           // Vértices usados pela malha de entrada.
+            std::vector<char> m_locked;      // Grupos já tocados na passada atual.
+
+            void buildPositionGroups()
+            {
+                size_t vertexCount = m_positions.size();
+                std::vector<unsigned int> order(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i)
+                    order[i] = static_cast<unsigned int>(i);
+                std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b)
+                          {
+                              const glm::vec3 &pa = m_positions[a];
+                              const glm::vec3 &pb = m_positions[b];
+                              if (pa.x != pb.x)
+                                  return pa.x < pb.x;
+                              if (pa.y != pb.y)
+                                  return pa.y < pb.y;
+                              return pa.z < pb.z; });
+
+                m_group.resize(vertexCount);
+                m_groupMembers = order;
+                for (size_t i = 0; i < vertexCount; ++i)
+                {
+                    if (i == 0 || m_positions[order[i]] != m_positions[order[i - 1]])
+                        m_groupOffset.push_back(static_cast<unsigned int>(i));
+                    m_group[order[i]] = static_cast<unsigned int>(m_groupOffset.size() - 1);
+                }
+                m_groupOffset.push_back(static_cast<unsigned int>(vertexCount));
+            }
+
+            void buildAdjacency()
+            {
+                size_t vertexCount = m_positions.size();
+                m_adjacencyOffset.assign(vertexCount + 1, 0);
+                for (unsigned int v : m_indices)
+                    ++m_adjacencyOffset[v + 1];
+                for (size_t v = 0; v < vertexCount; ++v)
+                    m_adjacencyOffset[v + 1] += m_adjacencyOffset[v];
+
+                m_adjacency.resize(m_indices.size());
+                std::vector<unsigned int> fill(m_adjacencyOffset.begin(), m_adjacencyOffset.end() - 1);
+                for (size_t i = 0; i < m_indices.size(); ++i)
+                    m_adjacency[fill[m_indices[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+
+            // Posição (0, 1 ou 2) do vértice v dentro do triângulo t.
+            int corner(unsigned int t, unsigned int v) const
+            {
+                return m_indices[t * 3] == v ? 0 : (m_indices[t * 3 + 1] == v ? 1 : 2);
+            }
+
+            unsigned int next(unsigned int t, int k) const { return m_indices[t * 3 + (k + 1) % 3]; }
+            unsigned int prev(unsigned int t, int k) const { return m_indices[t * 3 + (k + 2) % 3]; }
+
+            // Existe a semiaresta from -> to, entre vértices?
+            bool hasEdge(unsigned int from, unsigned int to) const
+            {
+                for (unsigned int i = m_adjacencyOffset[from]; i < m_adjacencyOffset[from + 1]; ++i)
+                {
+                    unsigned int t = m_adjacency[i];
+                    if (next(t, corner(t, from)) == to)
+                        return true;
+                }
+                return false;
+            }
+
+            // Existe a semiaresta from -> to, entre quaisquer cópias das duas posições?
+            bool hasPositionEdge(unsigned int fromGroup, unsigned int toGroup) const
+            {
+                for (unsigned int m = m_groupOffset[fromGroup]; m < m_groupOffset[fromGroup + 1]; ++m)
+                {
+                    unsigned int from = m_groupMembers[m];
+                    for (unsigned int i = m_adjacencyOffset[from]; i < m_adjacencyOffset[from + 1]; ++i)
+                    {
+                        unsigned int t = m_adjacency[i];
+                        if (m_group[next(t, corner(t, from))] == toGroup)
+                            return true;
+                    }
+                }
+                return false;
+            }
+
+            // Uma aresta aberta entre vértices é borda se também for aberta entre posições; senão é costura.
+            bool isBorderEdge(unsigned int from, unsigned int to) const
+            {
+                return !hasPositionEdge(m_group[to], m_group[from]);
+            }
+
+            bool inUse(unsigned int v) const { return m_adjacencyOffset[v + 1] > m_adjacencyOffset[v]; }
+
+            static void setOpen(unsigned int &slot, unsigned int v)
+            {
+                slot = (slot == NONE || slot == v) ? v : MULTIPLE;
+            }
+
+            static bool single(unsigned int v) { return v != NONE && v != MULTIPLE; }
+
+            void classify()
+            {
+                size_t vertexCount = m_positions.size();
+                m_openOut.assign(vertexCount, NONE);
+                m_openIn.assign(vertexCount, NONE);
+                for (size_t t = 0; t < m_indices.size() / 3; ++t)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        unsigned int from = m_indices[t * 3 + k];
+                        unsigned int to = m_indices[t * 3 + (k + 1) % 3];
+                        if (!hasEdge(to, from))
+                        {
+                            setOpen(m_openOut[from], to);
+                            setOpen(m_openIn[to], from);
+                        }
+                    }
+                }
+
+                m_kind.assign(vertexCount, VertexKind::Locked);
+                for (size_t g = 0; g + 1 < m_groupOffset.size(); ++g)
+                {
+                    unsigned int used[3];
+                    int usedCount = 0;
+                    for (unsigned int m = m_groupOffset[g]; m < m_groupOffset[g + 1] && usedCount < 3; ++m)
+                    {
+                        if (inUse(m_groupMembers[m]))
+                            used[usedCount++] = m_groupMembers[m];
+                    }
+
+                    if (usedCount == 1)
+                    {
+                        unsigned int v = used[0];
+                        if (m_openOut[v] == NONE && m_openIn[v] == NONE)
+                            m_kind[v] = VertexKind::Manifold;
+                        else if (single(m_openOut[v]) && single(m_openIn[v]) &&
+                                 isBorderEdge(v, m_openOut[v]) && isBorderEdge(m_openIn[v], v))
+                            m_kind[v] = VertexKind::Border;
+                    }
+                    else if (usedCount == 2)
+                    {
+                        // Uma costura simples: cada cópia tem exatamente uma aresta aberta de entrada e uma
+                        // de saída, e elas correm em sentidos opostos pelas mesmas posições.
+                        unsigned int v = used[0], w = used[1];
+                        if (single(m_openOut[v]) && single(m_openIn[v]) && single(m_openOut[w]) && single(m_openIn[w]) &&
+                            m_group[m_openOut[v]] == m_group[m_openIn[w]] && m_group[m_openIn[v]] == m_group[m_openOut[w]] &&
+                            m_group[m_openOut[v]] != m_group[m_openIn[v]])
+                        {
+                            m_kind[v] = VertexKind::Seam;
+                            m_kind[w] = VertexKind::Seam;
+                        }
+                    }
+                }
+            }
+
+            // A outra cópia de um vértice de costura.
+            unsigned int sibling(unsigned int v) const
+            {
+                unsigned int g = m_group[v];
+                for (unsigned int m = m_groupOffset[g]; m < m_groupOffset[g + 1]; ++m)
+                {
+                    unsigned int w = m_groupMembers[m];
+                    if (w != v && inUse(w))
+                        return w;
+                }
+                return NONE;
+            }
+
+            void buildQuadrics()
+            {
+                m_quadrics.assign(m_groupOffset.size() - 1, Quadric());
+                for (size_t t = 0; t < m_indices.size() / 3; ++t)
+                {
+                    const glm::vec3 &p0 = m_positions[m_indices[t * 3]];
+                    const glm::vec3 &p1 = m_positions[m_indices[t * 3 + 1]];
+                    const glm::vec3 &p2 = m_positions[m_indices[t * 3 + 2]];
+                    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                    float length = glm::length(normal);
+                    if (length == 0.0f)
+                        continue;
+                    normal /= length;
+
+                    // Quádrica do plano do triângulo, ponderada pela área.
+                    Quadric q;
+                    q.addPlane(normal.x, normal.y, normal.z, -glm::dot(normal, p0), length * 0.5);
+                    for (int k = 0; k < 3; ++k)
+                        m_quadrics[m_group[m_indices[t * 3 + k]]] += q;
+
+                    // Arestas abertas ganham um plano perpendicular ao triângulo, que segura o contorno.
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        unsigned int from = m_indices[t * 3 + k];
+                        unsigned int to = m_indices[t * 3 + (k + 1) % 3];
+                        if (m_openOut[from] == NONE || hasEdge(to, from))
+                            continue;
+
+                        glm::vec3 edge = m_positions[to] - m_positions[from];
+                        float edgeLength = glm::length(edge);
+                        glm::vec3 edgeNormal = glm::cross(edge, normal);
+                        float edgeNormalLength = glm::length(edgeNormal);
+                        if (edgeNormalLength == 0.0f)
+                            continue;
+                        edgeNormal /= edgeNormalLength;
+
+                        double weight = (isBorderEdge(from, to) ? BORDER_EDGE_WEIGHT : SEAM_EDGE_WEIGHT) * edgeLength * edgeLength;
+                        Quadric e;
+                        e.addPlane(edgeNormal.x, edgeNormal.y, edgeNormal.z, -glm::dot(edgeNormal, m_positions[from]), weight);
+                        m_quadrics[m_group[from]] += e;
+                        m_quadrics[m_group[to]] += e;
+                    }
+                }
+            }
+
+            // O vértice 'from' pode colapsar para 'to' segundo as regras de cada tipo?
+            bool canCollapse(unsigned int from, unsigned int to) const
+            {
+                VertexKind kind = m_kind[from];
+                if (kind == VertexKind::Manifold)
+                    return true;
+                if (kind == VertexKind::Locked || m_kind[to] != kind)
+                    return false;
+
+                // Bordas e costuras só se movem ao longo de uma aresta aberta.
+                if (m_openOut[from] != to && m_openIn[from] != to)
+                    return false;
+                if (kind == VertexKind::Seam)
+                {
+                    unsigned int fromSibling = sibling(from);
+                    unsigned int toSibling = sibling(to);
+                    return m_openOut[fromSibling] == toSibling || m_openIn[fromSibling] == toSibling;
+                }
+                return true;
+            }
+
+            std::vector<Collapse> pickCollapses() const
+            {
+                std::vector<Collapse> collapses;
+                for (size_t t = 0; t < m_indices.size() / 3; ++t)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        unsigned int a = m_indices[t * 3 + k];
+                        unsigned int b = m_indices[t * 3 + (k + 1) % 3];
+                        // Cada aresta interior aparece em dois triângulos; avalia-a uma única vez.
+                        if (a > b && hasEdge(b, a))
+                            continue;
+
+                        Quadric q = m_quadrics[m_group[a]];
+                        q += m_quadrics[m_group[b]];
+                        double errorAB = canCollapse(a, b) ? q.evaluate(m_positions[b]) : DBL_MAX;
+                        double errorBA = canCollapse(b, a) ? q.evaluate(m_positions[a]) : DBL_MAX;
+                        if (errorAB == DBL_MAX && errorBA == DBL_MAX)
+                            continue;
+                        collapses.push_back(errorAB <= errorBA ? Collapse{a, b, errorAB} : Collapse{b, a, errorBA});
+                    }
+                }
+                return collapses;
+            }
+
+            // Rejeita colapsos que inverteriam a orientação de algum triângulo ao redor de 'from'.
+            bool flipsTriangles(unsigned int from, unsigned int to) const
+            {
+                for (unsigned int i = m_adjacencyOffset[from]; i < m_adjacencyOffset[from + 1]; ++i)
+                {
+                    unsigned int t = m_adjacency[i];
+                    int k = corner(t, from);
+                    unsigned int b = next(t, k), c = prev(t, k);
+                    if (b == to || c == to)
+                        continue; // Triângulo removido pelo colapso.
+
+                    const glm::vec3 &pb = m_positions[b];
+                    const glm::vec3 &pc = m_positions[c];
+                    glm::vec3 before = glm::cross(pb - m_positions[from], pc - m_positions[from]);
+                    glm::vec3 after = glm::cross(pb - m_positions[to], pc - m_positions[to]);
+                    if (glm::dot(before, after) <= 0.0f)
+                        return true;
+                }
+                return false;
+            }
+
+            // Triângulos removidos ao colapsar 'from' para 'to' (os que usam os dois vértices).
+            size_t sharedTriangles(unsigned int from, unsigned int to) const
+            {
+                size_t count = 0;
+                for (unsigned int i = m_adjacencyOffset[from]; i < m_adjacencyOffset[from + 1]; ++i)
+                {
+                    unsigned int t = m_adjacency[i];
+                    int k = corner(t, from);
+                    if (next(t, k) == to || prev(t, k) == to)
+                        ++count;
+                }
+                return count;
+            }
+
+            // Impede que outros colapsos da mesma passada toquem 'v' ou seus vizinhos.
+            void lockNeighbourhood(unsigned int v)
+            {
+                for (unsigned int i = m_adjacencyOffset[v]; i < m_adjacencyOffset[v + 1]; ++i)
+                {
+                    unsigned int t = m_adjacency[i];
+                    for (int k = 0; k < 3; ++k)
+                        m_locked[m_group[m_indices[t * 3 + k]]] = 1;
+                }
+            }
+
+            size_t performCollapses(const std::vector<Collapse> &collapses, size_t triangleGoal, double errorLimit, double &resultError)
+            {
+                m_remap.resize(m_positions.size());
+                for (size_t i = 0; i < m_remap.size(); ++i)
+                    m_remap[i] = static_cast<unsigned int>(i);
+                m_locked.assign(m_quadrics.size(), 0);
+
+                size_t removed = 0;
+                for (const Collapse &collapse : collapses)
+                {
+                    if (removed >= triangleGoal || collapse.error > errorLimit)
+                        break;
+
+                    unsigned int from = collapse.from, to = collapse.to;
+                    if (m_locked[m_group[from]] || m_locked[m_group[to]])
+                        continue;
+
+                    bool seam = m_kind[from] == VertexKind::Seam;
+                    unsigned int fromSibling = seam ? sibling(from) : NONE;
+                    unsigned int toSibling = seam ? sibling(to) : NONE;
+                    if (flipsTriangles(from, to) || (seam && flipsTriangles(fromSibling, toSibling)))
+                        continue;
+
+                    m_remap[from] = to;
+                    removed += sharedTriangles(from, to);
+                    lockNeighbourhood(from);
+                    if (seam)
+                    {
+                        // As duas cópias da costura se movem juntas, cada uma para a cópia do seu lado.
+                        m_remap[fromSibling] = toSibling;
+                        removed += sharedTriangles(fromSibling, toSibling);
+                        lockNeighbourhood(fromSibling);
+                    }
+
+                    m_quadrics[m_group[to]] += m_quadrics[m_group[from]];
+                    resultError = std::max(resultError, collapse.error);
+                }
+                return removed;
+            }
+
+            // Reescreve os índices e descarta os triângulos que ficaram degenerados.
+            void applyCollapses()
+            {
+                size_t write = 0;
+                for (size_t i = 0; i < m_indices.size(); i += 3)
+                {
+                    unsigned int a = m_remap[m_indices[i]];
+                    unsigned int b = m_remap[m_indices[i + 1]];
+                    unsigned int c = m_remap[m_indices[i + 2]];
+                    if (a == b || b == c || a == c)
+                        continue;
+                    m_indices[write++] = a;
+                    m_indices[write++] = b;
+                    m_indices[write++] = c;
+                }
+                m_indices.resize(write);
+
+                for (unsigned int &target : m_target)
+                    target = m_remap[target];
+            }
+
+            /**
+             * @brief Maior distância entre um vértice da entrada e os triângulos finais em volta do vértice para
+             * onde ele colapsou. Limita por cima a distância até a superfície simplificada inteira, sem busca espacial.
+             * Requer a adjacência da malha final.
+             */
+            float measureDeviation() const
+            {
+                float deviation = 0.0f;
+                for (size_t v = 0; v < m_target.size(); ++v)
+                {
+                    unsigned int target = m_target[v];
+                    if (!m_used[v] || target == v)
+                        continue;
+
+                    const glm::vec3 &p = m_positions[v];
+                    float distance = glm::length(p - m_positions[target]);
+                    for (unsigned int i = m_adjacencyOffset[target]; i < m_adjacencyOffset[target + 1]; ++i)
+                    {
+                        unsigned int t = m_adjacency[i];
+                        distance = std::min(distance, pointTriangleDistance(p, m_positions[m_indices[t * 3]], m_positions[m_indices[t * 3 + 1]],
+                                                                            m_positions[m_indices[t * 3 + 2]]));
+                    }
+                    deviation = std::max(deviation, distance);
+                }
+                return deviation;
+            }
+        };
+    }
+
+    std::vector<unsigned int> simplifyMesh(const std::vector<Vertex> &vertices, const unsigned int *indices, size_t indexCount,
+                                           size_t targetIndexCount, float targetError, float *resultError)
+    {
+        Simplifier simplifier(vertices, indices, indexCount);
+        float error = simplifier.simplify(targetIndexCount, targetError);
+        if (resultError)
+            *resultError = error;
+        return std::move(simplifier.indices());
+    }
+
+    std::vector<MeshLod> buildLodChain(MeshData &mesh)
+    {
+        std::vector<MeshLod> lods(1);
+        lods[0].indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+        // Escala da malha, para converter o erro relativo em unidades do modelo.
+        glm::vec3 minP(FLT_MAX), maxP(-FLT_MAX);
+        for (const Vertex &v : mesh.vertices)
+        {
+            minP = glm::min(minP, v.Position);
+            maxP = glm::max(maxP, v.Position);
+        }
+        glm::vec3 size = maxP - minP;
+        float extent = std::max(size.x, std::max(size.y, size.z));
+
+        // Cada nível parte do anterior, que já é menor; o erro acumulado é limitado em relação ao original
+        // somando os desvios medidos em cada etapa. Um nível que passaria do limite encerra a cadeia.
+        float accumulatedError = 0.0f;
+        while (lods.size() < static_cast<size_t>(MAX_LOD_COUNT))
+        {
+            const MeshLod &previous = lods.back();
+            if (previous.indexCount < MIN_LOD_INDEX_COUNT)
+                break;
+
+            size_t target = static_cast<size_t>(previous.indexCount * LOD_REDUCTION) / 3 * 3;
+            float error = 0.0f;
+            std::vector<unsigned int> indices = simplifyMesh(mesh.vertices, mesh.indices.data() + previous.indexOffset,
+                                                             previous.indexCount, target, MAX_LOD_ERROR - accumulatedError, &error);
+            if (indices.size() > previous.indexCount * MIN_LOD_GAIN || accumulatedError + error > MAX_LOD_ERROR)
+                break;
+
+            accumulatedError += error;
+            optimizeVertexCache(indices, mesh.vertices.size());
+
+            MeshLod lod;
+            lod.indexOffset = static_cast<uint32_t>(mesh.indices.size());
+            lod.indexCount = static_cast<uint32_t>(indices.size());
+            lod.error = accumulatedError * extent;
+            mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+            lods.push_back(lod);
+        }
+        return lods;
+    }
+}
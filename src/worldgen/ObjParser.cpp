@@ -0,0 +1,459 @@
+#include "worldgen/ObjParser.hpp"
+#include "worldgen/MappedFile.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Bits de 'Chunk::relative' indicando quais componentes usaram índice negativo (relativo).
+        const unsigned char RELATIVE_VERTEX = 1;
+        const unsigned char RELATIVE_TEXCOORD = 2;
+        const unsigned char RELATIVE_NORMAL = 4;
+
+        // Blocos menores que isto não compensam o custo de criar uma thread.
+        const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+        /**
+         * @brief Resultado da análise de um bloco de linhas do arquivo.
+         * Índices positivos já são absolutos; os negativos são resolvidos contra as contagens
+         * locais do bloco e corrigidos na junção, quando os deslocamentos globais são conhecidos.
+         */
+        struct Chunk
+        {
+            const char *begin;
+            const char *end;
+            std::vector<float> positions, normals, texcoords;
+            std::vector<ObjIndex> corners;       // Cantos de todas as faces do bloco.
+            std::vector<unsigned int> faceSizes; // Número de cantos de cada face.
+            std::vector<unsigned char> relative; // Só é preenchido depois do primeiro índice negativo.
+            bool hasRelative = false;
+            std::vector<ObjIndex> triangles;     // Cantos após a triangulação.
+            bool ok = true;
+        };
+
+        inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        inline const char *skipSpaces(const char *p, const char *end)
+        {
+            while (p < end && isSpace(*p))
+                ++p;
+            return p;
+        }
+
+        // Lê um float com std::from_chars (sem locale e sem alocação). Campos ausentes valem 0.
+        inline float parseFloat(const char *&p, const char *end)
+        {
+            p = skipSpaces(p, end);
+            if (p < end && *p == '+')
+                ++p;
+            float value = 0.0f;
+            std::from_chars_result result = std::from_chars(p, end, value);
+            if (result.ec == std::errc::result_out_of_range)
+                value = 0.0f;
+            if (result.ptr != p)
+                p = result.ptr;
+            return value;
+        }
+
+        inline bool parseInt(const char *&p, const char *end, int &value)
+        {
+            if (p < end && *p == '+')
+                ++p;
+            std::from_chars_result result = std::from_chars(p, end, value);
+            if (result.ec != std::errc())
+                return false;
+            p = result.ptr;
+            return true;
+        }
+
+        // Converte um índice do .obj (base 1, ou negativo = relativo) para base zero.
+        inline bool resolveIndex(int raw, size_t localCount, int &out, unsigned char &relative, unsigned char flag)
+        {
+            if (raw > 0)
+            {
+                out = raw - 1;
+                return true;
+            }
+            if (raw == 0 || raw == OBJ_INDEX_ABSENT) // Zero não é permitido pela especificação; o outro valor é a marca de ausência.
+                return false;
+            out = static_cast<int>(localCount) + raw;
+            relative |= flag;
+            return true;
+        }
+
+        bool parseFace(Chunk &chunk, const char *p, const char *lineEnd)
+        {
+            unsigned int count = 0;
+            while (true)
+            {
+                p = skipSpaces(p, lineEnd);
+                if (p >= lineEnd)
+                    break;
+
+                ObjIndex index{-1, OBJ_INDEX_ABSENT, OBJ_INDEX_ABSENT};
+                unsigned char relative = 0;
+                int raw;
+                if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, chunk.positions.size() / 3, index.vertex, relative, RELATIVE_VERTEX))
+                    return false;
+                if (p < lineEnd && *p == '/')
+                {
+                    ++p;
+                    if (p < lineEnd && *p != '/')
+                    {
+                        if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, chunk.texcoords.size() / 2, index.texcoord, relative, RELATIVE_TEXCOORD))
+                            return false;
+                    }
+                    if (p < lineEnd && *p == '/')
+                    {
+                        ++p;
+                        if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, chunk.normals.size() / 3, index.normal, relative, RELATIVE_NORMAL))
+                            return false;
+                    }
+                }
+                if (p < lineEnd && !isSpace(*p))
+                    return false;
+
+                if (relative && !chunk.hasRelative)
+                {
+                    chunk.relative.assign(chunk.corners.size(), 0);
+                    chunk.hasRelative = true;
+                }
+                if (chunk.hasRelative)
+                    chunk.relative.push_back(relative);
+                chunk.corners.push_back(index);
+                ++count;
+            }
+            chunk.faceSizes.push_back(count);
+            return true;
+        }
+
+        // Analisa todas as linhas do bloco. Só v, vt, vn e f são relevantes para a malha.
+        void parseChunk(Chunk &chunk)
+        {
+            const char *p = chunk.begin;
+            while (p < chunk.end && chunk.ok)
+            {
+                const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', chunk.end - p));
+                if (!lineEnd)
+                    lineEnd = chunk.end;
+
+                p = skipSpaces(p, lineEnd);
+                if (lineEnd - p >= 2 && p[0] == 'v' && isSpace(p[1]))
+                {
+                    p += 2;
+                    for (int i = 0; i < 3; ++i)
+                        chunk.positions.push_back(parseFloat(p, lineEnd));
+                }
+                else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isSpace(p[2]))
+                {
+                    p += 3;
+                    for (int i = 0; i < 3; ++i)
+                        chunk.normals.push_back(parseFloat(p, lineEnd));
+                }
+                else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isSpace(p[2]))
+                {
+                    p += 3;
+                    for (int i = 0; i < 2; ++i)
+                        chunk.texcoords.push_back(parseFloat(p, lineEnd));
+                }
+                else if (lineEnd - p >= 2 && p[0] == 'f' && isSpace(p[1]))
+                {
+                    chunk.ok = parseFace(chunk, p + 2, lineEnd);
+                }
+                p = lineEnd + 1;
+            }
+        }
+
+        // Teste de ponto em polígono (https://wrf.ecse.rpi.edu//Research/Short_Notes/pnpoly.html),
+        // idêntico ao usado pelo tinyobj.
+        int pnpoly(int nvert, const float *vertx, const float *verty, float testx, float testy)
+        {
+            int i, j, c = 0;
+            for (i = 0, j = nvert - 1; i < nvert; j = i++)
+            {
+                if (((verty[i] > testy) != (verty[j] > testy)) &&
+                    (testx < (vertx[j] - vertx[i]) * (testy - verty[i]) / (verty[j] - verty[i]) + vertx[i]))
+                    c = !c;
+            }
+            return c;
+        }
+
+        /**
+         * @brief Triangula uma face por "ear clipping", reproduzindo passo a passo o algoritmo
+         * do tinyobj (mesmos eixos de projeção, mesma ordem de teste das orelhas), para que os
+         * triângulos saiam na mesma ordem da leitura sequencial.
+         */
+        void triangulate(const ObjIndex *face, size_t npolys, const std::vector<float> &v, std::vector<ObjIndex> &out)
+        {
+            if (npolys < 3)
+                return; // Faces precisam de ao menos 3 vértices.
+            if (npolys == 3)
+            {
+                out.insert(out.end(), face, face + 3);
+                return;
+            }
+
+            // Encontra os dois eixos onde a face será projetada.
+            size_t axes[2] = {1, 2};
+            for (size_t k = 0; k < npolys; ++k)
+            {
+                size_t vi0 = size_t(face[(k + 0) % npolys].vertex);
+                size_t vi1 = size_t(face[(k + 1) % npolys].vertex);
+                size_t vi2 = size_t(face[(k + 2) % npolys].vertex);
+                if (((3 * vi0 + 2) >= v.size()) || ((3 * vi1 + 2) >= v.size()) || ((3 * vi2 + 2) >= v.size()))
+                    continue; // Triângulo inválido.
+
+                float e0x = v[vi1 * 3 + 0] - v[vi0 * 3 + 0];
+                float e0y = v[vi1 * 3 + 1] - v[vi0 * 3 + 1];
+                float e0z = v[vi1 * 3 + 2] - v[vi0 * 3 + 2];
+                float e1x = v[vi2 * 3 + 0] - v[vi1 * 3 + 0];
+                float e1y = v[vi2 * 3 + 1] - v[vi1 * 3 + 1];
+                float e1z = v[vi2 * 3 + 2] - v[vi1 * 3 + 2];
+                float cx = std::fabs(e0y * e1z - e0z * e1y);
+                float cy = std::fabs(e0z * e1x - e0x * e1z);
+                float cz = std::fabs(e0x * e1y - e0y * e1x);
+                const float epsilon = std::numeric_limits<float>::epsilon();
+                if (cx > epsilon || cy > epsilon || cz > epsilon)
+                {
+                    // Encontrou um canto.
+                    if (!(cx > cy && cx > cz))
+                    {
+                        axes[0] = 0;
+                        if (cz > cx && cz > cy)
+                            axes[1] = 1;
+                    }
+                    break;
+                }
+            }
+
+            float area = 0;
+            for (size_t k = 0; k < npolys; ++k)
+            {
+                size_t vi0 = size_t(face[(k + 0) % npolys].vertex);
+                size_t vi1 = size_t(face[(k + 1) % npolys].vertex);
+                if (((vi0 * 3 + axes[0]) >= v.size()) || ((vi0 * 3 + axes[1]) >= v.size()) ||
+                    ((vi1 * 3 + axes[0]) >= v.size()) || ((vi1 * 3 + axes[1]) >= v.size()))
+                    continue; // Índice inválido.
+                area += (v[vi0 * 3 + axes[0]] * v[vi1 * 3 + axes[1]] - v[vi0 * 3 + axes[1]] * v[vi1 * 3 + axes[0]]) * 0.5f;
+            }
+
+            std::vector<ObjIndex> remaining(face, face + npolys);
+            size_t guessVert = 0;
+            ObjIndex ind[3];
+            float vx[3];
+            float vy[3];
+            // Quantas iterações podemos fazer sem reduzir o número de vértices restantes.
+            size_t remainingIterations = npolys;
+            size_t previousRemaining = remaining.size();
+            while (remaining.size() > 3 && remainingIterations > 0)
+            {
+                npolys = remaining.size();
+                if (guessVert >= npolys)
+                    guessVert -= npolys;
+                if (previousRemaining != npolys)
+                {
+                    previousRemaining = npolys;
+                    remainingIterations = npolys;
+                }
+                else
+                {
+                    remainingIterations--;
+                }
+
+                for (size_t k = 0; k < 3; k++)
+                {
+                    ind[k] = remaining[(guessVert + k) % npolys];
+                    size_t vi = size_t(ind[k].vertex);
+                    if (((vi * 3 + axes[0]) >= v.size()) || ((vi * 3 + axes[1]) >= v.size()))
+                    {
+                        vx[k] = 0.0f;
+                        vy[k] = 0.0f;
+                    }
+                    else
+                    {
+                        vx[k] = v[vi * 3 + axes[0]];
+                        vy[k] = v[vi * 3 + axes[1]];
+                    }
+                }
+                float e0x = vx[1] - vx[0];
+                float e0y = vy[1] - vy[0];
+                float e1x = vx[2] - vx[1];
+                float e1y = vy[2] - vy[1];
+                float cross = e0x * e1y - e0y * e1x;
+                // Ângulo interno: não é uma orelha.
+                if (cross * area < 0.0f)
+                {
+                    guessVert += 1;
+                    continue;
+                }
+
+                // Verifica se algum outro vértice está dentro deste triângulo.
+                bool overlap = false;
+                for (size_t otherVert = 3; otherVert < npolys; ++otherVert)
+                {
+                    size_t idx = (guessVert + otherVert) % npolys;
+                    size_t ovi = size_t(remaining[idx].vertex);
+                    if (((ovi * 3 + axes[0]) >= v.size()) || ((ovi * 3 + axes[1]) >= v.size()))
+                        continue;
+                    if (pnpoly(3, vx, vy, v[ovi * 3 + axes[0]], v[ovi * 3 + axes[1]]))
+                    {
+                        overlap = true;
+                        break;
+                    }
+                }
+                if (overlap)
+                {
+                    guessVert += 1;
+                    continue;
+                }
+
+                // Este triângulo é uma orelha: emite-o e remove o vértice do meio.
+                out.push_back(ind[0]);
+                out.push_back(ind[1]);
+                out.push_back(ind[2]);
+                remaining.erase(remaining.begin() + (guessVert + 1) % npolys);
+            }
+            if (remaining.size() == 3)
+                out.insert(out.end(), remaining.begin(), remaining.end());
+        }
+
+        // Executa fn(i) para cada bloco, usando uma thread por bloco (o primeiro roda na thread atual).
+        template <typename F>
+        void forEachChunk(std::vector<Chunk> &chunks, F fn)
+        {
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < chunks.size(); ++i)
+                workers.emplace_back(fn, i);
+            fn(0);
+            for (std::thread &worker : workers)
+                worker.join();
+        }
+    }
+
+    bool parseObjParallel(const std::string &path, ObjGeometry &out, unsigned int threadCount)
+    {
+        MappedFile file(path);
+        if (!file.isOpen())
+            return false;
+
+        const char *data = reinterpret_cast<const char *>(file.data());
+        const char *end = data + file.size();
+
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, file.size() / MIN_CHUNK_BYTES));
+
+        // 1. Divide o arquivo em blocos de tamanho parecido, sempre no início de uma linha.
+        std::vector<Chunk> chunks(chunkCount);
+        const char *begin = data;
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            const char *split = (i + 1 == chunkCount) ? end : data + file.size() * (i + 1) / chunkCount;
+            if (split < begin)
+                split = begin;
+            while (split < end && split[-1] != '\n')
+                ++split;
+            chunks[i].begin = begin;
+            chunks[i].end = split;
+            begin = split;
+        }
+
+        // 2. Analisa os blocos em paralelo.
+        forEachChunk(chunks, [&](size_t i)
+                     { parseChunk(chunks[i]); });
+        for (const Chunk &chunk : chunks)
+        {
+            if (!chunk.ok)
+                return false;
+        }
+
+        // 3. Junta os atributos na ordem do arquivo, guardando o deslocamento de cada bloco.
+        std::vector<size_t> positionBase(chunkCount), normalBase(chunkCount), texcoordBase(chunkCount);
+        size_t positionTotal = 0, normalTotal = 0, texcoordTotal = 0;
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            positionBase[i] = positionTotal / 3;
+            normalBase[i] = normalTotal / 3;
+            texcoordBase[i] = texcoordTotal / 2;
+            positionTotal += chunks[i].positions.size();
+            normalTotal += chunks[i].normals.size();
+            texcoordTotal += chunks[i].texcoords.size();
+        }
+        out.positions.clear();
+        out.normals.clear();
+        out.texcoords.clear();
+        out.positions.reserve(positionTotal);
+        out.normals.reserve(normalTotal);
+        out.texcoords.reserve(texcoordTotal);
+        for (Chunk &chunk : chunks)
+        {
+            out.positions.insert(out.positions.end(), chunk.positions.begin(), chunk.positions.end());
+            out.normals.insert(out.normals.end(), chunk.normals.begin(), chunk.normals.end());
+            out.texcoords.insert(out.texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+            std::vector<float>().swap(chunk.positions);
+            std::vector<float>().swap(chunk.normals);
+            std::vector<float>().swap(chunk.texcoords);
+        }
+
+        // 4. Corrige os índices relativos e triangula as faces, novamente em paralelo.
+        forEachChunk(chunks, [&](size_t i)
+                     {
+                         Chunk &chunk = chunks[i];
+                         for (size_t c = 0; c < chunk.relative.size(); ++c)
+                         {
+                             if (chunk.relative[c] & RELATIVE_VERTEX)
+                                 chunk.corners[c].vertex += static_cast<int>(positionBase[i]);
+                             if (chunk.relative[c] & RELATIVE_TEXCOORD)
+                                 chunk.corners[c].texcoord += static_cast<int>(texcoordBase[i]);
+                             if (chunk.relative[c] & RELATIVE_NORMAL)
+                                 chunk.corners[c].normal += static_cast<int>(normalBase[i]);
+                         }
+                         chunk.triangles.reserve(chunk.corners.size() * 3 / 2);
+                         size_t first = 0;
+                         for (unsigned int faceSize : chunk.faceSizes)
+                         {
+                             triangulate(&chunk.corners[first], faceSize, out.positions, chunk.triangles);
+                             first += faceSize;
+                         } });
+
+        // 5. Concatena os triângulos na ordem dos blocos, que é a ordem do arquivo.
+        size_t triangleTotal = 0;
+        for (const Chunk &chunk : chunks)
+            triangleTotal += chunk.triangles.size();
+        out.indices.clear();
+        out.indices.reserve(triangleTotal);
+        for (const Chunk &chunk : chunks)
+            out.indices.insert(out.indices.end(), chunk.triangles.begin(), chunk.triangles.end());
+
+        // 6. Índices positivos além do fim dos atributos, ou relativos que voltam antes do início, invalidam o arquivo.
+        validateObjIndices(out, path);
+        return true;
+    }
+
+    void validateObjIndices(const ObjGeometry &geometry, const std::string &path)
+    {
+        // A marca de ausência só é aceita para normais e coordenadas de textura.
+        auto inRange = [](int index, size_t count, bool optional)
+        { return (optional && index == OBJ_INDEX_ABSENT) || (index >= 0 && static_cast<size_t>(index) < count); };
+
+        size_t positionCount = geometry.positions.size() / 3;
+        size_t normalCount = geometry.normals.size() / 3;
+        size_t texcoordCount = geometry.texcoords.size() / 2;
+        for (size_t i = 0; i < geometry.indices.size(); ++i)
+        {
+            const ObjIndex &index = geometry.indices[i];
+            if (!inRange(index.vertex, positionCount, false) || !inRange(index.normal, normalCount, true) ||
+                !inRange(index.texcoord, texcoordCount, true))
+            {
+                throw std::runtime_error("Indice de face fora do intervalo em " + path + " (triangulo " + std::to_string(i / 3) + ")");
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#include "worldgen/PageCache.hpp"
+#include <algorithm>
+
+namespace worldgen
+{
+    uint32_t VirtualTextureLayout::levelCount() const
+    {
+        uint32_t count = 1;
+        while ((pagesPerSide >> count) > 0)
+            ++count;
+        return count;
+    }
+
+    PageCache::PageCache(const VirtualTextureLayout &layout, uint32_t slotsPerSide)
+        : m_layout(layout), m_slotsPerSide(std::min(slotsPerSide, 256u)), m_slotOwners(m_slotsPerSide * m_slotsPerSide, NO_PAGE)
+    {
+    }
+
+    void PageCache::touch(PageId page, uint64_t frame)
+    {
+        auto it = m_pages.find(page.pack());
+        if (it != m_pages.end())
+            it->second.lastUsed = frame;
+    }
+
+    bool PageCache::insert(PageId page, uint64_t frame, uint32_t &slot, bool pinned)
+    {
+        uint32_t key = page.pack();
+        auto it = m_pages.find(key);
+        if (it != m_pages.end())
+        {
+            slot = it->second.slot;
+            return true;
+        }
+
+        // Um slot livre ou, senão, o da página vista há mais tempo (e não no último frame).
+        uint32_t best = NO_PAGE;
+        uint64_t bestUsed = frame > 0 ? frame - 1 : 0;
+        for (uint32_t i = 0; i < m_slotOwners.size(); ++i)
+        {
+            if (m_slotOwners[i] == NO_PAGE)
+            {
+                best = i;
+                break;
+            }
+            const Residency &owner = m_pages.at(m_slotOwners[i]);
+            if (!owner.pinned && owner.lastUsed < bestUsed)
+            {
+                best = i;
+                bestUsed = owner.lastUsed;
+            }
+        }
+        if (best == NO_PAGE)
+            return false;
+
+        if (m_slotOwners[best] != NO_PAGE)
+            m_pages.erase(m_slotOwners[best]);
+        m_slotOwners[best] = key;
+        m_pages[key] = {best, frame, pinned};
+        slot = best;
+        return true;
+    }
+
+    void PageCache::buildPageTable(std::vector<std::vector<PageTableEntry>> &tables) const
+    {
+        uint32_t levelCount = m_layout.levelCount();
+        tables.resize(levelCount);
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            uint32_t pages = m_layout.pagesAt(level);
+            std::vector<PageTableEntry> &table = tables[level];
+            table.assign(static_cast<size_t>(pages) * pages, PageTableEntry{0, 0, 0, 0});
+
+            for (uint32_t y = 0; y < pages; ++y)
+            {
+                for (uint32_t x = 0; x < pages; ++x)
+                {
+                    PageTableEntry &entry = table[y * pages + x];
+                    auto it = m_pages.find(PageId{level, x, y}.pack());
+                    if (it != m_pages.end())
+                    {
+                        uint32_t slot = it->second.slot;
+                        entry = {static_cast<uint8_t>(slot % m_slotsPerSide), static_cast<uint8_t>(slot / m_slotsPerSide), static_cast<uint8_t>(level), 1};
+                    }
+                    else if (level + 1 < levelCount)
+                    {
+                        uint32_t parentPages = m_layout.pagesAt(level + 1);
+                        entry = tables[level + 1][(y / 2) * parentPages + x / 2];
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<PageId> collectPageRequests(const uint32_t *feedback, size_t pixelCount, const VirtualTextureLayout &layout)
+    {
+        uint32_t levelCount = layout.levelCount();
+        std::unordered_map<uint32_t, uint32_t> counts;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            if (feedback[i] == NO_PAGE)
+                continue;
+            PageId page = PageId::unpack(feedback[i]);
+            if (page.level >= levelCount || page.x >= layout.pagesAt(page.level) || page.y >= layout.pagesAt(page.level))
+                continue;
+
+            // A página e toda a sua cadeia de ancestrais; os ancestrais herdam a contagem dos filhos.
+            while (true)
+            {
+                ++counts[page.pack()];
+                if (page.level + 1 >= levelCount)
+                    break;
+                page = page.parent();
+            }
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> sorted(counts.begin(), counts.end());
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b)
+                  {
+                      uint32_t levelA = a.first >> 28, levelB = b.first >> 28;
+                      if (levelA != levelB)
+                          return levelA > levelB;
+                      if (a.second != b.second)
+                          return a.second > b.second;
+                      return a.first < b.first; });
+
+        std::vector<PageId> requests;
+        requests.reserve(sorted.size());
+        for (const auto &entry : sorted)
+            requests.push_back(PageId::unpack(entry.first));
+        return requests;
+    }
+}
@@ -0,0 +1,256 @@
+#include "worldgen/Placement.hpp"
+#include "worldgen/Hash.hpp"
+#include "worldgen/PoissonDisk.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace worldgen
+{
+    InstanceData InstanceData::fromMatrix(const glm::mat4 &transform, uint32_t layer)
+    {
+        InstanceData instance;
+        instance.position = glm::vec3(transform[3]);
+        instance.layer = layer;
+
+        // O comprimento de cada coluna é a escala do eixo; sem ela, as colunas formam a rotação.
+        glm::vec3 axisScale(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])));
+        instance.scale = glm::vec2(axisScale.x, axisScale.y);
+        glm::mat3 rotation(glm::vec3(transform[0]) / axisScale.x, glm::vec3(transform[1]) / axisScale.y, glm::vec3(transform[2]) / axisScale.z);
+        glm::quat q = glm::normalize(glm::quat_cast(rotation));
+        const float components[4] = {q.x, q.y, q.z, q.w};
+        for (int i = 0; i < 4; ++i)
+            instance.rotation[i] = static_cast<int16_t>(std::round(glm::clamp(components[i], -1.0f, 1.0f) * 32767.0f));
+        return instance;
+    }
+
+    glm::mat4 InstanceData::matrix() const
+    {
+        glm::quat q = glm::normalize(glm::quat(rotation[3] / 32767.0f, rotation[0] / 32767.0f, rotation[1] / 32767.0f, rotation[2] / 32767.0f));
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(q);
+        return glm::scale(transform, glm::vec3(scale.x, scale.y, scale.x));
+    }
+
+    namespace
+    {
+        // Fração da densidade de um disco de Poisson máximo (cerca de 0.7 pontos por spacing²) que a
+        // amostragem de Bridson alcança; calibrada para que o número de instâncias fique perto do alvo.
+        const float POISSON_PACKING = 0.7f;
+        // Instâncias amostradas a mais, para que o descarte sempre chegue exatamente a 'count'.
+        const float OVERSAMPLING = 1.3f;
+        // Sorteios por semente até encontrar um ponto do filtro que as camadas anteriores não ocupam.
+        const int MAX_SEED_ATTEMPTS = 16;
+    }
+
+    std::vector<VegetationPlacement> placeVegetationLayers(const Heightfield &hf, const PlacementIndex &index,
+                                                           const std::vector<VegetationParams> &layers, unsigned int threadCount)
+    {
+        float halfWidth = hf.width / 2.0f;
+        float halfDepth = hf.depth / 2.0f;
+        glm::vec2 min(-halfWidth, -halfDepth), max(halfWidth - 1.0f, halfDepth - 1.0f);
+
+        // As camadas são distribuídas uma por vez, da mais esparsa (count em relação à área do filtro) à mais
+        // densa: as esparsas ocupam pouco espaço, e as densas preenchem o que sobra em volta delas.
+        std::vector<PlacementIndex::Selection> selections;
+        std::vector<size_t> order(layers.size());
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            selections.push_back(index.select(layers[l].filter()));
+            order[l] = l;
+        }
+        auto density = [&](size_t l)
+        { return selections[l].empty() ? 0.0 : std::max(layers[l].count, 0) / static_cast<double>(selections[l].size()); };
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return density(a) < density(b); });
+
+        std::vector<PoissonLayer> poissonLayers(layers.size());
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            poissonLayers[l].spacing = 0.0f;
+            poissonLayers[l].footprint = layers[l].footprint;
+            poissonLayers[l].stream = layers[l].stream;
+            poissonLayers[l].seed = layers[l].seed;
+        }
+
+        // Pontos da grade a menos de 'footprint' de uma instância já distribuída, e quantos deles passam no
+        // filtro de cada camada: a capacidade de uma camada sai sem percorrer o seu filtro de novo.
+        std::vector<uint8_t> claimed(static_cast<size_t>(hf.width) * hf.depth, 0);
+        std::vector<size_t> claimedInFilter(layers.size(), 0);
+        std::vector<bool> distributed(layers.size(), false);
+        auto claim = [&](const glm::vec2 &position, float radius)
+        {
+            float gridX = position.x + halfWidth, gridZ = position.y + halfDepth;
+            int x0 = std::max(0, static_cast<int>(std::ceil(gridX - radius))), x1 = std::min(hf.width - 1, static_cast<int>(std::floor(gridX + radius)));
+            int z0 = std::max(0, static_cast<int>(std::ceil(gridZ - radius))), z1 = std::min(hf.depth - 1, static_cast<int>(std::floor(gridZ + radius)));
+            for (int z = z0; z <= z1; ++z)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    size_t cell = static_cast<size_t>(z) * hf.width + x;
+                    float dx = x - gridX, dz = z - gridZ;
+                    if (claimed[cell] || dx * dx + dz * dz >= radius * radius)
+                        continue;
+                    claimed[cell] = 1;
+                    for (size_t other = 0; other < layers.size(); ++other)
+                    {
+                        if (!distributed[other] && layers[other].filter().accepts(hf.heights[cell], 1.0f - hf.normals[cell].y, index.biomeAt(x, z)))
+                            ++claimedInFilter[other];
+                    }
+                }
+            }
+        };
+
+        std::vector<VegetationPlacement> result(layers.size());
+        std::vector<std::vector<PoissonSample>> samples(layers.size());
+        for (size_t l : order)
+        {
+            const VegetationParams &params = layers[l];
+            const PlacementIndex::Selection &selection = selections[l];
+            distributed[l] = true;
+            size_t capacity = selection.size() - claimedInFilter[l];
+
+            size_t target = std::min(static_cast<size_t>(std::max(params.count, 0)), capacity);
+
+            PoissonLayer &layer = poissonLayers[l];
+            PlacementFilter filter = params.filter();
+            layer.accept = [&hf, &index, halfWidth, halfDepth, filter](const glm::vec2 &position)
+            {
+                float gridX = position.x + halfWidth, gridZ = position.y + halfDepth;
+                int x = static_cast<int>(std::round(gridX)), z = static_cast<int>(std::round(gridZ));
+                return filter.accepts(hf.getInterpolatedHeight(gridX, gridZ), 1.0f - hf.getNormal(x, z).y, index.biomeAt(x, z));
+            };
+
+            // Amostra a camada para 'goal' instâncias (e um pouco mais), com sementes em pontos do filtro sorteados
+            // e rejeitados se já ocupados (cellX = -1 não coincide com nenhum ladrilho da amostragem).
+            auto sample = [&](size_t goal)
+            {
+                // Espaçamento <= 0: camada vazia, ignorada pela amostragem. Cada ponto da grade conta uma unidade².
+                float sampled = goal * OVERSAMPLING;
+                layer.spacing = goal > 0 ? std::sqrt(POISSON_PACKING * capacity / sampled) : 0.0f;
+                layer.seeds.clear();
+                if (goal == 0)
+                    return std::vector<PoissonSample>();
+                size_t seedCount = static_cast<size_t>(std::ceil(sampled));
+                layer.seeds.reserve(seedCount);
+                for (size_t i = 0; i < seedCount; ++i)
+                {
+                    for (int attempt = 0; attempt < MAX_SEED_ATTEMPTS; ++attempt)
+                    {
+                        RandomBlock random = counterRandom(params.seed, params.stream, -1, -1 - attempt, static_cast<uint32_t>(i));
+                        glm::ivec2 cell = selection[random.below(0, static_cast<uint32_t>(selection.size()))];
+                        if (claimed[static_cast<size_t>(cell.y) * hf.width + cell.x])
+                            continue;
+                        float worldX = cell.x + random.uniform(1) - 0.5f - halfWidth;
+                        float worldZ = cell.y + random.uniform(2) - 0.5f - halfDepth;
+                        layer.seeds.push_back(glm::vec2(glm::clamp(worldX, min.x, max.x), glm::clamp(worldZ, min.y, max.y)));
+                        break;
+                    }
+                }
+                return std::move(samplePoissonDisk(min, max, poissonLayers, threadCount)[l]);
+            };
+
+            std::vector<PoissonSample> &layerSamples = samples[l];
+            size_t goal = target;
+            layerSamples = sample(goal);
+            // Faltaram instâncias: o espaço livre está fragmentado entre as outras camadas. A camada é refeita
+            // com o dobro do objetivo (o custo total continua proporcional ao último) até chegar ao alvo; se nem
+            // a amostragem mais densa chegar, o máximo real é o que ela alcança.
+            while (layerSamples.size() < target && goal < capacity)
+            {
+                goal = std::min(capacity, 2 * goal);
+                layerSamples = sample(goal);
+            }
+            if (layerSamples.size() < target)
+            {
+                capacity = std::min(capacity, layerSamples.size());
+                target = capacity;
+            }
+            result[l].capacity = capacity;
+
+            // Descarte uniforme: ficam as amostras com os menores bits[3], na ordem original.
+            if (layerSamples.size() > target)
+            {
+                std::vector<uint32_t> kept(layerSamples.size());
+                for (uint32_t i = 0; i < kept.size(); ++i)
+                    kept[i] = i;
+                auto before = [&](uint32_t a, uint32_t b)
+                {
+                    uint32_t ka = layerSamples[a].random.bits[3], kb = layerSamples[b].random.bits[3];
+                    return ka != kb ? ka < kb : a < b;
+                };
+                std::nth_element(kept.begin(), kept.begin() + target, kept.end(), before);
+                kept.resize(target);
+                std::sort(kept.begin(), kept.end());
+                std::vector<PoissonSample> thinned;
+                thinned.reserve(kept.size());
+                for (uint32_t i : kept)
+                    thinned.push_back(layerSamples[i]);
+                layerSamples.swap(thinned);
+            }
+
+            // A camada passa a só ocupar espaço nas próximas amostragens.
+            layer.spacing = 0.0f;
+            layer.accept = nullptr;
+            std::vector<glm::vec2>().swap(layer.seeds);
+            for (const PoissonSample &sample : layerSamples)
+            {
+                layer.placed.push_back(sample.position);
+                claim(sample.position, layer.footprint);
+            }
+        }
+
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            const VegetationParams &params = layers[l];
+            const std::vector<PoissonSample> &layerSamples = samples[l];
+
+            std::vector<glm::mat4> &transforms = result[l].transforms;
+            transforms.reserve(layerSamples.size()); // Pré-aloca memória para evitar realocações.
+            for (const PoissonSample &sample : layerSamples)
+            {
+                float worldX = sample.position.x;
+                float worldZ = sample.position.y;
+                float gridX = worldX + halfWidth;
+                float gridZ = worldZ + halfDepth;
+                float height = hf.getInterpolatedHeight(gridX, gridZ);
+
+                // Alinha o vetor "para cima" do modelo com a normal do terreno usando quaterniões.
+                glm::vec3 normal = hf.getNormal(static_cast<int>(std::round(gridX)), static_cast<int>(std::round(gridZ)));
+                glm::quat rotationQuat = glm::rotation(params.modelUp, normal);
+                glm::mat4 rotationMatrix = glm::toMat4(rotationQuat);
+
+                // Adiciona uma rotação aleatória em torno do eixo "para cima" para variar a orientação.
+                float randomYaw = glm::radians(sample.random.uniform(2) * 360.0f);
+                rotationMatrix = glm::rotate(rotationMatrix, randomYaw, params.modelUp);
+
+                // Matriz de modelo final: translação, rotação (alinhamento + aleatória) e escala.
+                glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(worldX, height, worldZ));
+                modelMatrix = modelMatrix * rotationMatrix;
+                modelMatrix = glm::scale(modelMatrix, glm::vec3(params.scale));
+
+                transforms.push_back(modelMatrix);
+            }
+        }
+        return result;
+    }
+
+    std::vector<glm::mat4> placeVegetation(const Heightfield &hf, const VegetationParams &params)
+    {
+        return placeVegetationLayers(hf, PlacementIndex(hf), {params}).front().transforms;
+    }
+
+    std::vector<InstanceData> assignVariants(const std::vector<glm::mat4> &transforms, uint32_t layerCount)
+    {
+        std::vector<InstanceData> instances;
+        instances.reserve(transforms.size());
+        for (const glm::mat4 &transform : transforms)
+        {
+            glm::vec3 position(transform[3]);
+            uint32_t layer = layerCount > 1 ? static_cast<uint32_t>(hashBytes(&position, sizeof(position)) % layerCount) : 0;
+            instances.push_back(InstanceData::fromMatrix(transform, layer));
+        }
+        return instances;
+    }
+}
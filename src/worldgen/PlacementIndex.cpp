@@ -0,0 +1,134 @@
+#include "worldgen/PlacementIndex.hpp"
+#include "worldgen/TerrainSurface.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace worldgen
+{
+    PlacementIndex::PlacementIndex(const Heightfield &hf, float amplitude, float bandHeight)
+        : m_width(hf.width), m_depth(hf.depth), m_bandHeight(bandHeight)
+    {
+        size_t cellCount = static_cast<size_t>(hf.width) * hf.depth;
+        float maxHeight = 0.0f;
+        m_minHeight = 0.0f;
+        if (cellCount > 0)
+        {
+            auto range = std::minmax_element(hf.heights.begin(), hf.heights.end());
+            m_minHeight = *range.first;
+            maxHeight = *range.second;
+        }
+        m_bandCount = static_cast<int>((maxHeight - m_minHeight) / m_bandHeight) + 1;
+
+        // Grupo de cada ponto e, com uma contagem por grupo, a posição de cada um na ordem final.
+        std::vector<uint32_t> bucketOfCell(cellCount);
+        m_biomes.resize(cellCount);
+        m_bucketStart.assign(static_cast<size_t>(m_bandCount) * SLOPE_BANDS * BIOME_COUNT + 1, 0);
+        for (size_t cell = 0; cell < cellCount; ++cell)
+        {
+            float height = hf.heights[cell];
+            float slope = 1.0f - hf.normals[cell].y;
+            glm::vec3 weights = surfaceWeights((height / amplitude + 1.0f) / 2.0f, slope);
+            Biome biome = weights.z >= weights.x && weights.z >= weights.y ? Biome::Rock : (weights.y >= weights.x ? Biome::Grass : Biome::Sand);
+            m_biomes[cell] = biome;
+            bucketOfCell[cell] = static_cast<uint32_t>(bucketOf(bandOf(height), slopeBandOf(slope), biome));
+            ++m_bucketStart[bucketOfCell[cell] + 1];
+        }
+        for (size_t bucket = 1; bucket < m_bucketStart.size(); ++bucket)
+            m_bucketStart[bucket] += m_bucketStart[bucket - 1];
+
+        m_cells.resize(cellCount);
+        m_heights.resize(cellCount);
+        m_slopes.resize(cellCount);
+        std::vector<uint32_t> next(m_bucketStart.begin(), m_bucketStart.end() - 1);
+        for (size_t cell = 0; cell < cellCount; ++cell)
+        {
+            uint32_t slot = next[bucketOfCell[cell]]++;
+            m_cells[slot] = static_cast<uint32_t>(cell);
+            m_heights[slot] = hf.heights[cell];
+            m_slopes[slot] = 1.0f - hf.normals[cell].y;
+        }
+    }
+
+    int PlacementIndex::bandOf(float height) const
+    {
+        int band = static_cast<int>(std::floor((height - m_minHeight) / m_bandHeight));
+        return std::max(0, std::min(m_bandCount - 1, band));
+    }
+
+    int PlacementIndex::slopeBandOf(float slope)
+    {
+        int band = static_cast<int>(slope * SLOPE_BANDS);
+        return std::max(0, std::min(SLOPE_BANDS - 1, band));
+    }
+
+    Biome PlacementIndex::biomeAt(int x, int z) const
+    {
+        x = std::max(0, std::min(m_width - 1, x));
+        z = std::max(0, std::min(m_depth - 1, z));
+        return m_biomes[static_cast<size_t>(z) * m_width + x];
+    }
+
+    PlacementIndex::Selection PlacementIndex::select(const PlacementFilter &filter) const
+    {
+        Selection selection;
+        selection.m_index = this;
+        if (m_cells.empty() || filter.minHeight > filter.maxHeight)
+            return selection;
+
+        int firstBand = bandOf(filter.minHeight), lastBand = bandOf(filter.maxHeight);
+        int lastSlopeBand = slopeBandOf(filter.maxSlope);
+        for (int band = firstBand; band <= lastBand; ++band)
+        {
+            // Um grupo entra inteiro se a sua faixa de altura e a de inclinação estiverem dentro do filtro.
+            float bandMin = m_minHeight + band * m_bandHeight;
+            bool bandInside = bandMin >= filter.minHeight && bandMin + m_bandHeight <= filter.maxHeight;
+            for (int slopeBand = 0; slopeBand <= lastSlopeBand; ++slopeBand)
+            {
+                bool slopeInside = static_cast<float>(slopeBand + 1) / SLOPE_BANDS <= filter.maxSlope;
+                for (int b = 0; b < BIOME_COUNT; ++b)
+                {
+                    Biome biome = static_cast<Biome>(b);
+                    if ((filter.biomes & biomeBit(biome)) == 0)
+                        continue;
+                    size_t bucket = bucketOf(band, slopeBand, biome);
+                    uint32_t begin = m_bucketStart[bucket], end = m_bucketStart[bucket + 1];
+                    if (begin == end)
+                        continue;
+                    if (bandInside && slopeInside)
+                    {
+                        selection.m_size += end - begin;
+                        selection.m_rangeBegin.push_back(begin);
+                        selection.m_rangeEnd.push_back(selection.m_size);
+                    }
+                    else
+                    {
+                        for (uint32_t i = begin; i < end; ++i)
+                        {
+                            if (filter.accepts(m_heights[i], m_slopes[i], biome))
+                                selection.m_partial.push_back(m_cells[i]);
+                        }
+                    }
+                }
+            }
+        }
+        selection.m_size += selection.m_partial.size();
+        return selection;
+    }
+
+    glm::ivec2 PlacementIndex::Selection::operator[](size_t i) const
+    {
+        uint32_t cell;
+        size_t rangeTotal = m_rangeEnd.empty() ? 0 : m_rangeEnd.back();
+        if (i >= rangeTotal)
+        {
+            cell = m_partial[i - rangeTotal];
+        }
+        else
+        {
+            size_t range = std::upper_bound(m_rangeEnd.begin(), m_rangeEnd.end(), i) - m_rangeEnd.begin();
+            size_t rangeStart = range > 0 ? m_rangeEnd[range - 1] : 0;
+            cell = m_index->m_cells[m_rangeBegin[range] + (i - rangeStart)];
+        }
+        return glm::ivec2(static_cast<int>(cell % m_index->m_width), static_cast<int>(cell / m_index->m_width));
+    }
+}
@@ -0,0 +1,211 @@
+#include "worldgen/PoissonDisk.hpp"
+#include <cmath>
+#include <thread>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Lado de um ladrilho, em células do SpatialHash.
+        const int TILE_CELLS = 4;
+        // Candidatos tentados em volta de um ponto ativo antes de desistir dele (o k de Bridson).
+        const int CANDIDATES_PER_POINT = 30;
+        const float TWO_PI = 6.28318530718f;
+
+        struct Tile
+        {
+            glm::ivec2 coord;
+            glm::vec2 min;
+            glm::vec2 max;
+            std::vector<std::vector<PoissonSample>> samples; // Uma lista por camada.
+            std::vector<std::vector<glm::vec2>> seeds;       // Os PoissonLayer::seeds que caem no ladrilho, por camada.
+        };
+
+        /**
+         * @brief Bridson restrito a um ladrilho, para a camada 'layerIndex'.
+         * Os candidatos fora do ladrilho são descartados: os ladrilhos vizinhos, processados em
+         * outra fase, preenchem o espaço respeitando os pontos deste.
+         */
+        void sampleTile(Tile &tile, const std::vector<PoissonLayer> &layers, uint32_t layerIndex, SpatialHash &hash)
+        {
+            const PoissonLayer &layer = layers[layerIndex];
+            uint32_t counter = 0;
+            auto next = [&]()
+            { return counterRandom(layer.seed, layer.stream, tile.coord.x, tile.coord.y, counter++); };
+
+            std::vector<glm::vec2> active;
+            auto tryAccept = [&](const glm::vec2 &position, const RandomBlock &random)
+            {
+                if (position.x < tile.min.x || position.y < tile.min.y || position.x >= tile.max.x || position.y >= tile.max.y)
+                    return false;
+                if (!layer.accept(position))
+                    return false;
+                bool blocked = hash.anyNear(position, [&](const PoissonSample &other)
+                                            {
+                    float distance = other.layer == layerIndex ? layer.spacing : std::max(layer.footprint, layers[other.layer].footprint);
+                    glm::vec2 delta = other.position - position;
+                    return glm::dot(delta, delta) < distance * distance; });
+                if (blocked)
+                    return false;
+
+                PoissonSample sample{position, layerIndex, random};
+                hash.insert(sample);
+                tile.samples[layerIndex].push_back(sample);
+                active.push_back(position);
+                return true;
+            };
+
+            // Sementes: as da camada ou lançamentos em número proporcional à área do ladrilho, para alcançar
+            // também as regiões aceitas isoladas, que a expansão a partir de um único ponto não atingiria.
+            if (!layer.seeds.empty())
+            {
+                for (const glm::vec2 &seed : tile.seeds[layerIndex])
+                    tryAccept(seed, next());
+            }
+            else
+            {
+                glm::vec2 size = tile.max - tile.min;
+                int seeds = std::max(1, static_cast<int>(size.x * size.y / (layer.spacing * layer.spacing)));
+                for (int i = 0; i < seeds; ++i)
+                {
+                    RandomBlock random = next();
+                    tryAccept(tile.min + glm::vec2(random.uniform(0), random.uniform(1)) * size, random);
+                }
+            }
+
+            // Expansão: candidatos no anel [spacing, 2 * spacing] em volta de um ponto ativo qualquer.
+            while (!active.empty())
+            {
+                size_t index = next().below(0, static_cast<uint32_t>(active.size()));
+                glm::vec2 center = active[index];
+                bool found = false;
+                for (int k = 0; k < CANDIDATES_PER_POINT && !found; ++k)
+                {
+                    RandomBlock random = next();
+                    float angle = random.uniform(0) * TWO_PI;
+                    float distance = layer.spacing * (1.0f + random.uniform(1));
+                    found = tryAccept(center + distance * glm::vec2(std::cos(angle), std::sin(angle)), random);
+                }
+                if (!found)
+                {
+                    active[index] = active.back();
+                    active.pop_back();
+                }
+            }
+        }
+    }
+
+    SpatialHash::SpatialHash(const glm::vec2 &min, const glm::vec2 &max, float cellSize)
+        : m_min(min), m_cellSize(cellSize)
+    {
+        m_columns = std::max(1, static_cast<int>(std::ceil((max.x - min.x) / cellSize)));
+        m_rows = std::max(1, static_cast<int>(std::ceil((max.y - min.y) / cellSize)));
+        m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+    }
+
+    glm::ivec2 SpatialHash::cellOf(const glm::vec2 &position) const
+    {
+        int x = static_cast<int>(std::floor((position.x - m_min.x) / m_cellSize));
+        int z = static_cast<int>(std::floor((position.y - m_min.y) / m_cellSize));
+        return glm::ivec2(std::max(0, std::min(m_columns - 1, x)), std::max(0, std::min(m_rows - 1, z)));
+    }
+
+    void SpatialHash::insert(const PoissonSample &sample)
+    {
+        glm::ivec2 cell = cellOf(sample.position);
+        m_cells[cell.y * m_columns + cell.x].push_back(sample);
+    }
+
+    std::vector<std::vector<PoissonSample>> samplePoissonDisk(const glm::vec2 &min, const glm::vec2 &max, const std::vector<PoissonLayer> &layers,
+                                                             unsigned int threadCount)
+    {
+        std::vector<std::vector<PoissonSample>> result(layers.size());
+
+        // As células cobrem a maior distância de conflito entre quaisquer duas camadas.
+        float cellSize = 0.0f;
+        bool sampling = false;
+        for (const PoissonLayer &layer : layers)
+        {
+            if (layer.spacing > 0.0f)
+                cellSize = std::max(cellSize, std::max(layer.spacing, layer.footprint));
+            if (!layer.placed.empty())
+                cellSize = std::max(cellSize, layer.footprint);
+            sampling = sampling || layer.spacing > 0.0f;
+        }
+        if (!sampling || cellSize <= 0.0f)
+            return result;
+        SpatialHash hash(min, max, cellSize);
+        for (uint32_t layer = 0; layer < layers.size(); ++layer)
+        {
+            for (const glm::vec2 &position : layers[layer].placed)
+                hash.insert(PoissonSample{position, layer, RandomBlock{}});
+        }
+
+        float tileSize = cellSize * TILE_CELLS;
+        int columns = std::max(1, static_cast<int>(std::ceil((max.x - min.x) / tileSize)));
+        int rows = std::max(1, static_cast<int>(std::ceil((max.y - min.y) / tileSize)));
+        std::vector<Tile> tiles(static_cast<size_t>(columns) * rows);
+        for (int z = 0; z < rows; ++z)
+        {
+            for (int x = 0; x < columns; ++x)
+            {
+                Tile &tile = tiles[z * columns + x];
+                tile.coord = glm::ivec2(x, z);
+                tile.min = min + glm::vec2(x, z) * tileSize;
+                tile.max = glm::vec2(std::min(tile.min.x + tileSize, max.x), std::min(tile.min.y + tileSize, max.y));
+                tile.samples.resize(layers.size());
+                tile.seeds.resize(layers.size());
+            }
+        }
+        for (size_t layer = 0; layer < layers.size(); ++layer)
+        {
+            for (const glm::vec2 &seed : layers[layer].seeds)
+            {
+                int x = std::max(0, std::min(columns - 1, static_cast<int>(std::floor((seed.x - min.x) / tileSize))));
+                int z = std::max(0, std::min(rows - 1, static_cast<int>(std::floor((seed.y - min.y) / tileSize))));
+                tiles[z * columns + x].seeds[layer].push_back(seed);
+            }
+        }
+
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        // Quatro fases pela paridade (x, z) do ladrilho; em cada uma, os ladrilhos são divididos entre as threads.
+        for (int phase = 0; phase < 4; ++phase)
+        {
+            std::vector<Tile *> phaseTiles;
+            for (Tile &tile : tiles)
+            {
+                if ((tile.coord.x & 1) == (phase & 1) && (tile.coord.y & 1) == (phase >> 1))
+                    phaseTiles.push_back(&tile);
+            }
+
+            auto work = [&](size_t worker, size_t workerCount)
+            {
+                for (size_t i = worker; i < phaseTiles.size(); i += workerCount)
+                {
+                    for (uint32_t layer = 0; layer < layers.size(); ++layer)
+                    {
+                        if (layers[layer].spacing > 0.0f)
+                            sampleTile(*phaseTiles[i], layers, layer, hash);
+                    }
+                }
+            };
+            size_t workerCount = std::min<size_t>(threadCount, phaseTiles.size());
+            std::vector<std::thread> workers;
+            for (size_t worker = 1; worker < workerCount; ++worker)
+                workers.emplace_back(work, worker, workerCount);
+            work(0, std::max<size_t>(workerCount, 1));
+            for (std::thread &worker : workers)
+                worker.join();
+        }
+
+        // A ordem dos ladrilhos é fixa: o resultado é o mesmo com qualquer número de threads.
+        for (const Tile &tile : tiles)
+        {
+            for (size_t layer = 0; layer < layers.size(); ++layer)
+                result[layer].insert(result[layer].end(), tile.samples[layer].begin(), tile.samples[layer].end());
+        }
+        return result;
+    }
+}
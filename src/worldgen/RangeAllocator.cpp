@@ -0,0 +1,72 @@
+#include "worldgen/RangeAllocator.hpp"
+#include <cassert>
+#include <iterator>
+
+namespace worldgen
+{
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+    {
+        grow(capacity);
+    }
+
+    uint32_t RangeAllocator::allocate(uint32_t size)
+    {
+        if (size == 0)
+            return 0;
+
+        for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end(); ++it)
+        {
+            if (it->second < size)
+                continue;
+
+            uint32_t offset = it->first;
+            uint32_t remaining = it->second - size;
+            m_freeBlocks.erase(it);
+            if (remaining > 0)
+                m_freeBlocks.emplace(offset + size, remaining);
+            m_used += size;
+            return offset;
+        }
+        return INVALID_OFFSET;
+    }
+
+    void RangeAllocator::free(uint32_t offset, uint32_t size)
+    {
+        if (size == 0)
+            return;
+        assert(offset + size <= m_capacity && size <= m_used);
+        m_used -= size;
+
+        // Funde com o bloco livre seguinte, se ele começar exatamente onde este termina.
+        auto next = m_freeBlocks.lower_bound(offset);
+        if (next != m_freeBlocks.end() && next->first == offset + size)
+        {
+            size += next->second;
+            next = m_freeBlocks.erase(next);
+        }
+
+        // Funde com o bloco livre anterior, se ele terminar exatamente onde este começa.
+        if (next != m_freeBlocks.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset)
+            {
+                previous->second += size;
+                return;
+            }
+        }
+        m_freeBlocks.emplace(offset, size);
+    }
+
+    void RangeAllocator::grow(uint32_t newCapacity)
+    {
+        if (newCapacity <= m_capacity)
+            return;
+
+        uint32_t oldCapacity = m_capacity;
+        m_capacity = newCapacity;
+        // O espaço novo é tratado como um intervalo liberado, para se fundir com um bloco livre no fim.
+        m_used += newCapacity - oldCapacity;
+        free(oldCapacity, newCapacity - oldCapacity);
+    }
+}
@@ -0,0 +1,54 @@
+#include "worldgen/TaskPool.hpp"
+#include <algorithm>
+
+namespace worldgen
+{
+    TaskPool::TaskPool(unsigned int threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int i = 0; i < threadCount; ++i)
+            m_threads.emplace_back(&TaskPool::workerLoop, this);
+    }
+
+    TaskPool::~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_tasks.clear();
+        }
+        m_wakeUp.notify_all();
+        for (std::thread &thread : m_threads)
+            thread.join();
+    }
+
+    void TaskPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping)
+                return;
+            m_tasks.push_back(std::move(task));
+        }
+        m_wakeUp.notify_one();
+    }
+
+    void TaskPool::workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeUp.wait(lock, [this]
+                              { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping)
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
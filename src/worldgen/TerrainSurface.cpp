@@ -0,0 +1,115 @@
+#include "worldgen/TerrainSurface.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Cor de um texel da imagem, com as coordenadas repetidas (GL_REPEAT).
+        glm::vec3 texelAt(const RgbaImage &image, int x, int y)
+        {
+            int width = static_cast<int>(image.width), height = static_cast<int>(image.height);
+            x = ((x % width) + width) % width;
+            y = ((y % height) + height) % height;
+            const uint8_t *p = &image.pixels[(static_cast<size_t>(y) * image.width + x) * 4];
+            return glm::vec3(p[0], p[1], p[2]);
+        }
+    }
+
+    glm::vec3 surfaceWeights(float heightNormalized, float slope)
+    {
+        // A mesma mistura em duas etapas do antigo terrain.frag.
+        float grass = glm::smoothstep(0.20f, 0.50f, heightNormalized);
+        float slopeFactor = glm::smoothstep(0.3f, 0.6f, slope);
+        float rockHeightFactor = glm::smoothstep(0.6f, 0.8f, heightNormalized);
+        float rock = std::clamp(rockHeightFactor + slopeFactor, 0.0f, 1.0f);
+        return glm::vec3((1.0f - grass) * (1.0f - rock), grass * (1.0f - rock), rock);
+    }
+
+    TerrainSurface::TerrainSurface(std::shared_ptr<const Heightfield> heightfield, const TerrainSurfaceParams &params)
+        : m_heightfield(std::move(heightfield)), m_amplitude(params.amplitude),
+          m_sand(loadLayer(params.sandPath, params.sandTiling)),
+          m_grass(loadLayer(params.grassPath, params.grassTiling)),
+          m_rock(loadLayer(params.rockPath, params.rockTiling))
+    {
+    }
+
+    TerrainSurface::Layer TerrainSurface::loadLayer(const std::string &path, float tiling) const
+    {
+        Layer layer;
+        layer.tiling = tiling;
+        layer.mips.push_back(toRgba(loadImage(path)));
+        if (layer.mips[0].pixels.empty())
+            throw std::runtime_error("Falha ao carregar a textura do terreno: " + path);
+        while (layer.mips.back().width > 1 || layer.mips.back().height > 1)
+            layer.mips.push_back(downsample(layer.mips.back()));
+        return layer;
+    }
+
+    glm::vec3 TerrainSurface::sampleLayer(const Layer &layer, glm::vec2 uv, float texelsPerPixel) const
+    {
+        int mip = texelsPerPixel > 1.0f ? static_cast<int>(std::log2(texelsPerPixel) + 0.5f) : 0;
+        const RgbaImage &image = layer.mips[std::min<size_t>(mip, layer.mips.size() - 1)];
+
+        float x = uv.x * layer.tiling * image.width - 0.5f;
+        float y = uv.y * layer.tiling * image.height - 0.5f;
+        int x0 = static_cast<int>(std::floor(x)), y0 = static_cast<int>(std::floor(y));
+        float fx = x - x0, fy = y - y0;
+        glm::vec3 top = glm::mix(texelAt(image, x0, y0), texelAt(image, x0 + 1, y0), fx);
+        glm::vec3 bottom = glm::mix(texelAt(image, x0, y0 + 1), texelAt(image, x0 + 1, y0 + 1), fx);
+        return glm::mix(top, bottom, fy);
+    }
+
+    RgbaImage TerrainSurface::composePage(const VirtualTextureLayout &layout, PageId page) const
+    {
+        const Heightfield &hf = *m_heightfield;
+        float levelSize = static_cast<float>(layout.pageSize * layout.pagesAt(page.level));
+        uint32_t slotSize = layout.slotSize();
+
+        // Quantos texels de cada textura de origem cabem num texel da página.
+        float sandDensity = m_sand.tiling * m_sand.mips[0].width / levelSize;
+        float grassDensity = m_grass.tiling * m_grass.mips[0].width / levelSize;
+        float rockDensity = m_rock.tiling * m_rock.mips[0].width / levelSize;
+
+        RgbaImage result;
+        result.width = result.height = slotSize;
+        result.pixels.resize(static_cast<size_t>(slotSize) * slotSize * 4);
+
+        for (uint32_t py = 0; py < slotSize; ++py)
+        {
+            for (uint32_t px = 0; px < slotSize; ++px)
+            {
+                // Centro do texel na textura virtual; a borda lê as páginas vizinhas.
+                glm::vec2 texel(page.x * layout.pageSize + static_cast<float>(px) - layout.border + 0.5f,
+                                page.y * layout.pageSize + static_cast<float>(py) - layout.border + 0.5f);
+                glm::vec2 uv(std::clamp(texel.x / levelSize, 0.0f, 1.0f), std::clamp(texel.y / levelSize, 0.0f, 1.0f));
+
+                // Altura e normal interpoladas entre os pontos da grade, como na malha (TexCoords = x / width).
+                float gx = std::min(uv.x * hf.width, hf.width - 1.0f), gz = std::min(uv.y * hf.depth, hf.depth - 1.0f);
+                int x0 = static_cast<int>(gx), z0 = static_cast<int>(gz);
+                float fx = gx - x0, fz = gz - z0;
+                float height = glm::mix(glm::mix(hf.getHeight(x0, z0), hf.getHeight(x0 + 1, z0), fx),
+                                        glm::mix(hf.getHeight(x0, z0 + 1), hf.getHeight(x0 + 1, z0 + 1), fx), fz);
+                glm::vec3 normal = glm::normalize(glm::mix(glm::mix(hf.getNormal(x0, z0), hf.getNormal(x0 + 1, z0), fx),
+                                                           glm::mix(hf.getNormal(x0, z0 + 1), hf.getNormal(x0 + 1, z0 + 1), fx), fz));
+
+                glm::vec3 sandColor = sampleLayer(m_sand, uv, sandDensity);
+                glm::vec3 grassColor = sampleLayer(m_grass, uv, grassDensity);
+                glm::vec3 rockColor = sampleLayer(m_rock, uv, rockDensity);
+
+                float heightNormalized = (height / m_amplitude + 1.0f) / 2.0f;
+                glm::vec3 weights = surfaceWeights(heightNormalized, 1.0f - normal.y);
+                glm::vec3 color = sandColor * weights.x + grassColor * weights.y + rockColor * weights.z;
+
+                uint8_t *dst = &result.pixels[(static_cast<size_t>(py) * slotSize + px) * 4];
+                dst[0] = static_cast<uint8_t>(std::clamp(color.r + 0.5f, 0.0f, 255.0f));
+                dst[1] = static_cast<uint8_t>(std::clamp(color.g + 0.5f, 0.0f, 255.0f));
+                dst[2] = static_cast<uint8_t>(std::clamp(color.b + 0.5f, 0.0f, 255.0f));
+                dst[3] = 255;
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,171 @@
+#include "worldgen/TextureCache.hpp"
+#include "worldgen/Hash.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace worldgen
+{
+    namespace
+    {
+        const char TEXTURE_CACHE_MAGIC[4] = {'W', 'G', 'T', 'C'};
+        const uint32_t TEXTURE_CACHE_VERSION = 1;
+        const uint32_t MAX_TEXTURE_LEVELS = 32;
+
+        // Cabeçalho do arquivo de cache. Logo depois vêm a tabela de níveis e os blocos comprimidos.
+        struct TextureCacheHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t format;        // BlockFormat.
+            uint32_t width;
+            uint32_t height;
+            uint32_t levelCount;
+            uint64_t sourceSize;    // Tamanho da imagem de origem.
+            uint64_t sourceMtimeNs; // Data de modificação da imagem de origem.
+            uint64_t sourceHash;    // Hash do conteúdo da imagem de origem.
+            uint64_t dataSize;      // Bytes de blocos comprimidos, somando todos os níveis.
+            uint64_t payloadHash;   // Hash da tabela de níveis e dos blocos, para detectar arquivos corrompidos.
+        };
+        static_assert(sizeof(TextureCacheHeader) == 64, "O cabeçalho do cache deve ter 64 bytes");
+        static_assert(sizeof(TextureLevel) == 24, "O cache assume uma struct TextureLevel compacta de 24 bytes");
+
+        uint64_t hashFile(const std::string &path)
+        {
+            MappedFile file(path);
+            return file.isOpen() ? hashBytes(file.data(), file.size()) : 0;
+        }
+
+        bool isValidFormat(uint32_t format)
+        {
+            return blockBytes(static_cast<BlockFormat>(format)) != 0;
+        }
+
+        // Verifica o cabeçalho, a tabela de níveis e os tamanhos; devolve o cabeçalho através de 'out'.
+        bool validateCache(const MappedFile &cache, const std::string &imagePath, const FileStamp &source, TextureCacheHeader &out)
+        {
+            if (!cache.isOpen() || cache.size() < sizeof(TextureCacheHeader))
+                return false;
+
+            std::memcpy(&out, cache.data(), sizeof(TextureCacheHeader));
+            if (std::memcmp(out.magic, TEXTURE_CACHE_MAGIC, 4) != 0 || out.version != TEXTURE_CACHE_VERSION ||
+                !isValidFormat(out.format) || out.sourceSize != source.size ||
+                out.levelCount == 0 || out.levelCount > MAX_TEXTURE_LEVELS)
+                return false;
+
+            size_t payloadSize = out.levelCount * sizeof(TextureLevel) + out.dataSize;
+            if (cache.size() != sizeof(TextureCacheHeader) + payloadSize)
+                return false;
+
+            if (out.sourceMtimeNs != source.mtimeNs && out.sourceHash != hashFile(imagePath))
+                return false;
+
+            if (hashBytes(cache.data() + sizeof(TextureCacheHeader), payloadSize) != out.payloadHash)
+                return false;
+
+            // Cada nível precisa ter exatamente os blocos do seu tamanho, dentro dos dados.
+            const TextureLevel *levels = reinterpret_cast<const TextureLevel *>(cache.data() + sizeof(TextureCacheHeader));
+            BlockFormat format = static_cast<BlockFormat>(out.format);
+            for (uint32_t i = 0; i < out.levelCount; ++i)
+            {
+                if (levels[i].size != compressedSize(format, levels[i].width, levels[i].height) ||
+                    levels[i].offset + levels[i].size > out.dataSize)
+                    return false;
+            }
+            return levels[0].width == out.width && levels[0].height == out.height;
+        }
+    }
+
+    size_t CompressedTexture::byteSize() const
+    {
+        size_t total = 0;
+        for (const TextureLevel &level : m_levels)
+            total += level.size;
+        return total;
+    }
+
+    std::string textureCachePath(const std::string &imagePath, TextureCompression compression)
+    {
+        return imagePath + (compression == TextureCompression::RG ? ".rg" : "") + ".texbin";
+    }
+
+    bool saveTextureCache(const std::string &cachePath, BlockFormat format, const std::vector<TextureLevel> &levels,
+                          const std::vector<uint8_t> &data, const FileStamp &source, uint64_t sourceHash)
+    {
+        size_t levelBytes = levels.size() * sizeof(TextureLevel);
+
+        TextureCacheHeader header{};
+        std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, 4);
+        header.version = TEXTURE_CACHE_VERSION;
+        header.format = static_cast<uint32_t>(format);
+        header.width = levels.empty() ? 0 : levels[0].width;
+        header.height = levels.empty() ? 0 : levels[0].height;
+        header.levelCount = static_cast<uint32_t>(levels.size());
+        header.sourceSize = source.size;
+        header.sourceMtimeNs = source.mtimeNs;
+        header.sourceHash = sourceHash;
+        header.dataSize = data.size();
+        // levelBytes é múltiplo de 8, então encadear os hashes equivale ao hash do bloco contínuo do arquivo.
+        header.payloadHash = hashBytes(data.data(), data.size(), hashBytes(levels.data(), levelBytes));
+
+        std::string tmpPath = cachePath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(levels.data()), levelBytes);
+            out.write(reinterpret_cast<const char *>(data.data()), data.size());
+            if (!out)
+                return false;
+        }
+        return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+    }
+
+    CompressedTexture loadTextureCached(const std::string &imagePath, TextureCompression compression)
+    {
+        CompressedTexture result;
+        FileStamp source = statFile(imagePath);
+        std::string cachePath = textureCachePath(imagePath, compression);
+
+        if (source.exists)
+        {
+            MappedFile cache(cachePath);
+            TextureCacheHeader header;
+            if (validateCache(cache, imagePath, source, header))
+            {
+                const TextureLevel *levels = reinterpret_cast<const TextureLevel *>(cache.data() + sizeof(TextureCacheHeader));
+                result.m_levels.assign(levels, levels + header.levelCount);
+                result.m_format = static_cast<BlockFormat>(header.format);
+                result.m_dataOffset = sizeof(TextureCacheHeader) + header.levelCount * sizeof(TextureLevel);
+                result.m_file = std::move(cache);
+                // Como no cache de malhas, uma falha ao guardar a nova data só custa recalcular o hash depois.
+                if (header.sourceMtimeNs != source.mtimeNs)
+                    overwriteFileBytes(cachePath, offsetof(TextureCacheHeader, sourceMtimeNs), &source.mtimeNs, sizeof(source.mtimeNs));
+                return result;
+            }
+        }
+
+        // Cache ausente ou desatualizado: decodifica, gera os mipmaps e comprime todos os níveis.
+        ImageData image = loadImage(imagePath);
+        RgbaImage level = toRgba(image);
+        if (level.pixels.empty())
+            return result;
+
+        result.m_format = compression == TextureCompression::RG ? BlockFormat::BC5 : chooseBlockFormat(image, level);
+        image.pixels.reset();
+        while (true)
+        {
+            std::vector<uint8_t> blocks = compressImage(level, result.m_format);
+            result.m_levels.push_back({level.width, level.height, result.m_data.size(), blocks.size()});
+            result.m_data.insert(result.m_data.end(), blocks.begin(), blocks.end());
+            if (level.width == 1 && level.height == 1)
+                break;
+            level = downsample(level);
+        }
+
+        saveTextureCache(cachePath, result.m_format, result.m_levels, result.m_data, source, hashFile(imagePath));
+        return result;
+    }
+}
@@ -0,0 +1,360 @@
+#include "worldgen/TextureCompressor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace worldgen
+{
+    namespace
+    {
+        // Bloco 4x4 em RGBA, na ordem em que os índices são gravados (linha a linha).
+        struct PixelBlock
+        {
+            uint8_t rgba[16][4];
+        };
+
+        PixelBlock fetchBlock(const RgbaImage &image, uint32_t x0, uint32_t y0)
+        {
+            PixelBlock block;
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t sy = std::min(y0 + y, image.height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t sx = std::min(x0 + x, image.width - 1);
+                    std::memcpy(block.rgba[y * 4 + x], &image.pixels[(static_cast<size_t>(sy) * image.width + sx) * 4], 4);
+                }
+            }
+            return block;
+        }
+
+        uint16_t packColor565(const float color[3])
+        {
+            auto quantize = [](float value, int maxValue)
+            {
+                return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 255.0f) * maxValue / 255.0f));
+            };
+            return static_cast<uint16_t>((quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31));
+        }
+
+        // Reproduz a expansão feita pela GPU: os bits mais altos se repetem nos mais baixos.
+        void unpackColor565(uint16_t packed, int color[3])
+        {
+            int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        // Escolhe para cada pixel a cor mais próxima da paleta de 4 cores; devolve o erro quadrático total.
+        int fitColorIndices(const PixelBlock &block, uint16_t c0, uint16_t c1, uint32_t &indices)
+        {
+            int palette[4][3];
+            unpackColor565(c0, palette[0]);
+            unpackColor565(c1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            int error = 0;
+            indices = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0, bestError = 1 << 30;
+                for (int p = 0; p < 4; ++p)
+                {
+                    int dr = block.rgba[i][0] - palette[p][0];
+                    int dg = block.rgba[i][1] - palette[p][1];
+                    int db = block.rgba[i][2] - palette[p][2];
+                    int e = dr * dr + dg * dg + db * db;
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint32_t>(best) << (2 * i);
+                error += bestError;
+            }
+            return error;
+        }
+
+        // Quantiza os extremos no modo de 4 cores (c0 > c1) e calcula os índices.
+        int encodeColorEndpoints(const PixelBlock &block, const float e0[3], const float e1[3], uint16_t &c0, uint16_t &c1, uint32_t &indices)
+        {
+            c0 = packColor565(e0);
+            c1 = packColor565(e1);
+            if (c0 < c1)
+                std::swap(c0, c1);
+            return fitColorIndices(block, c0, c1, indices);
+        }
+
+        void encodeColorBlock(const PixelBlock &block, uint8_t *out)
+        {
+            // Média e covariância das cores do bloco.
+            float mean[3] = {0.0f, 0.0f, 0.0f};
+            for (int i = 0; i < 16; ++i)
+                for (int c = 0; c < 3; ++c)
+                    mean[c] += block.rgba[i][c] / 16.0f;
+
+            float cov[3][3] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                float d[3] = {block.rgba[i][0] - mean[0], block.rgba[i][1] - mean[1], block.rgba[i][2] - mean[2]};
+                for (int a = 0; a < 3; ++a)
+                    for (int b = 0; b < 3; ++b)
+                        cov[a][b] += d[a] * d[b];
+            }
+
+            // Eixo principal por iteração de potência; num bloco de cor única ele não importa.
+            float axis[3] = {1.0f, 1.0f, 1.0f};
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                float next[3];
+                for (int a = 0; a < 3; ++a)
+                    next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2];
+                float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+                if (length < 1e-6f)
+                    break;
+                for (int a = 0; a < 3; ++a)
+                    axis[a] = next[a] / length;
+            }
+
+            // Extremos: as projeções mínima e máxima das cores sobre o eixo.
+            float minT = 0.0f, maxT = 0.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < 3; ++c)
+                    t += (block.rgba[i][c] - mean[c]) * axis[c];
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+            float e0[3], e1[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                e0[c] = mean[c] + axis[c] * maxT;
+                e1[c] = mean[c] + axis[c] * minT;
+            }
+
+            uint16_t c0, c1;
+            uint32_t indices;
+            int error = encodeColorEndpoints(block, e0, e1, c0, c1, indices);
+
+            // Refinamento: com os índices fixos, os extremos que minimizam o erro saem de um sistema 2x2.
+            if (c0 != c1)
+            {
+                static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+                for (int i = 0; i < 16; ++i)
+                {
+                    float a = weights[(indices >> (2 * i)) & 3], b = 1.0f - a;
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        ax[c] += a * block.rgba[i][c];
+                        bx[c] += b * block.rgba[i][c];
+                    }
+                }
+                float det = aa * bb - ab * ab;
+                if (std::fabs(det) > 1e-6f)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        e0[c] = (bb * ax[c] - ab * bx[c]) / det;
+                        e1[c] = (aa * bx[c] - ab * ax[c]) / det;
+                    }
+                    uint16_t r0, r1;
+                    uint32_t refined;
+                    if (encodeColorEndpoints(block, e0, e1, r0, r1, refined) < error)
+                    {
+                        c0 = r0;
+                        c1 = r1;
+                        indices = refined;
+                    }
+                }
+            }
+
+            // Extremos iguais: o bloco tem uma cor só, e o índice 0 a representa nos dois modos.
+            if (c0 == c1)
+                indices = 0;
+
+            out[0] = static_cast<uint8_t>(c0);
+            out[1] = static_cast<uint8_t>(c0 >> 8);
+            out[2] = static_cast<uint8_t>(c1);
+            out[3] = static_cast<uint8_t>(c1 >> 8);
+            for (int i = 0; i < 4; ++i)
+                out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+
+        // Bloco BC4 de um canal, no modo de 8 níveis: extremos max/min e 6 valores interpolados.
+        void encodeChannelBlock(const PixelBlock &block, int channel, uint8_t *out)
+        {
+            int minValue = 255, maxValue = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                minValue = std::min<int>(minValue, block.rgba[i][channel]);
+                maxValue = std::max<int>(maxValue, block.rgba[i][channel]);
+            }
+            out[0] = static_cast<uint8_t>(maxValue);
+            out[1] = static_cast<uint8_t>(minValue);
+
+            uint64_t indices = 0;
+            if (maxValue > minValue)
+            {
+                for (int i = 0; i < 16; ++i)
+                {
+                    // Posição do valor entre min (0) e max (7). O código 0 é o máximo, o 1 é o mínimo
+                    // e os códigos 2..7 vão do mais próximo do máximo ao mais próximo do mínimo.
+                    int step = ((block.rgba[i][channel] - minValue) * 14 + (maxValue - minValue)) / (2 * (maxValue - minValue));
+                    uint64_t code = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+                    indices |= code << (3 * i);
+                }
+            }
+            for (int i = 0; i < 6; ++i)
+                out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+    }
+
+    size_t blockBytes(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+        case BlockFormat::BC4:
+            return 8;
+        case BlockFormat::BC3:
+        case BlockFormat::BC5:
+            return 16;
+        }
+        return 0;
+    }
+
+    size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height)
+    {
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+    }
+
+    const char *blockFormatName(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            return "BC1";
+        case BlockFormat::BC3:
+            return "BC3";
+        case BlockFormat::BC4:
+            return "BC4";
+        case BlockFormat::BC5:
+            return "BC5";
+        }
+        return "?";
+    }
+
+    RgbaImage toRgba(const ImageData &image)
+    {
+        RgbaImage rgba;
+        if (!image || image.channels < 1 || image.channels > 4)
+            return rgba;
+
+        rgba.width = static_cast<uint32_t>(image.width);
+        rgba.height = static_cast<uint32_t>(image.height);
+        size_t pixelCount = static_cast<size_t>(rgba.width) * rgba.height;
+        rgba.pixels.resize(pixelCount * 4);
+
+        const unsigned char *src = image.pixels.get();
+        for (size_t i = 0; i < pixelCount; ++i, src += image.channels)
+        {
+            uint8_t *dst = &rgba.pixels[i * 4];
+            if (image.channels <= 2)
+            {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = image.channels == 2 ? src[1] : 255;
+            }
+            else
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = image.channels == 4 ? src[3] : 255;
+            }
+        }
+        return rgba;
+    }
+
+    BlockFormat chooseBlockFormat(const ImageData &image, const RgbaImage &rgba)
+    {
+        if (image.channels == 1)
+            return BlockFormat::BC4;
+        if (image.channels == 2 || image.channels == 4)
+        {
+            for (size_t i = 3; i < rgba.pixels.size(); i += 4)
+            {
+                if (rgba.pixels[i] != 255)
+                    return BlockFormat::BC3;
+            }
+        }
+        return BlockFormat::BC1;
+    }
+
+    RgbaImage downsample(const RgbaImage &image)
+    {
+        RgbaImage result;
+        result.width = std::max(1u, image.width / 2);
+        result.height = std::max(1u, image.height / 2);
+        result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+        for (uint32_t y = 0; y < result.height; ++y)
+        {
+            uint32_t y0 = std::min(2 * y, image.height - 1), y1 = std::min(2 * y + 1, image.height - 1);
+            for (uint32_t x = 0; x < result.width; ++x)
+            {
+                uint32_t x0 = std::min(2 * x, image.width - 1), x1 = std::min(2 * x + 1, image.width - 1);
+                const uint8_t *p00 = &image.pixels[(static_cast<size_t>(y0) * image.width + x0) * 4];
+                const uint8_t *p01 = &image.pixels[(static_cast<size_t>(y0) * image.width + x1) * 4];
+                const uint8_t *p10 = &image.pixels[(static_cast<size_t>(y1) * image.width + x0) * 4];
+                const uint8_t *p11 = &image.pixels[(static_cast<size_t>(y1) * image.width + x1) * 4];
+                uint8_t *dst = &result.pixels[(static_cast<size_t>(y) * result.width + x) * 4];
+                for (int c = 0; c < 4; ++c)
+                    dst[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint8_t> compressImage(const RgbaImage &image, BlockFormat format)
+    {
+        std::vector<uint8_t> blocks(compressedSize(format, image.width, image.height));
+        uint8_t *out = blocks.data();
+        for (uint32_t y = 0; y < image.height; y += 4)
+        {
+            for (uint32_t x = 0; x < image.width; x += 4, out += blockBytes(format))
+            {
+                PixelBlock block = fetchBlock(image, x, y);
+                switch (format)
+                {
+                case BlockFormat::BC1:
+                    encodeColorBlock(block, out);
+                    break;
+                case BlockFormat::BC3:
+                    encodeChannelBlock(block, 3, out);
+                    encodeColorBlock(block, out + 8);
+                    break;
+                case BlockFormat::BC4:
+                    encodeChannelBlock(block, 0, out);
+                    break;
+                case BlockFormat::BC5:
+                    encodeChannelBlock(block, 0, out);
+                    encodeChannelBlock(block, 1, out + 8);
+                    break;
+                }
+            }
+        }
+        return blocks;
+    }
+}
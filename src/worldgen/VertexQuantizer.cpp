@@ -0,0 +1,70 @@
+#include "worldgen/VertexQuantizer.hpp"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace worldgen
+{
+    namespace
+    {
+        const float UNORM16_MAX = 65535.0f;
+
+        uint16_t quantizeUnorm16(float value, float offset, float scale)
+        {
+            if (scale <= 0.0f)
+                return 0; // Eixo sem extensão: todos os vértices estão no plano do canto mínimo.
+            float normalized = glm::clamp((value - offset) / scale, 0.0f, 1.0f);
+            return static_cast<uint16_t>(std::lround(normalized * UNORM16_MAX));
+        }
+    }
+
+    QuantizedMesh quantizeVertices(const Vertex *vertices, size_t vertexCount)
+    {
+        QuantizedMesh result;
+        if (vertexCount == 0)
+            return result;
+
+        glm::vec3 minP(FLT_MAX), maxP(-FLT_MAX);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            minP = glm::min(minP, vertices[i].Position);
+            maxP = glm::max(maxP, vertices[i].Position);
+        }
+        result.positionOffset = minP;
+        result.positionScale = maxP - minP;
+
+        float maxNormalCos = 1.0f;
+        result.vertices.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            const Vertex &v = vertices[i];
+            PackedVertex &packed = result.vertices[i];
+
+            // Posição: unorm16 dentro da caixa da malha.
+            glm::vec3 decoded;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                packed.Position[axis] = quantizeUnorm16(v.Position[axis], minP[axis], result.positionScale[axis]);
+                decoded[axis] = packed.Position[axis] / UNORM16_MAX * result.positionScale[axis] + minP[axis];
+            }
+            packed.Position[3] = 0;
+            result.error.position = std::max(result.error.position, glm::length(decoded - v.Position));
+
+            // Normal: 10 bits com sinal por componente.
+            glm::vec3 normal = glm::length(v.Normal) > 0.0f ? glm::normalize(v.Normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+            packed.Normal = glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f));
+            glm::vec3 decodedNormal = glm::vec3(glm::unpackSnorm3x10_1x2(packed.Normal));
+            if (glm::length(decodedNormal) > 0.0f)
+                maxNormalCos = std::min(maxNormalCos, glm::dot(normal, glm::normalize(decodedNormal)));
+
+            // Coordenadas de textura: half float (exatas até ~1/2048 dentro de [0, 1]).
+            packed.TexCoords[0] = glm::packHalf1x16(v.TexCoords.x);
+            packed.TexCoords[1] = glm::packHalf1x16(v.TexCoords.y);
+            glm::vec2 decodedUv(glm::unpackHalf1x16(packed.TexCoords[0]), glm::unpackHalf1x16(packed.TexCoords[1]));
+            result.error.texCoord = std::max(result.error.texCoord, std::max(std::fabs(decodedUv.x - v.TexCoords.x), std::fabs(decodedUv.y - v.TexCoords.y)));
+        }
+        result.error.normalDegrees = glm::degrees(std::acos(glm::clamp(maxNormalCos, -1.0f, 1.0f)));
+        return result;
+    }
+}
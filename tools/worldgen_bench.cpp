@@ -0,0 +1,120 @@
+// Benchmark da libworldgen: mede a geração procedural sem janela nem contexto OpenGL.
+// Uso: ./worldgen_bench (executar a partir da raiz do projeto, para encontrar models/ e textures/).
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "worldgen/Heightfield.hpp"
+#include "worldgen/GrassTiles.hpp"
+#include "worldgen/Placement.hpp"
+#include "worldgen/MeshData.hpp"
+#include "worldgen/MeshCache.hpp"
+#include "worldgen/MeshOptimizer.hpp"
+#include "worldgen/MeshSimplifier.hpp"
+#include "worldgen/VertexQuantizer.hpp"
+#include "worldgen/ObjParser.hpp"
+#include "worldgen/ImageData.hpp"
+#include "worldgen/TextureCache.hpp"
+
+// Executa 'fn' e imprime o tempo gasto, em milissegundos.
+template <typename F>
+static void timed(const std::string &label, F &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << label << ": " << elapsed.count() << " ms" << std::endl;
+}
+
+int main()
+{
+    worldgen::Heightfield heightfield;
+    timed("heightfield 512x512", [&]
+          { heightfield = worldgen::generateHeightfield(512, 512); });
+
+    timed("terrain mesh", [&]
+          { worldgen::buildTerrainMesh(heightfield); });
+
+    timed("grass tiles around the center", [&]
+          {
+              worldgen::GrassStreamingParams params;
+              size_t instances = 0;
+              std::vector<worldgen::GrassTileKey> tiles = worldgen::desiredGrassTiles(heightfield, glm::vec3(0.0f), params);
+              for (const worldgen::GrassTileKey &key : tiles)
+                  instances += worldgen::placeGrassTile(heightfield, key, params, worldgen::Aabb(), 17).instances.size();
+              std::cout << "  ladrilhos: " << tiles.size() << ", instancias: " << instances << std::endl; });
+
+    timed("vegetation placement", [&]
+          {
+              std::vector<worldgen::VegetationParams> layers = {{500, -5.0f, 4.0f, 0.3f, glm::vec3(0.0f, 0.0f, 1.0f), 1},
+                                                                {500, -5.0f, 4.0f, 0.7f, glm::vec3(0.0f, 0.0f, 1.0f), 2}};
+              worldgen::PlacementIndex index(heightfield);
+              std::vector<worldgen::VegetationPlacement> placed = worldgen::placeVegetationLayers(heightfield, index, layers);
+              std::cout << "  instancias: " << placed[0].transforms.size() << " + " << placed[1].transforms.size()
+                        << " (maximo " << placed[0].capacity << " + " << placed[1].capacity << ")" << std::endl; });
+
+    timed("models/anemona.obj", [&]
+          {
+              worldgen::MeshData mesh = worldgen::loadObj("models/anemona.obj");
+              std::cout << "  vertices: " << mesh.vertices.size() << ", indices: " << mesh.indices.size() << std::endl; });
+
+    for (const char *path : {"models/anemona.obj", "models/Grass1.obj", "models/grass.obj"})
+    {
+        worldgen::MeshData mesh = worldgen::loadObj(path);
+        worldgen::MeshOptimizationReport report;
+        timed(std::string("optimizeMesh ") + path, [&]
+              { report = worldgen::optimizeMesh(mesh); });
+        std::cout << "  ACMR " << report.before.acmr << " -> " << report.after.acmr
+                  << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+
+        std::vector<worldgen::MeshLod> lods;
+        timed(std::string("buildLodChain ") + path, [&]
+              { lods = worldgen::buildLodChain(mesh); });
+        for (const worldgen::MeshLod &lod : lods)
+            std::cout << "  " << lod.indexCount / 3 << " triangulos, erro " << lod.error << std::endl;
+
+        worldgen::QuantizedMesh packed;
+        timed(std::string("quantizeVertices ") + path, [&]
+              { packed = worldgen::quantizeVertices(mesh.vertices.data(), mesh.vertices.size()); });
+        std::cout << "  erro: posicao " << packed.error.position << ", normal " << packed.error.normalDegrees
+                  << " graus, UV " << packed.error.texCoord << std::endl;
+    }
+
+    // Escalabilidade do leitor paralelo de .obj (use um arquivo grande para números significativos).
+    for (unsigned int threads : {1u, 2u, 4u, 8u})
+    {
+        timed("parseObjParallel " + std::to_string(threads) + " thread(s)", [&]
+              {
+                  worldgen::ObjGeometry geometry;
+                  worldgen::parseObjParallel("models/anemona.obj", geometry, threads); });
+    }
+
+    // A primeira chamada pode gravar o cache; a segunda mede o caminho mapeado.
+    for (int run = 0; run < 2; ++run)
+    {
+        timed("models/anemona.obj (cache)", [&]
+              {
+                  worldgen::CachedMesh mesh = worldgen::loadMeshCached("models/anemona.obj");
+                  std::cout << "  do cache: " << (mesh.fromCache() ? "sim" : "nao") << ", indices: " << mesh.view().indexCount << std::endl; });
+    }
+
+    timed("textures/grass8.png", [&]
+          { worldgen::loadImage("textures/grass8.png"); });
+
+    // Compressão em blocos: a primeira chamada pode decodificar, gerar os mipmaps e gravar o cache.
+    for (const char *path : {"textures/mar.png", "textures/rock1.png", "textures/Grass/Grass08.png"})
+    {
+        for (int run = 0; run < 2; ++run)
+        {
+            timed(std::string(path) + " (cache)", [&]
+                  {
+                      worldgen::CompressedTexture texture = worldgen::loadTextureCached(path, worldgen::TextureCompression::Auto);
+                      std::cout << "  do cache: " << (texture.fromCache() ? "sim" : "nao") << ", "
+                                << worldgen::blockFormatName(texture.format()) << ", " << texture.levelCount() << " niveis, "
+                                << texture.byteSize() / 1024 << " KB" << std::endl; });
+        }
+    }
+
+    return 0;
+}